@@ -19,6 +19,42 @@
 
 #include "bl2_private.h"
 
+#if BL2_IMAGE_PREFETCH
+#if !defined(PLAT_BL2_PREFETCH_BASE) || !defined(PLAT_BL2_PREFETCH_SIZE)
+#error "BL2_IMAGE_PREFETCH requires PLAT_BL2_PREFETCH_BASE and PLAT_BL2_PREFETCH_SIZE"
+#endif
+
+/*******************************************************************************
+ * Request the prefetch of the next image to load, which is then read while
+ * the image of 'node_info' is being authenticated. It is not prefetched if the
+ * platform setup must be done before it is loaded, as the staging buffer may
+ * not be usable yet. This includes the platform setup requested by the images
+ * that are skipped before it.
+ ******************************************************************************/
+static void bl2_prefetch_next_image(const bl_load_info_node_t *node_info,
+				    int plat_setup_done)
+{
+	const bl_load_info_node_t *next = node_info->next_load_info;
+
+	while (next != NULL) {
+		if ((plat_setup_done == 0) &&
+		    ((next->image_info->h.attr & IMAGE_ATTRIB_PLAT_SETUP) != 0U))
+			return;
+
+		if ((next->image_info->h.attr & IMAGE_ATTRIB_SKIP_LOADING) == 0U)
+			break;
+
+		next = next->next_load_info;
+	}
+
+	if (next == NULL)
+		return;
+
+	bl_register_image_prefetch(next->image_id, PLAT_BL2_PREFETCH_BASE,
+				   PLAT_BL2_PREFETCH_SIZE);
+}
+#endif /* BL2_IMAGE_PREFETCH */
+
 /*******************************************************************************
  * This function loads SCP_BL2/BL3x images and returns the ep_info for
  * the next executable image.
@@ -64,6 +100,9 @@ struct entry_point_info *bl2_load_images(void)
 		}
 
 		if (!(bl2_node_info->image_info->h.attr & IMAGE_ATTRIB_SKIP_LOADING)) {
+#if BL2_IMAGE_PREFETCH
+			bl2_prefetch_next_image(bl2_node_info, plat_setup_done);
+#endif
 			INFO("BL2: Loading image id %d\n", bl2_node_info->image_id);
 			err = load_auth_image(bl2_node_info->image_id,
 				bl2_node_info->image_info);
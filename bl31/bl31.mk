@@ -41,12 +41,20 @@ BL31_SOURCES		+=	bl31/bl31_main.c				\
 
 ifeq (${ENABLE_PMF}, 1)
 BL31_SOURCES		+=	lib/pmf/pmf_main.c
+ifeq (${PMF_RING_BUFFERS}, 1)
+BL31_SOURCES		+=	lib/pmf/pmf_ring.c
+endif
 endif
 
 ifeq (${EL3_EXCEPTION_HANDLING},1)
 BL31_SOURCES		+=	bl31/ehf.c
 endif
 
+ifeq (${CONSOLE_LOGBUF},1)
+BL31_SOURCES		+=	drivers/console/aarch64/logbuf_console.S	\
+				drivers/console/logbuf_console.c
+endif
+
 ifeq (${SDEI_SUPPORT},1)
 ifeq (${EL3_EXCEPTION_HANDLING},0)
   $(error EL3_EXCEPTION_HANDLING must be 1 for SDEI support)
@@ -84,6 +92,20 @@ BL31_SOURCES		+=	lib/cpus/aarch64/wa_cve_2017_5715_bpiall.S	\
 				lib/cpus/aarch64/wa_cve_2017_5715_mmu.S
 endif
 
+ifeq (${XLAT_TABLES_AOT},1)
+# The translation tables of the static regions defined in XLAT_AOT_MMAP_SOURCE
+# are generated from its object file and linked into BL31.
+XLAT_AOT_MMAP_OBJ	:=	${BUILD_PLAT}/bl31/$(notdir $(XLAT_AOT_MMAP_SOURCE:.c=.o))
+XLAT_AOT_TABLES		:=	${BUILD_PLAT}/bl31/xlat_aot_tables.c
+
+BL31_SOURCES		+=	${XLAT_AOT_TABLES}
+
+${XLAT_AOT_TABLES}: ${XLAT_AOT_MMAP_OBJ} | ${XLATGEN}
+	${ECHO} "  XLATGEN $@"
+	${Q}${XLATGEN} $(if ${XLAT_AOT_MMAP_SYMBOL},-s ${XLAT_AOT_MMAP_SYMBOL})	\
+		-v ${XLAT_AOT_VA_BITS} $< $@
+endif
+
 BL31_LINKERFILE		:=	bl31/bl31.ld.S
 
 # Flag used to indicate if Crash reporting via console should be included
@@ -24,6 +24,26 @@
 #if ENABLE_RUNTIME_INSTRUMENTATION
 PMF_REGISTER_SERVICE_SMC(rt_instr_svc, PMF_RT_INSTR_SVC_ID,
 	RT_INSTR_TOTAL_IDS, PMF_STORE_ENABLE)
+
+#if PMF_RING_BUFFERS
+/*******************************************************************************
+ * The time-stamps of the warm boot path are captured in assembly, without the
+ * PMF helpers. This function appends them to the ring buffer of the current
+ * CPU once the data cache is enabled. RT_INSTR_EXIT_HW_LOW_PWR was stored with
+ * the data cache disabled, so it is read with cache maintenance.
+ ******************************************************************************/
+void bl31_ring_store_warmboot_timestamps(unsigned long long exit_psci_ts)
+{
+	unsigned long long ts;
+
+	PMF_GET_TIMESTAMP_BY_INDEX(rt_instr_svc, RT_INSTR_EXIT_HW_LOW_PWR,
+				   plat_my_core_pos(), PMF_CACHE_MAINT, ts);
+	PMF_RING_STORE_TIMESTAMP(PMF_RT_INSTR_SVC_ID, RT_INSTR_EXIT_HW_LOW_PWR,
+				 ts, false);
+	PMF_RING_STORE_TIMESTAMP(PMF_RT_INSTR_SVC_ID, RT_INSTR_EXIT_PSCI,
+				 exit_psci_ts, false);
+}
+#endif
 #endif
 
 /*******************************************************************************
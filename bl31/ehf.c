@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -11,14 +11,20 @@
 #include <assert.h>
 #include <stdbool.h>
 
+#include <platform_def.h>
+
+#include <arch_helpers.h>
 #include <bl31/ehf.h>
+#include <bl31/ehf_lat_stats.h>
 #include <bl31/interrupt_mgmt.h>
 #include <context.h>
 #include <common/debug.h>
 #include <drivers/arm/gic_common.h>
+#include <lib/cassert.h>
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/el3_runtime/cpu_data.h>
 #include <lib/el3_runtime/pubsub_events.h>
+#include <lib/utils.h>
 #include <plat/common/platform.h>
 
 /* Output EHF logs as verbose */
@@ -73,6 +79,228 @@ static pe_exc_data_t *this_cpu_data(void)
 	return &get_cpu_data(ehf_data);
 }
 
+#if EHF_LATENCY_STATS
+/*
+ * The latency statistics are kept directly in the shared memory buffer
+ * provided by the platform, whose layout is described in ehf_lat_stats.h.
+ */
+#define EHF_LAT_MAX_PRIORITIES	(sizeof(ehf_pri_bits_t) * 8U)
+
+#define EHF_LAT_RECORD_SIZE						\
+	(sizeof(ehf_lat_stats_cpu_t) +					\
+	 (exception_data.num_priorities * sizeof(ehf_lat_stats_pri_t)))
+
+CASSERT((PLAT_EHF_LAT_STATS_BASE % sizeof(uint64_t)) == 0U,
+	assert_ehf_lat_stats_base_alignment);
+
+/*
+ * Interrupts acknowledged by a CPU whose priority is still running, and the
+ * time at which they were acknowledged.
+ */
+typedef struct ehf_lat_pe {
+	ehf_pri_bits_t open_bits;
+	uint64_t ack_ts[EHF_LAT_MAX_PRIORITIES];
+} ehf_lat_pe_t;
+
+static ehf_lat_pe_t ehf_lat_pe[PLATFORM_CORE_COUNT];
+
+static ehf_lat_stats_cpu_t *ehf_lat_stats_cpu(unsigned int cpu_idx)
+{
+	return (ehf_lat_stats_cpu_t *)(PLAT_EHF_LAT_STATS_BASE +
+		sizeof(ehf_lat_stats_hdr_t) + (cpu_idx * EHF_LAT_RECORD_SIZE));
+}
+
+/* Return the histogram bucket of a value, see EHF_LAT_STATS_BUCKETS */
+static unsigned int ehf_lat_bucket(uint64_t value)
+{
+	unsigned int bucket = 0U;
+
+	while ((value > 1U) && (bucket < (EHF_LAT_STATS_BUCKETS - 1U))) {
+		value >>= 1;
+		bucket++;
+	}
+
+	return bucket;
+}
+
+/* Let the readers know that the record of a CPU is being updated */
+static void ehf_lat_update_begin(ehf_lat_stats_cpu_t *cpu)
+{
+	cpu->seq++;
+	dmbishst();
+}
+
+static void ehf_lat_update_end(ehf_lat_stats_cpu_t *cpu)
+{
+	dmbishst();
+	cpu->seq++;
+}
+
+/*
+ * Record the completion of the interrupts of this CPU whose priority is no
+ * longer running. The interrupts of higher priority are always completed
+ * first, so the search stops at the first one that is still running.
+ */
+static void ehf_lat_complete(ehf_lat_pe_t *lat_pe, ehf_lat_stats_cpu_t *cpu,
+			     uint64_t now)
+{
+	unsigned int idx, run_pri;
+	ehf_lat_stats_pri_t *stats;
+	uint64_t latency;
+
+	run_pri = plat_ic_get_running_priority();
+
+	while (lat_pe->open_bits != 0U) {
+		idx = (unsigned int) __builtin_ctz(lat_pe->open_bits);
+		if (IDX_TO_PRI(idx) >= run_pri)
+			break;
+
+		lat_pe->open_bits &= ~PRI_BIT(idx);
+
+		stats = &cpu->pri[idx];
+		latency = now - lat_pe->ack_ts[idx];
+		if (latency < stats->min)
+			stats->min = latency;
+		if (latency > stats->max)
+			stats->max = latency;
+		stats->total += latency;
+		stats->complete_hist[ehf_lat_bucket(latency)]++;
+	}
+}
+
+/* Record the acknowledgement of an interrupt of priority index 'idx' */
+static void ehf_lat_ack(pe_exc_data_t *pe_data, unsigned int idx,
+			uint64_t ack_ts)
+{
+	unsigned int cpu_idx = plat_my_core_pos();
+	ehf_lat_pe_t *lat_pe = &ehf_lat_pe[cpu_idx];
+	ehf_lat_stats_cpu_t *cpu = ehf_lat_stats_cpu(cpu_idx);
+	ehf_lat_stats_pri_t *stats = &cpu->pri[idx];
+	unsigned int nesting;
+
+	lat_pe->open_bits |= PRI_BIT(idx);
+	lat_pe->ack_ts[idx] = ack_ts;
+	nesting = (unsigned int) __builtin_popcount(lat_pe->open_bits |
+						    pe_data->active_pri_bits);
+
+	ehf_lat_update_begin(cpu);
+
+	cpu->mpidr = read_mpidr_el1() & MPIDR_AFFINITY_MASK;
+	stats->count++;
+	if (nesting > stats->max_nesting)
+		stats->max_nesting = nesting;
+
+	ehf_lat_update_end(cpu);
+}
+
+/*
+ * Record the return of the handler of an interrupt of priority index 'idx'.
+ * The interrupt is only complete if the handler ended it; otherwise, e.g. if
+ * it was dispatched to a lower EL, it will be completed later.
+ */
+static void ehf_lat_handler_done(unsigned int idx)
+{
+	unsigned int cpu_idx = plat_my_core_pos();
+	ehf_lat_pe_t *lat_pe = &ehf_lat_pe[cpu_idx];
+	ehf_lat_stats_cpu_t *cpu = ehf_lat_stats_cpu(cpu_idx);
+	ehf_lat_stats_pri_t *stats = &cpu->pri[idx];
+	uint64_t now = read_cntpct_el0();
+
+	ehf_lat_update_begin(cpu);
+
+	stats->handler_hist[ehf_lat_bucket(now - lat_pe->ack_ts[idx])]++;
+	ehf_lat_complete(lat_pe, cpu, now);
+	if ((lat_pe->open_bits & PRI_BIT(idx)) != 0U)
+		stats->deferred++;
+
+	ehf_lat_update_end(cpu);
+}
+
+/*
+ * Record the completion of the interrupts that were still running when their
+ * handler returned. This is called by the EHF when a priority is deactivated,
+ * and must be called by the dispatchers that end such interrupts later, e.g.
+ * on the completion of an SDEI event.
+ */
+void ehf_lat_stats_complete(void)
+{
+	unsigned int cpu_idx = plat_my_core_pos();
+	ehf_lat_pe_t *lat_pe = &ehf_lat_pe[cpu_idx];
+	ehf_lat_stats_cpu_t *cpu = ehf_lat_stats_cpu(cpu_idx);
+
+	if (lat_pe->open_bits == 0U)
+		return;
+
+	ehf_lat_update_begin(cpu);
+	ehf_lat_complete(lat_pe, cpu, read_cntpct_el0());
+	ehf_lat_update_end(cpu);
+}
+
+/*
+ * Record the acknowledgement of an EL3 interrupt by a dispatcher outside of
+ * the EHF handler, e.g. when the SDEI dispatcher chains the dispatch of pending
+ * events. 'ack_ts' is the value of the system counter before the interrupt was
+ * acknowledged. Returns the priority index of the interrupt, to be passed to
+ * ehf_lat_stats_handler_done() once the dispatcher has handled it.
+ */
+unsigned int ehf_lat_stats_ack(uint64_t ack_ts)
+{
+	unsigned int pri = plat_ic_get_running_priority();
+	unsigned int idx;
+
+	assert(IS_PRI_SECURE(pri));
+
+	idx = pri_to_idx(pri);
+	ehf_lat_ack(this_cpu_data(), idx, ack_ts);
+
+	return idx;
+}
+
+void ehf_lat_stats_handler_done(unsigned int idx)
+{
+	ehf_lat_handler_done(idx);
+}
+
+/*
+ * Initialize the shared memory buffer holding the latency statistics. The
+ * size of the records depends on the number of priority levels of the
+ * platform, so the size of the buffer can only be checked at run time.
+ */
+static void __init ehf_lat_stats_init(void)
+{
+	ehf_lat_stats_hdr_t *hdr =
+		(ehf_lat_stats_hdr_t *)PLAT_EHF_LAT_STATS_BASE;
+	size_t size = sizeof(*hdr) +
+		      (PLATFORM_CORE_COUNT * EHF_LAT_RECORD_SIZE);
+	unsigned int cpu_idx, idx;
+
+	if (size > PLAT_EHF_LAT_STATS_SIZE) {
+		ERROR("EHF latency statistics need 0x%lx bytes\n",
+				(unsigned long) size);
+		panic();
+	}
+
+	zeromem(hdr, size);
+
+	for (cpu_idx = 0U; cpu_idx < PLATFORM_CORE_COUNT; cpu_idx++) {
+		for (idx = 0U; idx < exception_data.num_priorities; idx++)
+			ehf_lat_stats_cpu(cpu_idx)->pri[idx].min = UINT64_MAX;
+	}
+
+	hdr->version = EHF_LAT_STATS_VERSION;
+	hdr->num_buckets = EHF_LAT_STATS_BUCKETS;
+	hdr->num_priorities = (uint16_t) exception_data.num_priorities;
+	hdr->pri_bits = (uint16_t) exception_data.pri_bits;
+	hdr->num_cpus = PLATFORM_CORE_COUNT;
+	hdr->record_size = (uint32_t) EHF_LAT_RECORD_SIZE;
+	hdr->freq = read_cntfrq_el0();
+
+	/* Publish the buffer once it is complete */
+	dmbishst();
+	hdr->magic = EHF_LAT_STATS_MAGIC;
+}
+#endif /* EHF_LATENCY_STATS */
+
 /*
  * Return the current priority index of this CPU. If no priority is active,
  * return EHF_INVALID_IDX.
@@ -214,6 +442,10 @@ void ehf_deactivate_priority(unsigned int priority)
 		panic();
 	}
 
+#if EHF_LATENCY_STATS
+	ehf_lat_stats_complete();
+#endif
+
 	EHF_LOG("deactivate prio=%d\n", get_pe_highest_active_idx(pe_data));
 }
 
@@ -397,6 +629,9 @@ static uint64_t ehf_el3_interrupt_handler(uint32_t id, uint32_t flags,
 	uint32_t intr_raw;
 	unsigned int intr, pri, idx;
 	ehf_handler_t handler;
+#if EHF_LATENCY_STATS
+	uint64_t ack_ts = read_cntpct_el0();
+#endif
 
 	/*
 	 * Top-level interrupt type handler from Interrupt Management Framework
@@ -440,12 +675,20 @@ static uint64_t ehf_el3_interrupt_handler(uint32_t id, uint32_t flags,
 		panic();
 	}
 
+#if EHF_LATENCY_STATS
+	ehf_lat_ack(this_cpu_data(), idx, ack_ts);
+#endif
+
 	/*
 	 * Call registered handler. Pass the raw interrupt value to registered
 	 * handlers.
 	 */
 	ret = handler(intr_raw, flags, handle, cookie);
 
+#if EHF_LATENCY_STATS
+	ehf_lat_handler_done(idx);
+#endif
+
 	return (uint64_t) ret;
 }
 
@@ -475,6 +718,10 @@ void __init ehf_init(void)
 	assert((exception_data.pri_bits >= 1U) ||
 			(exception_data.pri_bits < 8U));
 
+#if EHF_LATENCY_STATS
+	ehf_lat_stats_init();
+#endif
+
 	/* Route EL3 interrupts when in Secure and Non-secure. */
 	set_interrupt_rm_flag(flags, NON_SECURE);
 	set_interrupt_rm_flag(flags, SECURE);
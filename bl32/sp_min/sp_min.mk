@@ -21,6 +21,9 @@ BL32_SOURCES		+=	bl32/sp_min/sp_min_main.c		\
 
 ifeq (${ENABLE_PMF}, 1)
 BL32_SOURCES		+=	lib/pmf/pmf_main.c
+ifeq (${PMF_RING_BUFFERS}, 1)
+BL32_SOURCES		+=	lib/pmf/pmf_ring.c
+endif
 endif
 
 ifeq (${ENABLE_AMU}, 1)
@@ -6,8 +6,11 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <string.h>
 
+#include <platform_def.h>
+
 #include <arch.h>
 #include <arch_features.h>
 #include <arch_helpers.h>
@@ -47,6 +50,16 @@ static int dyn_is_auth_disabled(void)
 }
 #endif /* TRUSTED_BOARD_BOOT */
 
+#if TRUSTED_BOARD_BOOT && AUTH_STREAM_HASH
+/*
+ * Size of the chunks in which an image is read when its hash is calculated
+ * while it is being loaded.
+ */
+#ifndef PLAT_AUTH_STREAM_CHUNK_SIZE
+#define PLAT_AUTH_STREAM_CHUNK_SIZE	(64U * 1024U)
+#endif
+#endif /* TRUSTED_BOARD_BOOT && AUTH_STREAM_HASH */
+
 uintptr_t page_align(uintptr_t value, unsigned dir)
 {
 	/* Round up the limit to the next page boundary */
@@ -59,6 +72,239 @@ uintptr_t page_align(uintptr_t value, unsigned dir)
 	return value;
 }
 
+/* Consumer of the data of the next image loaded by load_auth_image(), if any */
+static const image_load_stream_t *load_stream;
+
+/*******************************************************************************
+ * Register a consumer of the data of the next image loaded by
+ * load_auth_image(). It does not apply to the parent images (certificates)
+ * loaded to authenticate it.
+ ******************************************************************************/
+void bl_register_image_load_stream(const image_load_stream_t *stream)
+{
+	assert((stream == NULL) || ((stream->chunk_size != 0U) &&
+	       (stream->start != NULL) && (stream->consume != NULL) &&
+	       (stream->abort != NULL)));
+
+	load_stream = stream;
+}
+
+#if BL2_IMAGE_PREFETCH
+/*
+ * Prefetch of the next image. Once the data of the image loaded by
+ * load_auth_image() has been read, the next image is read into a staging
+ * buffer while the current one is authenticated. It is copied to its load
+ * address when it is loaded, after its parent images.
+ */
+static struct {
+	unsigned int image_id;
+	uintptr_t buf;
+	size_t buf_size;
+	/* The prefetch has been requested, or started */
+	bool requested;
+	bool started;
+	/* The staging buffer holds the whole image */
+	bool valid;
+	size_t size;
+	uintptr_t dev_handle;
+	uintptr_t image_handle;
+	io_async_req_t req;
+} prefetch;
+
+/*******************************************************************************
+ * Request the prefetch of an image into the buffer at 'buf', once the data of
+ * the next image loaded by load_auth_image() has been read. Images larger than
+ * the buffer are not prefetched.
+ ******************************************************************************/
+void bl_register_image_prefetch(unsigned int image_id, uintptr_t buf,
+				size_t size)
+{
+	assert((buf != 0U) && (size != 0U));
+
+	prefetch.image_id = image_id;
+	prefetch.buf = buf;
+	prefetch.buf_size = size;
+	prefetch.requested = true;
+	prefetch.valid = false;
+}
+
+/* Start reading the requested image, without waiting for the data */
+static void image_prefetch_start(void)
+{
+	uintptr_t image_spec;
+	int io_result;
+
+	if (!prefetch.requested) {
+		return;
+	}
+	prefetch.requested = false;
+
+	io_result = plat_get_image_source(prefetch.image_id,
+					  &prefetch.dev_handle, &image_spec);
+	if (io_result != 0) {
+		return;
+	}
+
+	io_result = io_open(prefetch.dev_handle, image_spec,
+			    &prefetch.image_handle);
+	if (io_result != 0) {
+		(void)io_dev_close(prefetch.dev_handle);
+		return;
+	}
+
+	io_result = io_size(prefetch.image_handle, &prefetch.size);
+	if ((io_result == 0) && (prefetch.size != 0U) &&
+	    (prefetch.size <= prefetch.buf_size)) {
+		io_result = io_read_submit(prefetch.image_handle, prefetch.buf,
+					   prefetch.size, &prefetch.req);
+		if (io_result == 0) {
+			prefetch.started = true;
+			return;
+		}
+	}
+
+	(void)io_close(prefetch.image_handle);
+	(void)io_dev_close(prefetch.dev_handle);
+}
+
+/* Wait for the prefetch to complete and release the IO handles */
+static void image_prefetch_finish(void)
+{
+	size_t bytes_read;
+	int io_result;
+
+	if (!prefetch.started) {
+		return;
+	}
+	prefetch.started = false;
+
+	io_result = io_read_wait(&prefetch.req, &bytes_read);
+	prefetch.valid = (io_result == 0) && (bytes_read == prefetch.size);
+
+	(void)io_close(prefetch.image_handle);
+	(void)io_dev_close(prefetch.dev_handle);
+
+	VERBOSE("Image id=%u prefetched (%i)\n", prefetch.image_id, io_result);
+}
+
+/*
+ * Load an image from the staging buffer if it has been prefetched. Returns
+ * -ENOENT if it hasn't, so that it is read from its source instead.
+ */
+static int image_prefetch_copy(unsigned int image_id, image_info_t *image_data,
+			       int *hash_stream)
+{
+	if (!prefetch.valid || (prefetch.image_id != image_id)) {
+		return -ENOENT;
+	}
+	/* The staging buffer is only used once */
+	prefetch.valid = false;
+
+	if (prefetch.size > image_data->image_max_size) {
+		WARN("Image id=%u size out of bounds\n", image_id);
+		return -EFBIG;
+	}
+
+	(void)memcpy((void *)image_data->image_base, (void *)prefetch.buf,
+		     prefetch.size);
+	image_data->image_size = (uint32_t)prefetch.size;
+
+#if TRUSTED_BOARD_BOOT && AUTH_STREAM_HASH
+	if ((*hash_stream != 0) &&
+	    (auth_mod_hash_stream_update(image_id,
+					 (void *)image_data->image_base,
+					 image_data->image_size) != 0)) {
+		WARN("Failed to hash image while loading\n");
+		*hash_stream = 0;
+	}
+#endif
+
+	INFO("Image id=%u loaded from prefetch buffer: 0x%lx - 0x%lx\n",
+	     image_id, image_data->image_base,
+	     (uintptr_t)(image_data->image_base + image_data->image_size));
+
+	return 0;
+}
+#endif /* BL2_IMAGE_PREFETCH */
+
+/*******************************************************************************
+ * Internal function to read the content of an image.
+ *
+ * If '*hash_stream' is not zero, the image is read in chunks that are passed to
+ * the authentication module as soon as they have been loaded. If that fails,
+ * '*hash_stream' is cleared and the rest of the image is still read.
+ *
+ * If 'stream' is not NULL, the image is read in chunks into the buffer of the
+ * stream instead of at 'image_base', and each chunk is passed to the consumer.
+ ******************************************************************************/
+static int read_image(unsigned int image_id, uintptr_t image_handle,
+		      uintptr_t image_base, size_t image_size,
+		      size_t *bytes_read, int *hash_stream,
+		      const image_load_stream_t *stream)
+{
+	uintptr_t chunk_base;
+	size_t chunk_max = image_size;
+	size_t chunk_size;
+	size_t chunk_read;
+	int io_result;
+
+	if ((*hash_stream == 0) && (stream == NULL)) {
+		return io_read(image_handle, image_base, image_size,
+			       bytes_read);
+	}
+
+#if TRUSTED_BOARD_BOOT && AUTH_STREAM_HASH
+	chunk_max = PLAT_AUTH_STREAM_CHUNK_SIZE;
+#endif
+	if (stream != NULL) {
+		chunk_max = stream->chunk_size;
+
+		io_result = stream->start();
+		if (io_result != 0) {
+			return io_result;
+		}
+	}
+
+	*bytes_read = 0U;
+	while (*bytes_read < image_size) {
+		chunk_size = image_size - *bytes_read;
+		if (chunk_size > chunk_max) {
+			chunk_size = chunk_max;
+		}
+		chunk_base = (stream != NULL) ? stream->chunk_base :
+			     (image_base + *bytes_read);
+
+		io_result = io_read(image_handle, chunk_base, chunk_size,
+				    &chunk_read);
+		if (io_result != 0) {
+			return io_result;
+		}
+		if (chunk_read == 0U) {
+			return -EIO;
+		}
+
+#if TRUSTED_BOARD_BOOT && AUTH_STREAM_HASH
+		if ((*hash_stream != 0) &&
+		    (auth_mod_hash_stream_update(image_id, (void *)chunk_base,
+						 (unsigned int)chunk_read) != 0)) {
+			WARN("Failed to hash image while loading\n");
+			*hash_stream = 0;
+		}
+#endif
+
+		if (stream != NULL) {
+			io_result = stream->consume(chunk_base, chunk_read);
+			if (io_result != 0) {
+				return io_result;
+			}
+		}
+
+		*bytes_read += chunk_read;
+	}
+
+	return 0;
+}
+
 /*******************************************************************************
  * Internal function to load an image at a specific address given
  * an image ID and extents of free memory.
@@ -67,7 +313,8 @@ uintptr_t page_align(uintptr_t value, unsigned dir)
  *
  * Returns 0 on success, a negative error code otherwise.
  ******************************************************************************/
-static int load_image(unsigned int image_id, image_info_t *image_data)
+static int load_image(unsigned int image_id, image_info_t *image_data,
+		      int *hash_stream, const image_load_stream_t *stream)
 {
 	uintptr_t dev_handle;
 	uintptr_t image_handle;
@@ -82,6 +329,17 @@ static int load_image(unsigned int image_id, image_info_t *image_data)
 
 	image_base = image_data->image_base;
 
+#if BL2_IMAGE_PREFETCH
+	/* The chunks of a streamed image are read into the stream buffer */
+	if (stream == NULL) {
+		io_result = image_prefetch_copy(image_id, image_data,
+						hash_stream);
+		if (io_result != -ENOENT) {
+			return io_result;
+		}
+	}
+#endif
+
 	/* Obtain a reference to the image by querying the platform layer */
 	io_result = plat_get_image_source(image_id, &dev_handle, &image_spec);
 	if (io_result != 0) {
@@ -123,7 +381,8 @@ static int load_image(unsigned int image_id, image_info_t *image_data)
 
 	/* We have enough space so load the image now */
 	/* TODO: Consider whether to try to recover/retry a partially successful read */
-	io_result = io_read(image_handle, image_base, image_size, &bytes_read);
+	io_result = read_image(image_id, image_handle, image_base, image_size,
+			       &bytes_read, hash_stream, stream);
 	if ((io_result != 0) || (bytes_read < image_size)) {
 		WARN("Failed to load image id=%u (%i)\n", image_id, io_result);
 		goto exit;
@@ -148,6 +407,11 @@ static int load_auth_image_internal(unsigned int image_id,
 				    int is_parent_image)
 {
 	int rc;
+	int hash_stream = 0;
+	const image_load_stream_t *stream;
+
+	/* The load stream only applies to the requested image */
+	stream = (is_parent_image == 0) ? load_stream : NULL;
 
 #if TRUSTED_BOARD_BOOT
 	if (dyn_is_auth_disabled() == 0) {
@@ -164,24 +428,65 @@ static int load_auth_image_internal(unsigned int image_id,
 	}
 #endif /* TRUSTED_BOARD_BOOT */
 
+#if TRUSTED_BOARD_BOOT && AUTH_STREAM_HASH
+	/* Hash the image while it is being loaded when possible */
+	if ((dyn_is_auth_disabled() == 0) &&
+	    (auth_mod_hash_stream_start(image_id) == 0)) {
+		hash_stream = 1;
+	}
+#endif
+
+#if TRUSTED_BOARD_BOOT
+	/*
+	 * The chunks of a streamed image are not kept in memory, so it can only
+	 * be authenticated if its hash is calculated while it is being loaded.
+	 * Do not pass any data of an image that cannot be authenticated to the
+	 * consumer of the stream.
+	 */
+	if ((stream != NULL) && (dyn_is_auth_disabled() == 0) &&
+	    (hash_stream == 0)) {
+		WARN("Image id=%u cannot be hashed while it is loaded\n",
+		     image_id);
+		return -EAUTH;
+	}
+#endif
+
 	/* Load the image */
-	rc = load_image(image_id, image_data);
+	rc = load_image(image_id, image_data, &hash_stream, stream);
 	if (rc != 0) {
+		if (stream != NULL) {
+			stream->abort();
+		}
 		return rc;
 	}
 
+#if BL2_IMAGE_PREFETCH
+	/* Read the next image while this one is being authenticated */
+	if (is_parent_image == 0) {
+		image_prefetch_start();
+	}
+#endif
+
 #if TRUSTED_BOARD_BOOT
 	if (dyn_is_auth_disabled() == 0) {
-		/* Authenticate it */
-		rc = auth_mod_verify_img(image_id,
-					 (void *)image_data->image_base,
-					 image_data->image_size);
+		/* The hash of a streamed image may fail during the load */
+		if ((stream != NULL) && (hash_stream == 0)) {
+			rc = -EAUTH;
+		} else {
+			/* Authenticate it */
+			rc = auth_mod_verify_img(image_id,
+						 (void *)image_data->image_base,
+						 image_data->image_size);
+		}
 		if (rc != 0) {
 			/* Authentication error, zero memory and flush it right away. */
 			zero_normalmem((void *)image_data->image_base,
 			       image_data->image_size);
 			flush_dcache_range(image_data->image_base,
 					   image_data->image_size);
+			if (stream != NULL) {
+				stream->abort();
+			}
 			return -EAUTH;
 		}
 	}
@@ -215,8 +520,18 @@ int load_auth_image(unsigned int image_id, image_info_t *image_data)
 
 	do {
 		err = load_auth_image_internal(image_id, image_data, 0);
+#if BL2_IMAGE_PREFETCH
+		/* The next loads may use the device of the prefetch */
+		image_prefetch_finish();
+#endif
 	} while ((err != 0) && (plat_try_next_boot_source() != 0));
 
+	/* A load stream is only used for a single image */
+	load_stream = NULL;
+#if BL2_IMAGE_PREFETCH
+	prefetch.requested = false;
+#endif
+
 	return err;
 }
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -11,22 +11,117 @@
 #include <common/bl_common.h>
 #include <common/debug.h>
 #include <common/image_decompress.h>
+#include <lib/utils.h>
 
 static uintptr_t decompressor_buf_base;
 static uint32_t decompressor_buf_size;
 static decompressor_t *decompressor;
 static struct image_info saved_image_info;
 
+/* Streaming mode: the image is decompressed while it is being loaded */
+static const stream_decompressor_t *stream_decompressor;
+static uint32_t stream_chunk_size;
+static uintptr_t stream_out_end;
+
+static int image_decompress_stream_start(void);
+static int image_decompress_stream_consume(uintptr_t chunk, size_t len);
+static void image_decompress_stream_abort(void);
+
+static image_load_stream_t image_load_stream = {
+	.start = image_decompress_stream_start,
+	.consume = image_decompress_stream_consume,
+	.abort = image_decompress_stream_abort,
+};
+
 void image_decompress_init(uintptr_t buf_base, uint32_t buf_size,
 			   decompressor_t *_decompressor)
 {
 	decompressor_buf_base = buf_base;
 	decompressor_buf_size = buf_size;
 	decompressor = _decompressor;
+	stream_decompressor = NULL;
+}
+
+/*
+ * Streaming variant of image_decompress_init(). The compressed image is read
+ * in chunks of 'chunk_size' bytes into the start of the temporary buffer, and
+ * each chunk is decompressed to the final destination before the next one is
+ * read. The rest of the temporary buffer is used as workspace, so the buffer
+ * does not need to hold the whole compressed image.
+ */
+#if !TRUSTED_BOARD_BOOT || AUTH_STREAM_HASH
+void image_decompress_stream_init(uintptr_t buf_base, uint32_t buf_size,
+				  uint32_t chunk_size,
+				  const stream_decompressor_t *_decompressor)
+{
+	assert((chunk_size != 0U) && (chunk_size < buf_size));
+	assert((_decompressor->init != NULL) &&
+	       (_decompressor->update != NULL) &&
+	       (_decompressor->finish != NULL));
+
+	decompressor_buf_base = buf_base;
+	decompressor_buf_size = buf_size;
+	decompressor = NULL;
+	stream_decompressor = _decompressor;
+	stream_chunk_size = chunk_size;
+}
+#endif
+
+static int image_decompress_stream_start(void)
+{
+	/* Nothing has been decompressed yet */
+	stream_out_end = saved_image_info.image_base;
+
+	return stream_decompressor->init(saved_image_info.image_base,
+					 saved_image_info.image_max_size,
+					 decompressor_buf_base + stream_chunk_size,
+					 decompressor_buf_size - stream_chunk_size);
+}
+
+static int image_decompress_stream_consume(uintptr_t chunk, size_t len)
+{
+	int ret;
+
+	ret = stream_decompressor->update(chunk, len);
+	if (ret != 0) {
+		ERROR("Failed to decompress image (err=%d)\n", ret);
+	}
+
+	return ret;
+}
+
+static void image_decompress_stream_abort(void)
+{
+	uintptr_t out_end = stream_out_end;
+
+	/* Discard whatever has been decompressed from the rejected image */
+	(void)stream_decompressor->finish(&out_end);
+	if (out_end > saved_image_info.image_base) {
+		zeromem((void *)saved_image_info.image_base,
+			out_end - saved_image_info.image_base);
+		flush_dcache_range(saved_image_info.image_base,
+				   out_end - saved_image_info.image_base);
+	}
 }
 
 void image_decompress_prepare(struct image_info *info)
 {
+	if (stream_decompressor != NULL) {
+		/*
+		 * The image is loaded in chunks into the temporary buffer and
+		 * decompressed on the fly, so only image_info is saved here.
+		 * The image does not go through the load stream if it is not
+		 * going to be loaded.
+		 */
+		saved_image_info = *info;
+		if ((info->h.attr & IMAGE_ATTRIB_SKIP_LOADING) == 0U) {
+			image_load_stream.chunk_base = decompressor_buf_base;
+			image_load_stream.chunk_size = stream_chunk_size;
+			bl_register_image_load_stream(&image_load_stream);
+		}
+		return;
+	}
+
 	/*
 	 * If the image is compressed, it should be loaded into the temporary
 	 * buffer instead of its final destination.  We save image_info, then
@@ -44,6 +139,23 @@ int image_decompress(struct image_info *info)
 	uint32_t compressed_image_size, work_size;
 	int ret;
 
+	if (stream_decompressor != NULL) {
+		/* The whole image has already gone through the decompressor */
+		*info = saved_image_info;
+
+		ret = stream_decompressor->finish(&image_base);
+		if (ret) {
+			ERROR("Failed to decompress image (err=%d)\n", ret);
+			return ret;
+		}
+
+		info->image_size = image_base - info->image_base;
+
+		flush_dcache_range(info->image_base, info->image_size);
+
+		return 0;
+	}
+
 	/*
 	 * The size of compressed data has been filled by load_image().
 	 * Read it out before restoring image_info.
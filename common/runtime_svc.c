@@ -8,8 +8,13 @@
 #include <errno.h>
 #include <string.h>
 
+#include <platform_def.h>
+
+#include <arch_helpers.h>
 #include <common/debug.h>
 #include <common/runtime_svc.h>
+#include <lib/utils.h>
+#include <plat/common/platform.h>
 
 /*******************************************************************************
  * The 'rt_svc_descs' array holds the runtime service descriptors exported by
@@ -25,6 +30,114 @@ uint8_t rt_svc_descs_indices[MAX_RT_SVCS];
 #define RT_SVC_DECS_NUM		((RT_SVC_DESCS_END - RT_SVC_DESCS_START)\
 					/ sizeof(rt_svc_desc_t))
 
+#if RT_SVC_DISPATCH_STATS
+static rt_svc_dispatch_stat_t rt_svc_dispatch_stat[PLATFORM_CORE_COUNT];
+
+/*******************************************************************************
+ * Function called by the SMC entry path once the handler of an SMC has
+ * returned. 'entry_ts' is the time at which the SMC was taken and 'call_ts' the
+ * time at which its handler was called. SMCs that do not return to the entry
+ * path, e.g. when the CPU is powered down, are not recorded.
+ ******************************************************************************/
+void rt_svc_dispatch_stat_update(uint64_t entry_ts, uint64_t call_ts)
+{
+	rt_svc_dispatch_stat_t *stat = &rt_svc_dispatch_stat[plat_my_core_pos()];
+	uint64_t dispatch = call_ts - entry_ts;
+	uint64_t handler = read_cntpct_el0() - call_ts;
+
+	stat->count++;
+	stat->dispatch_ticks += dispatch;
+	stat->handler_ticks += handler;
+	if (dispatch > stat->max_dispatch_ticks)
+		stat->max_dispatch_ticks = dispatch;
+	if (handler > stat->max_handler_ticks)
+		stat->max_handler_ticks = handler;
+}
+
+/*******************************************************************************
+ * Function to return the SMC dispatch statistics accumulated over all CPUs.
+ * The statistics of a CPU which is updating them concurrently may be slightly
+ * out of date.
+ ******************************************************************************/
+void rt_svc_get_dispatch_stat(rt_svc_dispatch_stat_t *stat)
+{
+	const rt_svc_dispatch_stat_t *cpu_stat;
+	unsigned int cpu_idx;
+
+	assert(stat != NULL);
+
+	zeromem(stat, sizeof(*stat));
+
+	for (cpu_idx = 0U; cpu_idx < PLATFORM_CORE_COUNT; cpu_idx++) {
+		cpu_stat = &rt_svc_dispatch_stat[cpu_idx];
+		stat->count += cpu_stat->count;
+		stat->dispatch_ticks += cpu_stat->dispatch_ticks;
+		stat->handler_ticks += cpu_stat->handler_ticks;
+		if (cpu_stat->max_dispatch_ticks > stat->max_dispatch_ticks)
+			stat->max_dispatch_ticks = cpu_stat->max_dispatch_ticks;
+		if (cpu_stat->max_handler_ticks > stat->max_handler_ticks)
+			stat->max_handler_ticks = cpu_stat->max_handler_ticks;
+	}
+}
+#endif /* RT_SVC_DISPATCH_STATS */
+
+#if RT_SVC_FID_HANDLERS
+/*******************************************************************************
+ * The 'rt_svc_fid_table' array holds the handlers registered by services for
+ * individual SMC function IDs, which are called directly instead of the handler
+ * of the service. It is an open-addressed hash table with linear probing. It
+ * is never more than half full, so a lookup always ends on an empty entry.
+ ******************************************************************************/
+rt_svc_fid_desc_t rt_svc_fid_table[RT_SVC_FID_TABLE_SIZE];
+static unsigned int rt_svc_fid_count;
+
+/*******************************************************************************
+ * Function to register a handler for an individual SMC function ID. It is meant
+ * to be called by the initialisation routine of a runtime service for its
+ * frequently used functions. The handler must behave exactly like the handler
+ * of the service would for that function ID.
+ ******************************************************************************/
+int rt_svc_register_fid_handler(uint32_t smc_fid, rt_svc_handle_t handle)
+{
+	unsigned int idx;
+
+	if (handle == NULL)
+		return -EINVAL;
+
+	if (rt_svc_fid_count >= RT_SVC_FID_MAX_HANDLERS)
+		return -ENOMEM;
+
+	idx = get_rt_svc_fid_hash(smc_fid);
+	while (rt_svc_fid_table[idx].handle != NULL) {
+		if (rt_svc_fid_table[idx].smc_fid == smc_fid)
+			return -EEXIST;
+		idx = (idx + 1U) & (RT_SVC_FID_TABLE_SIZE - 1U);
+	}
+
+	rt_svc_fid_table[idx].smc_fid = smc_fid;
+	rt_svc_fid_table[idx].handle = handle;
+	rt_svc_fid_count++;
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Function to look up the handler registered for an SMC function ID, if any.
+ ******************************************************************************/
+static rt_svc_handle_t find_rt_svc_fid_handler(uint32_t smc_fid)
+{
+	unsigned int idx = get_rt_svc_fid_hash(smc_fid);
+
+	while (rt_svc_fid_table[idx].handle != NULL) {
+		if (rt_svc_fid_table[idx].smc_fid == smc_fid)
+			return rt_svc_fid_table[idx].handle;
+		idx = (idx + 1U) & (RT_SVC_FID_TABLE_SIZE - 1U);
+	}
+
+	return NULL;
+}
+#endif /* RT_SVC_FID_HANDLERS */
+
 /*******************************************************************************
  * Function to invoke the registered `handle` corresponding to the smc_fid in
  * AArch32 mode.
@@ -38,8 +151,21 @@ uintptr_t handle_runtime_svc(uint32_t smc_fid,
 	unsigned int index;
 	unsigned int idx;
 	const rt_svc_desc_t *rt_svc_descs;
+#if RT_SVC_FID_HANDLERS
+	rt_svc_handle_t fid_handle;
+#endif
 
 	assert(handle != NULL);
+
+#if RT_SVC_FID_HANDLERS
+	fid_handle = find_rt_svc_fid_handler(smc_fid);
+	if (fid_handle != NULL) {
+		get_smc_params_from_ctx(handle, x1, x2, x3, x4);
+		return fid_handle(smc_fid, x1, x2, x3, x4, cookie, handle,
+				  flags);
+	}
+#endif
+
 	idx = get_unique_oen_from_smc_fid(smc_fid);
 	assert(idx < MAX_RT_SVCS);
 
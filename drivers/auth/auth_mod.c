@@ -5,6 +5,7 @@
  */
 
 #include <assert.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -12,6 +13,7 @@
 
 #include <common/debug.h>
 #include <common/tbbr/cot_def.h>
+#include <lib/utils_def.h>
 #include <drivers/auth/auth_common.h>
 #include <drivers/auth/auth_mod.h>
 #include <drivers/auth/crypto_mod.h>
@@ -29,11 +31,83 @@
 	} while (0)
 
 #pragma weak plat_set_nv_ctr2
+#if AUTH_VERIFIED_CACHE
+#pragma weak plat_get_auth_cache
+#pragma weak plat_get_auth_cache_key
+#endif
 
 /* Pointer to CoT */
 extern const auth_img_desc_t **const cot_desc_ptr;
 extern unsigned int auth_img_flags[MAX_NUMBER_IDS];
 
+#if AUTH_STREAM_HASH
+/*
+ * State of the image whose hash is calculated while it is being loaded. The
+ * length of the data hashed so far is recorded to check that it matches the
+ * image that is eventually authenticated. The chunks of the image may have been
+ * loaded at the same address, e.g. when they are decompressed as they are
+ * loaded, so the image may no longer be in memory at that point.
+ */
+static struct {
+	int active;
+	unsigned int img_id;
+	size_t len;
+	void *hash_der_ptr;
+	unsigned int hash_der_len;
+} hash_stream;
+
+/*
+ * Give up the hash calculated while loading an image. Finishing it releases
+ * the context of the crypto library, so the result is ignored.
+ */
+static void hash_stream_abort(void)
+{
+	hash_stream.active = 0;
+	(void)crypto_mod_hash_final(hash_stream.hash_der_ptr,
+				    hash_stream.hash_der_len);
+}
+#endif
+
+#if AUTH_VERIFIED_CACHE
+/*
+ * Cache of the certificates that have been verified, in memory provided by the
+ * platform that persists across warm resets. A certificate is identified by
+ * its hash, the hash of the key that its signature was checked with (the ROTPK
+ * or the key from its parent) and the value of its platform NV counter. When
+ * they all match an entry, the signature of the certificate is not checked
+ * again.
+ *
+ * The memory may be writable by later images or by DMA masters, so the MAC at
+ * the start of the cache covers the rest of it with a key that only BL1 and
+ * BL2 can read. Contents that were not written with that key, including
+ * memory in an unknown state after power-on or a reset in the middle of an
+ * update, are discarded.
+ */
+#define AUTH_CACHE_MAGIC	U(0x48434156)	/* "VACH" */
+
+typedef struct auth_cache_entry {
+	uint32_t img_id;
+	uint32_t img_len;
+	uint32_t nv_ctr;
+	uint32_t reserved;
+	uint8_t img_hash[CRYPTO_CALC_HASH_SIZE];
+	uint8_t pk_hash[CRYPTO_CALC_HASH_SIZE];
+} auth_cache_entry_t;
+
+typedef struct auth_cache {
+	/* MAC of the rest of the cache, up to the last entry in use */
+	uint8_t mac[CRYPTO_CALC_HASH_SIZE];
+	uint32_t magic;
+	uint32_t num_entries;
+	auth_cache_entry_t entries[];
+} auth_cache_t;
+
+static auth_cache_t *auth_cache;
+static unsigned int auth_cache_max_entries;
+static void *auth_cache_key;
+static unsigned int auth_cache_key_len;
+#endif
+
 static int cmp_auth_param_type_desc(const auth_param_type_desc_t *a,
 		const auth_param_type_desc_t *b)
 {
@@ -112,6 +186,20 @@ static int auth_hash(const auth_method_param_hash_t *param,
 			img, img_len, &data_ptr, &data_len);
 	return_if_error(rc);
 
+#if AUTH_STREAM_HASH
+	/* The hash has been calculated while the image was being loaded */
+	if ((hash_stream.active != 0) &&
+	    (hash_stream.img_id == img_desc->img_id)) {
+		if (hash_stream.len != data_len) {
+			hash_stream_abort();
+			return 1;
+		}
+
+		hash_stream.active = 0;
+		return crypto_mod_hash_final(hash_der_ptr, hash_der_len);
+	}
+#endif
+
 	/* Ask the crypto module to verify this hash */
 	rc = crypto_mod_verify_hash(data_ptr, data_len,
 				    hash_der_ptr, hash_der_len);
@@ -119,6 +207,27 @@ static int auth_hash(const auth_method_param_hash_t *param,
 	return rc;
 }
 
+/*
+ * Get the public key that the signature of an image is checked with. If the
+ * image has no parent (NULL), the certificate has been signed with the ROTPK,
+ * so we have to get the PK from the platform. The flags indicate whether it is
+ * a hash of the key.
+ */
+static int auth_get_sig_pk(const auth_method_param_sig_t *param,
+			   const auth_img_desc_t *img_desc,
+			   void **pk_ptr, unsigned int *pk_len,
+			   unsigned int *flags)
+{
+	*flags = 0U;
+
+	if (img_desc->parent) {
+		return auth_get_param(param->pk, img_desc->parent,
+				      pk_ptr, pk_len);
+	}
+
+	return plat_get_rotpk_info(param->pk->cookie, pk_ptr, pk_len, flags);
+}
+
 /*
  * Authenticate by digital signature
  *
@@ -152,7 +261,7 @@ static int auth_signature(const auth_method_param_sig_t *param,
 {
 	void *data_ptr, *pk_ptr, *pk_hash_ptr, *sig_ptr, *sig_alg_ptr;
 	unsigned int data_len, pk_len, pk_hash_len, sig_len, sig_alg_len;
-	unsigned int flags = 0;
+	unsigned int flags;
 	int rc = 0;
 
 	/* Get the data to be signed from current image */
@@ -170,16 +279,8 @@ static int auth_signature(const auth_method_param_sig_t *param,
 			img, img_len, &sig_alg_ptr, &sig_alg_len);
 	return_if_error(rc);
 
-	/* Get the public key from the parent. If there is no parent (NULL),
-	 * the certificate has been signed with the ROTPK, so we have to get
-	 * the PK from the platform */
-	if (img_desc->parent) {
-		rc = auth_get_param(param->pk, img_desc->parent,
-				&pk_ptr, &pk_len);
-	} else {
-		rc = plat_get_rotpk_info(param->pk->cookie, &pk_ptr, &pk_len,
-				&flags);
-	}
+	/* Get the public key from the parent or the platform */
+	rc = auth_get_sig_pk(param, img_desc, &pk_ptr, &pk_len, &flags);
 	return_if_error(rc);
 
 	if (flags & (ROTPK_IS_HASH | ROTPK_NOT_DEPLOYED)) {
@@ -294,6 +395,20 @@ int plat_set_nv_ctr2(void *cookie, const auth_img_desc_t *img_desc __unused,
 	return plat_set_nv_ctr(cookie, nv_ctr);
 }
 
+#if AUTH_VERIFIED_CACHE
+/* By default, the platform provides no memory for the verified image cache */
+int plat_get_auth_cache(void **cache_ptr __unused, size_t *cache_size __unused)
+{
+	return -1;
+}
+
+int plat_get_auth_cache_key(void **key_ptr __unused,
+			    unsigned int *key_len __unused)
+{
+	return -1;
+}
+#endif
+
 /*
  * Return the parent id in the output parameter '*parent_id'
  *
@@ -325,6 +440,224 @@ int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id)
 	return 0;
 }
 
+#if AUTH_VERIFIED_CACHE
+/*
+ * Return the only authentication method of type 'type' of an image, or NULL if
+ * the image has none or several of them.
+ */
+static const auth_method_desc_t *auth_find_method(
+		const auth_img_desc_t *img_desc, auth_method_type_t type)
+{
+	const auth_method_desc_t *auth_method = NULL;
+	int i;
+
+	for (i = 0 ; i < AUTH_METHOD_NUM ; i++) {
+		if (img_desc->img_auth_methods[i].type == type) {
+			if (auth_method != NULL) {
+				return NULL;
+			}
+			auth_method = &img_desc->img_auth_methods[i];
+		}
+	}
+
+	return auth_method;
+}
+
+static int auth_cache_calc_mac(unsigned char *mac)
+{
+	unsigned int len = (offsetof(auth_cache_t, entries) -
+			    offsetof(auth_cache_t, magic)) +
+			   (auth_cache->num_entries *
+			    sizeof(auth_cache_entry_t));
+
+	return crypto_mod_calc_mac(auth_cache_key, auth_cache_key_len,
+				   &auth_cache->magic, len, mac);
+}
+
+/*
+ * Compare two MACs in a time that doesn't depend on the position of the first
+ * difference, so that the expected MAC can't be guessed byte after byte.
+ */
+static int auth_cache_mac_cmp(const unsigned char *mac1,
+			      const unsigned char *mac2, size_t len)
+{
+	const volatile unsigned char *p1 = mac1;
+	const volatile unsigned char *p2 = mac2;
+	unsigned char diff = 0U;
+	size_t i;
+
+	for (i = 0U; i < len; i++) {
+		diff |= p1[i] ^ p2[i];
+	}
+
+	return (diff == 0U) ? 0 : 1;
+}
+
+/*
+ * Check the cache provided by the platform, and start with an empty one if it
+ * is not valid. The cache is not used if the platform provides no memory or no
+ * key for it, or if the crypto library can't calculate hashes and MACs.
+ */
+static void auth_cache_init(void)
+{
+	unsigned char mac[CRYPTO_CALC_HASH_SIZE];
+	void *cache_ptr;
+	size_t cache_size;
+
+	if ((plat_get_auth_cache(&cache_ptr, &cache_size) != 0) ||
+	    (cache_size < (sizeof(auth_cache_t) +
+			   sizeof(auth_cache_entry_t)))) {
+		WARN("No memory for the verified image cache\n");
+		return;
+	}
+
+	if ((plat_get_auth_cache_key(&auth_cache_key,
+				     &auth_cache_key_len) != 0) ||
+	    (auth_cache_key_len == 0U)) {
+		WARN("No key for the verified image cache\n");
+		return;
+	}
+
+	assert(((uintptr_t)cache_ptr & (sizeof(uint32_t) - 1U)) == 0U);
+
+	auth_cache = cache_ptr;
+	auth_cache_max_entries = (cache_size - sizeof(auth_cache_t)) /
+				 sizeof(auth_cache_entry_t);
+
+	if ((auth_cache->magic == AUTH_CACHE_MAGIC) &&
+	    (auth_cache->num_entries <= auth_cache_max_entries) &&
+	    (auth_cache_calc_mac(mac) == 0) &&
+	    (auth_cache_mac_cmp(mac, auth_cache->mac, sizeof(mac)) == 0)) {
+		VERBOSE("Verified image cache: %u entries\n",
+			auth_cache->num_entries);
+		return;
+	}
+
+	auth_cache->magic = AUTH_CACHE_MAGIC;
+	auth_cache->num_entries = 0U;
+	if (auth_cache_calc_mac(auth_cache->mac) != 0) {
+		WARN("Verified image cache not supported by crypto library\n");
+		auth_cache = NULL;
+	}
+}
+
+/*
+ * Identify a certificate for the cache. Only images with a single signature
+ * method, checked against a deployed ROTPK or the key from their parent, can
+ * be cached.
+ *
+ * Return: 0 = success, Otherwise = the image can't be cached
+ */
+static int auth_cache_get_key(const auth_img_desc_t *img_desc,
+			      void *img, unsigned int img_len,
+			      auth_cache_entry_t *key)
+{
+	const auth_method_desc_t *sig, *nv_ctr;
+	void *pk_ptr;
+	unsigned int pk_len, flags;
+	int rc;
+
+	sig = auth_find_method(img_desc, AUTH_METHOD_SIG);
+	if (sig == NULL) {
+		return 1;
+	}
+
+	rc = auth_get_sig_pk(&sig->param.sig, img_desc, &pk_ptr, &pk_len,
+			     &flags);
+	return_if_error(rc);
+	if ((flags & ROTPK_NOT_DEPLOYED) != 0U) {
+		return 1;
+	}
+
+	memset(key, 0, sizeof(*key));
+	key->img_id = img_desc->img_id;
+	key->img_len = img_len;
+
+	nv_ctr = auth_find_method(img_desc, AUTH_METHOD_NV_CTR);
+	if (nv_ctr != NULL) {
+		rc = plat_get_nv_ctr(nv_ctr->param.nv_ctr.plat_nv_ctr->cookie,
+				     &key->nv_ctr);
+		return_if_error(rc);
+	}
+
+	rc = crypto_mod_calc_hash(pk_ptr, pk_len, key->pk_hash);
+	return_if_error(rc);
+
+	return crypto_mod_calc_hash(img, img_len, key->img_hash);
+}
+
+/*
+ * Look for a certificate in the cache. 'key' is filled in to add the
+ * certificate to the cache once it has been verified.
+ *
+ * Return: 0 = the certificate is in the cache, 1 = it is not, Otherwise = it
+ * can't be cached
+ */
+static int auth_cache_lookup(const auth_img_desc_t *img_desc,
+			     void *img, unsigned int img_len,
+			     auth_cache_entry_t *key)
+{
+	unsigned int i;
+
+	if (auth_cache == NULL) {
+		return -1;
+	}
+
+	if (auth_cache_get_key(img_desc, img, img_len, key) != 0) {
+		return -1;
+	}
+
+	for (i = 0U; i < auth_cache->num_entries; i++) {
+		if (auth_cache->entries[i].img_id == key->img_id) {
+			if (memcmp(&auth_cache->entries[i], key,
+				   sizeof(*key)) == 0) {
+				return 0;
+			}
+			break;
+		}
+	}
+
+	return 1;
+}
+
+/*
+ * Add a certificate that has been verified to the cache, or replace the entry
+ * of a previous version. The NV counter is read again as the verification may
+ * have updated it.
+ */
+static void auth_cache_store(const auth_img_desc_t *img_desc,
+			     auth_cache_entry_t *key)
+{
+	const auth_method_desc_t *nv_ctr;
+	unsigned int i;
+
+	nv_ctr = auth_find_method(img_desc, AUTH_METHOD_NV_CTR);
+	if ((nv_ctr != NULL) &&
+	    (plat_get_nv_ctr(nv_ctr->param.nv_ctr.plat_nv_ctr->cookie,
+			     &key->nv_ctr) != 0)) {
+		return;
+	}
+
+	for (i = 0U; i < auth_cache->num_entries; i++) {
+		if (auth_cache->entries[i].img_id == key->img_id) {
+			break;
+		}
+	}
+
+	if (i == auth_cache->num_entries) {
+		if (i == auth_cache_max_entries) {
+			VERBOSE("Verified image cache is full\n");
+			return;
+		}
+		auth_cache->num_entries++;
+	}
+
+	memcpy(&auth_cache->entries[i], key, sizeof(*key));
+
+	(void)auth_cache_calc_mac(auth_cache->mac);
+}
+#endif /* AUTH_VERIFIED_CACHE */
+
 /*
  * Initialize the different modules in the authentication framework
  */
@@ -338,7 +671,104 @@ void auth_mod_init(void)
 
 	/* Image parser module */
 	img_parser_init();
+
+#if AUTH_VERIFIED_CACHE
+	auth_cache_init();
+#endif
+}
+
+#if AUTH_STREAM_HASH
+/*
+ * Prepare the authentication of an image while it is being loaded
+ *
+ * This is only possible for raw images authenticated by hash, whose parent
+ * has already been authenticated. The data of the image must then be passed to
+ * auth_mod_hash_stream_update() in order, as soon as it has been loaded, and
+ * auth_mod_verify_img() will only have to check the resulting hash.
+ *
+ * Return: 0 = the image can be hashed while it is loaded, Otherwise = the
+ * image must be authenticated after it has been loaded
+ */
+int auth_mod_hash_stream_start(unsigned int img_id)
+{
+	const auth_img_desc_t *img_desc = NULL;
+	const auth_method_desc_t *auth_method;
+	const auth_method_param_hash_t *hash_param = NULL;
+	void *hash_der_ptr;
+	unsigned int hash_der_len;
+	int rc, i;
+
+	/* Release a calculation that was left unfinished by a failed load */
+	if (hash_stream.active != 0) {
+		hash_stream_abort();
+	}
+
+	img_desc = cot_desc_ptr[img_id];
+	if ((img_desc->img_type != IMG_RAW) ||
+	    (img_desc->img_auth_methods == NULL)) {
+		return 1;
+	}
+
+	for (i = 0 ; i < AUTH_METHOD_NUM ; i++) {
+		auth_method = &img_desc->img_auth_methods[i];
+		if (auth_method->type == AUTH_METHOD_HASH) {
+			if (hash_param != NULL) {
+				return 1;
+			}
+			hash_param = &auth_method->param.hash;
+		} else if (auth_method->type != AUTH_METHOD_NONE) {
+			return 1;
+		}
+	}
+	if (hash_param == NULL) {
+		return 1;
+	}
+
+	/* Get the hash from the parent image */
+	rc = auth_get_param(hash_param->hash, img_desc->parent,
+			&hash_der_ptr, &hash_der_len);
+	return_if_error(rc);
+
+	rc = crypto_mod_hash_init(hash_der_ptr, hash_der_len);
+	return_if_error(rc);
+
+	hash_stream.active = 1;
+	hash_stream.img_id = img_id;
+	hash_stream.len = 0U;
+	hash_stream.hash_der_ptr = hash_der_ptr;
+	hash_stream.hash_der_len = hash_der_len;
+
+	return 0;
+}
+
+/*
+ * Add the next chunk of the image being loaded to the hash started by
+ * auth_mod_hash_stream_start() for the same image.
+ *
+ * Return: 0 = success, Otherwise = error
+ */
+int auth_mod_hash_stream_update(unsigned int img_id, void *data_ptr,
+				unsigned int data_len)
+{
+	int rc;
+
+	assert(hash_stream.active != 0);
+
+	if (hash_stream.img_id != img_id) {
+		hash_stream_abort();
+		return 1;
+	}
+
+	rc = crypto_mod_hash_update(data_ptr, data_len);
+	if (rc != 0) {
+		hash_stream_abort();
+		return rc;
+	}
+	hash_stream.len += data_len;
+
+	return 0;
 }
+#endif /* AUTH_STREAM_HASH */
 
 /*
  * Authenticate a certificate/image
@@ -354,6 +784,10 @@ int auth_mod_verify_img(unsigned int img_id,
 	void *param_ptr;
 	unsigned int param_len;
 	int rc, i;
+#if AUTH_VERIFIED_CACHE
+	auth_cache_entry_t cache_key;
+	int cache_rc;
+#endif
 
 	/* Get the image descriptor from the chain of trust */
 	img_desc = cot_desc_ptr[img_id];
@@ -366,6 +800,11 @@ int auth_mod_verify_img(unsigned int img_id,
 	 * descriptor. */
 	if (img_desc->img_auth_methods == NULL)
 		return 1;
+
+#if AUTH_VERIFIED_CACHE
+	/* The signature of a certificate in the cache is not checked again */
+	cache_rc = auth_cache_lookup(img_desc, img_ptr, img_len, &cache_key);
+#endif
 	for (i = 0 ; i < AUTH_METHOD_NUM ; i++) {
 		auth_method = &img_desc->img_auth_methods[i];
 		switch (auth_method->type) {
@@ -377,6 +816,12 @@ int auth_mod_verify_img(unsigned int img_id,
 					img_desc, img_ptr, img_len);
 			break;
 		case AUTH_METHOD_SIG:
+#if AUTH_VERIFIED_CACHE
+			if (cache_rc == 0) {
+				rc = 0;
+				break;
+			}
+#endif
 			rc = auth_signature(&auth_method->param.sig,
 					img_desc, img_ptr, img_len);
 			break;
@@ -417,6 +862,12 @@ int auth_mod_verify_img(unsigned int img_id,
 		}
 	}
 
+#if AUTH_VERIFIED_CACHE
+	if (cache_rc == 1) {
+		auth_cache_store(img_desc, &cache_key);
+	}
+#endif
+
 	/* Mark image as authenticated */
 	auth_img_flags[img_desc->img_id] |= IMG_FLAG_AUTHENTICATED;
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -103,3 +103,112 @@ int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 	return crypto_lib_desc.verify_hash(data_ptr, data_len,
 					   digest_info_ptr, digest_info_len);
 }
+
+/*
+ * Start the calculation of a hash over data provided in several chunks
+ *
+ * Parameters:
+ *
+ *   digest_info_ptr, digest_info_len: hash to be compared, which also selects
+ *                                     the hash algorithm
+ *
+ * Returns CRYPTO_ERR_INIT if the crypto library does not support it.
+ */
+int crypto_mod_hash_init(void *digest_info_ptr, unsigned int digest_info_len)
+{
+	assert(digest_info_ptr != NULL);
+	assert(digest_info_len != 0);
+
+	if ((crypto_lib_desc.hash_init == NULL) ||
+	    (crypto_lib_desc.hash_update == NULL) ||
+	    (crypto_lib_desc.hash_final == NULL)) {
+		return CRYPTO_ERR_INIT;
+	}
+
+	return crypto_lib_desc.hash_init(digest_info_ptr, digest_info_len);
+}
+
+/*
+ * Add a chunk of data to the hash started by crypto_mod_hash_init()
+ *
+ * Parameters:
+ *
+ *   data_ptr, data_len: data to be hashed
+ */
+int crypto_mod_hash_update(void *data_ptr, unsigned int data_len)
+{
+	assert(data_ptr != NULL);
+	assert(data_len != 0);
+	assert(crypto_lib_desc.hash_update != NULL);
+
+	return crypto_lib_desc.hash_update(data_ptr, data_len);
+}
+
+/*
+ * Finish the hash started by crypto_mod_hash_init() and verify it by
+ * comparison
+ *
+ * Parameters:
+ *
+ *   digest_info_ptr, digest_info_len: hash to be compared
+ */
+int crypto_mod_hash_final(void *digest_info_ptr, unsigned int digest_info_len)
+{
+	assert(digest_info_ptr != NULL);
+	assert(digest_info_len != 0);
+	assert(crypto_lib_desc.hash_final != NULL);
+
+	return crypto_lib_desc.hash_final(digest_info_ptr, digest_info_len);
+}
+
+/*
+ * Calculate the SHA-256 hash of some data
+ *
+ * Parameters:
+ *
+ *   data_ptr, data_len: data to be hashed
+ *   output: buffer of CRYPTO_CALC_HASH_SIZE bytes that receives the hash
+ *
+ * Returns CRYPTO_ERR_INIT if the crypto library does not support it.
+ */
+int crypto_mod_calc_hash(void *data_ptr, unsigned int data_len,
+			 unsigned char *output)
+{
+	assert(data_ptr != NULL);
+	assert(data_len != 0);
+	assert(output != NULL);
+
+	if (crypto_lib_desc.calc_hash == NULL) {
+		return CRYPTO_ERR_INIT;
+	}
+
+	return crypto_lib_desc.calc_hash(data_ptr, data_len, output);
+}
+
+/*
+ * Calculate the HMAC-SHA-256 of some data
+ *
+ * Parameters:
+ *
+ *   key, key_len: secret key
+ *   data_ptr, data_len: data to be authenticated
+ *   output: buffer of CRYPTO_CALC_HASH_SIZE bytes that receives the code
+ *
+ * Returns CRYPTO_ERR_INIT if the crypto library does not support it.
+ */
+int crypto_mod_calc_mac(const void *key, unsigned int key_len, void *data_ptr,
+			unsigned int data_len, unsigned char *output)
+{
+	assert(key != NULL);
+	assert(key_len != 0);
+	assert(data_ptr != NULL);
+	assert(data_len != 0);
+	assert(output != NULL);
+
+	if (crypto_lib_desc.calc_mac == NULL) {
+		return CRYPTO_ERR_INIT;
+	}
+
+	return crypto_lib_desc.calc_mac(key, key_len, data_ptr, data_len,
+					output);
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -136,19 +136,18 @@ end2:
 }
 
 /*
- * Match a hash
+ * Extract the hash algorithm and the hash value from a digest info
  *
  * Digest info is passed in DER format following the ASN.1 structure detailed
  * above.
  */
-static int verify_hash(void *data_ptr, unsigned int data_len,
-		       void *digest_info_ptr, unsigned int digest_info_len)
+static int get_digest_info(void *digest_info_ptr, unsigned int digest_info_len,
+			   const mbedtls_md_info_t **md_info,
+			   unsigned char **hash)
 {
 	mbedtls_asn1_buf hash_oid, params;
 	mbedtls_md_type_t md_alg;
-	const mbedtls_md_info_t *md_info;
-	unsigned char *p, *end, *hash;
-	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	unsigned char *p, *end;
 	size_t len;
 	int rc;
 
@@ -172,8 +171,8 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 		return CRYPTO_ERR_HASH;
 	}
 
-	md_info = mbedtls_md_info_from_type(md_alg);
-	if (md_info == NULL) {
+	*md_info = mbedtls_md_info_from_type(md_alg);
+	if (*md_info == NULL) {
 		return CRYPTO_ERR_HASH;
 	}
 
@@ -184,10 +183,32 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	}
 
 	/* Length of hash must match the algorithm's size */
-	if (len != mbedtls_md_get_size(md_info)) {
+	if (len != mbedtls_md_get_size(*md_info)) {
 		return CRYPTO_ERR_HASH;
 	}
-	hash = p;
+	*hash = p;
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Match a hash
+ *
+ * Digest info is passed in DER format following the ASN.1 structure detailed
+ * above.
+ */
+static int verify_hash(void *data_ptr, unsigned int data_len,
+		       void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *p, *hash;
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
 
 	/* Calculate the hash of the data */
 	p = (unsigned char *)data_ptr;
@@ -205,7 +226,161 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	return CRYPTO_SUCCESS;
 }
 
+#if AUTH_STREAM_HASH
+/*
+ * Context of the hash calculated by hash_init(), hash_update() and
+ * hash_final(). Only one such calculation can be in progress at a time.
+ */
+static mbedtls_md_context_t hash_stream_ctx;
+
+/*
+ * Start the calculation of a hash with the algorithm of a digest info
+ */
+static int hash_init(void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *hash;
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
+
+	/* Release any calculation that was not finished */
+	mbedtls_md_free(&hash_stream_ctx);
+	mbedtls_md_init(&hash_stream_ctx);
+
+	rc = mbedtls_md_setup(&hash_stream_ctx, md_info, 0);
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	rc = mbedtls_md_starts(&hash_stream_ctx);
+	if (rc != 0) {
+		mbedtls_md_free(&hash_stream_ctx);
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Add data to the hash started by hash_init()
+ */
+static int hash_update(void *data_ptr, unsigned int data_len)
+{
+	int rc;
+
+	rc = mbedtls_md_update(&hash_stream_ctx, (unsigned char *)data_ptr,
+			       data_len);
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Finish the hash started by hash_init() and match it with a digest info
+ */
+static int hash_final(void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *hash;
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != CRYPTO_SUCCESS) {
+		goto end;
+	}
+
+	/* The algorithm must be the one the calculation was started with */
+	if (md_info != hash_stream_ctx.md_info) {
+		rc = CRYPTO_ERR_HASH;
+		goto end;
+	}
+
+	rc = mbedtls_md_finish(&hash_stream_ctx, data_hash);
+	if (rc != 0) {
+		rc = CRYPTO_ERR_HASH;
+		goto end;
+	}
+
+	/* Compare values */
+	rc = memcmp(data_hash, hash, mbedtls_md_get_size(md_info));
+	if (rc != 0) {
+		rc = CRYPTO_ERR_HASH;
+		goto end;
+	}
+
+	rc = CRYPTO_SUCCESS;
+
+end:
+	mbedtls_md_free(&hash_stream_ctx);
+	return rc;
+}
+#endif /* AUTH_STREAM_HASH */
+
+#if AUTH_VERIFIED_CACHE
+/*
+ * Calculate the SHA-256 hash of some data
+ */
+static int calc_hash(void *data_ptr, unsigned int data_len,
+		     unsigned char *output)
+{
+	const mbedtls_md_info_t *md_info;
+
+	md_info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+	if (md_info == NULL) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	if (mbedtls_md(md_info, data_ptr, data_len, output) != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Calculate the HMAC-SHA-256 of some data
+ */
+static int calc_mac(const void *key, unsigned int key_len, void *data_ptr,
+		    unsigned int data_len, unsigned char *output)
+{
+	const mbedtls_md_info_t *md_info;
+
+	md_info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+	if (md_info == NULL) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	if (mbedtls_md_hmac(md_info, key, key_len, data_ptr, data_len,
+			    output) != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+#endif /* AUTH_VERIFIED_CACHE */
+
 /*
  * Register crypto library descriptor
  */
+#if AUTH_VERIFIED_CACHE && AUTH_STREAM_HASH
+REGISTER_CRYPTO_LIB_WITH_CALC_HASH(LIB_NAME, init, verify_signature,
+				   verify_hash, hash_init, hash_update,
+				   hash_final, calc_hash, calc_mac);
+#elif AUTH_VERIFIED_CACHE
+REGISTER_CRYPTO_LIB_WITH_CALC_HASH(LIB_NAME, init, verify_signature,
+				   verify_hash, NULL, NULL, NULL, calc_hash,
+				   calc_mac);
+#elif AUTH_STREAM_HASH
+REGISTER_CRYPTO_LIB_WITH_HASH_STREAM(LIB_NAME, init, verify_signature,
+				     verify_hash, hash_init, hash_update,
+				     hash_final);
+#else
 REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash);
+#endif
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <platform_def.h>
+
+#include <arch_helpers.h>
+#include <drivers/logbuf_console.h>
+#include <lib/spinlock.h>
+#include <lib/utils.h>
+#include <lib/utils_def.h>
+#include <plat/common/platform.h>
+
+/* Number of characters copied out of a ring at a time when it is drained */
+#define LOGBUF_DRAIN_CHUNK	U(64)
+
+/* Smallest size of the 'data' array of the rings */
+#define LOGBUF_MIN_DATA_SIZE	U(64)
+
+/* The C functions called from logbuf_console.S */
+int console_logbuf_setup(uintptr_t base, size_t size, console_t *out,
+			 console_logbuf_t *console);
+int console_logbuf_putc(int c, console_t *console);
+int console_logbuf_flush(console_t *console);
+
+static console_t *logbuf_out;
+static uintptr_t logbuf_rings;
+static size_t logbuf_ring_size;
+static uint64_t logbuf_data_size;
+
+/*
+ * Number of characters that each CPU has written to its ring and number of
+ * characters of each ring that have been drained. They are kept in Secure
+ * memory, the memory buffer may be writable by the Normal world.
+ */
+static volatile uint64_t logbuf_head[PLATFORM_CORE_COUNT];
+static uint64_t logbuf_tail[PLATFORM_CORE_COUNT];
+
+/* Serialises the draining of the rings */
+static spinlock_t logbuf_drain_lock;
+
+/* CPU that holds logbuf_drain_lock, or LOGBUF_NO_OWNER */
+#define LOGBUF_NO_OWNER		U(0xFFFFFFFF)
+static volatile unsigned int logbuf_drain_owner = LOGBUF_NO_OWNER;
+
+static logbuf_ring_t *logbuf_get_ring(unsigned int cpu_idx)
+{
+	return (logbuf_ring_t *)(logbuf_rings + (cpu_idx * logbuf_ring_size));
+}
+
+int console_logbuf_setup(uintptr_t base, size_t size, console_t *out,
+			 console_logbuf_t *console)
+{
+	logbuf_hdr_t *hdr = (logbuf_hdr_t *)base;
+	size_t ring_offset = round_up(sizeof(logbuf_hdr_t),
+				      CACHE_WRITEBACK_GRANULE);
+	size_t max_ring_size;
+	uint64_t data_size = LOGBUF_MIN_DATA_SIZE;
+
+	assert(out != NULL);
+	assert(console != NULL);
+
+	/* Only one instance of the log buffer console is supported */
+	if ((base == 0U) || (logbuf_rings != 0U))
+		return 0;
+
+	if (size <= ring_offset)
+		return 0;
+
+	/* Use the largest power of two that fits in the share of each CPU */
+	max_ring_size = (size - ring_offset) / PLATFORM_CORE_COUNT;
+	if ((sizeof(logbuf_ring_t) + data_size) > max_ring_size)
+		return 0;
+
+	while ((sizeof(logbuf_ring_t) + (data_size * 2U)) <= max_ring_size)
+		data_size *= 2U;
+
+	logbuf_rings = base + ring_offset;
+	logbuf_ring_size = round_up(sizeof(logbuf_ring_t) + data_size,
+				    CACHE_WRITEBACK_GRANULE);
+	if (logbuf_ring_size > max_ring_size)
+		logbuf_ring_size = sizeof(logbuf_ring_t) + data_size;
+	logbuf_data_size = data_size;
+
+	zeromem((void *)base, size);
+
+	hdr->version = (uint16_t)LOGBUF_VERSION;
+	hdr->num_cpus = PLATFORM_CORE_COUNT;
+	hdr->ring_offset = (uint32_t)ring_offset;
+	hdr->ring_size = (uint32_t)logbuf_ring_size;
+	hdr->data_size = (uint32_t)data_size;
+
+	/* Publish the header once the rest of the buffer is visible */
+	dmbishst();
+	hdr->magic = LOGBUF_MAGIC;
+
+	console->out = out;
+	logbuf_out = out;
+
+	return 1;
+}
+
+int console_logbuf_putc(int c, console_t *console)
+{
+	unsigned int cpu_idx = plat_my_core_pos();
+	logbuf_ring_t *ring = logbuf_get_ring(cpu_idx);
+	uint64_t head = logbuf_head[cpu_idx];
+
+	ring->data[head & (logbuf_data_size - 1U)] = (uint8_t)c;
+
+	/* The character must be visible before the new head */
+	dmbishst();
+	head++;
+	logbuf_head[cpu_idx] = head;
+	ring->head = head;
+
+	return c;
+}
+
+/*
+ * Write the characters of the ring of a CPU to the 'out' console, up to the
+ * head read on entry so that a CPU that keeps printing can't hold the drain.
+ * The characters that have been overwritten before they could be drained are
+ * skipped.
+ */
+static void logbuf_drain(unsigned int cpu_idx, console_t *out)
+{
+	const logbuf_ring_t *ring = logbuf_get_ring(cpu_idx);
+	uint8_t chunk[LOGBUF_DRAIN_CHUNK];
+	uint64_t mask = logbuf_data_size - 1U;
+	uint64_t tail = logbuf_tail[cpu_idx];
+	uint64_t end = logbuf_head[cpu_idx];
+	uint64_t head, skip, n, i;
+
+	while (tail < end) {
+		dmbishld();
+
+		if ((end - tail) > logbuf_data_size)
+			tail = end - logbuf_data_size;
+
+		n = MIN(end - tail, (uint64_t)LOGBUF_DRAIN_CHUNK);
+		for (i = 0U; i < n; i++)
+			chunk[i] = ring->data[(tail + i) & mask];
+
+		/* Check which characters were overwritten while copying */
+		dmbishld();
+		head = logbuf_head[cpu_idx];
+		skip = 0U;
+		if ((head - tail) > logbuf_data_size)
+			skip = MIN(head - logbuf_data_size - tail, n);
+
+		for (i = skip; i < n; i++)
+			(void)out->putc((int)chunk[i], out);
+
+		tail += n;
+	}
+
+	logbuf_tail[cpu_idx] = tail;
+}
+
+int console_logbuf_flush(console_t *console)
+{
+	console_t *out = ((console_logbuf_t *)console)->out;
+	unsigned int cpu_idx = plat_my_core_pos();
+	bool nested = (logbuf_drain_owner == cpu_idx);
+	unsigned int i;
+
+	/*
+	 * A panic or an assertion failure while this CPU drains the rings
+	 * flushes the consoles again, and taking the lock would deadlock. The
+	 * rings are then drained without it: the interrupted drain never
+	 * resumes.
+	 */
+	if (!nested) {
+		spin_lock(&logbuf_drain_lock);
+		logbuf_drain_owner = cpu_idx;
+	}
+
+	for (i = 0U; i < PLATFORM_CORE_COUNT; i++)
+		logbuf_drain(i, out);
+
+	if (!nested) {
+		logbuf_drain_owner = LOGBUF_NO_OWNER;
+		spin_unlock(&logbuf_drain_lock);
+	}
+
+	if (out->flush != NULL)
+		return out->flush(out);
+
+	return 0;
+}
+
+/*
+ * Called on the crash path of BL31, once the crash has been reported. The rings
+ * are drained without taking the drain lock, since it may be held by a CPU that
+ * will never release it, e.g. the one that has crashed.
+ */
+void console_logbuf_crash_drain(void)
+{
+	unsigned int i;
+
+	if (logbuf_out == NULL)
+		return;
+
+	for (i = 0U; i < PLATFORM_CORE_COUNT; i++)
+		logbuf_drain(i, logbuf_out);
+
+	if (logbuf_out->flush != NULL)
+		(void)logbuf_out->flush(logbuf_out);
+}
@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <string.h>
 
 #include <arch.h>
@@ -23,6 +24,9 @@ static int imx_usdhc_set_ios(unsigned int clk, unsigned int width);
 static int imx_usdhc_prepare(int lba, uintptr_t buf, size_t size);
 static int imx_usdhc_read(int lba, uintptr_t buf, size_t size);
 static int imx_usdhc_write(int lba, uintptr_t buf, size_t size);
+static size_t imx_usdhc_max_xfer_size(void);
+static int imx_usdhc_set_timing(unsigned int timing);
+static int imx_usdhc_execute_tuning(unsigned int cmd_idx);
 
 static const struct mmc_ops imx_usdhc_ops = {
 	.init		= imx_usdhc_initialize,
@@ -31,24 +35,30 @@ static const struct mmc_ops imx_usdhc_ops = {
 	.prepare	= imx_usdhc_prepare,
 	.read		= imx_usdhc_read,
 	.write		= imx_usdhc_write,
+	.max_xfer_size	= imx_usdhc_max_xfer_size,
+	.set_timing	= imx_usdhc_set_timing,
+	.execute_tuning	= imx_usdhc_execute_tuning,
 };
 
 static imx_usdhc_params_t imx_usdhc_params;
+/* Data is transferred on both clock edges in HS400 */
+static bool imx_usdhc_ddr;
 
 #define IMX7_MMC_SRC_CLK_RATE (200 * 1000 * 1000)
 static void imx_usdhc_set_clk(int clk)
 {
 	int div = 1;
 	int pre_div = 1;
+	int ddr_pre_div = imx_usdhc_ddr ? 2 : 1;
 	unsigned int sdhc_clk = IMX7_MMC_SRC_CLK_RATE;
 	uintptr_t reg_base = imx_usdhc_params.reg_base;
 
 	assert(clk > 0);
 
-	while (sdhc_clk / (16 * pre_div) > clk && pre_div < 256)
+	while (sdhc_clk / (16 * pre_div * ddr_pre_div) > clk && pre_div < 256)
 		pre_div *= 2;
 
-	while (sdhc_clk / div > clk && div < 16)
+	while (sdhc_clk / (div * ddr_pre_div) > clk && div < 16)
 		div++;
 
 	pre_div >>= 1;
@@ -69,6 +79,8 @@ static void imx_usdhc_initialize(void)
 
 	assert((imx_usdhc_params.reg_base & MMC_BLOCK_MASK) == 0);
 
+	imx_usdhc_ddr = false;
+
 	/* reset the controller */
 	mmio_setbits32(reg_base + SYSCTRL, SYSCTRL_RSTA);
 
@@ -97,6 +109,11 @@ static void imx_usdhc_initialize(void)
 	/* configure as little endian */
 	mmio_write_32(reg_base + PROTCTRL, PROTCTRL_LE);
 
+	/* Chain the transfers with ADMA2 descriptors when they are provided */
+	if (imx_usdhc_params.desc_base != 0U)
+		mmio_clrsetbits32(reg_base + PROTCTRL, PROTCTRL_DMASEL_MASK,
+				  PROTCTRL_DMASEL_ADMA2);
+
 	/* Set timeout to the maximum value */
 	mmio_clrsetbits32(reg_base + SYSCTRL, SYSCTRL_TIMEOUT_MASK,
 			  SYSCTRL_TIMEOUT(15));
@@ -162,6 +179,9 @@ static int imx_usdhc_send_cmd(struct mmc_cmd *cmd)
 		mixctl |= MIXCTRL_DMAEN;
 	}
 
+	if (imx_usdhc_ddr)
+		mixctl |= MIXCTRL_DDREN;
+
 	if (cmd->resp_type & MMC_RSP_48 && cmd->resp_type != MMC_RESPONSE_R2)
 		xfertype |= XFERTYPE_RSPTYP_48;
 	else if (cmd->resp_type & MMC_RSP_136)
@@ -249,6 +269,34 @@ out:
 	return err;
 }
 
+/*
+ * In HS400, the data is sampled with the data strobe of the device, delayed
+ * by the strobe DLL. The DLL must lock again after each change of the clock.
+ */
+static int imx_usdhc_set_strobe_dll(void)
+{
+	uintptr_t reg_base = imx_usdhc_params.reg_base;
+	unsigned int timeout = 50;
+	unsigned int locked = STROBE_DLL_STS_REF_LOCK | STROBE_DLL_STS_SLV_LOCK;
+
+	mmio_write_32(reg_base + STROBE_DLL_CTRL, STROBE_DLL_CTRL_RESET);
+	mmio_write_32(reg_base + STROBE_DLL_CTRL, 0);
+	mmio_write_32(reg_base + STROBE_DLL_CTRL,
+		      STROBE_DLL_CTRL_ENABLE |
+		      STROBE_DLL_CTRL_SLV_DLY_TARGET(7));
+
+	while ((mmio_read_32(reg_base + STROBE_DLL_STATUS) & locked) !=
+	       locked) {
+		if (timeout-- == 0U) {
+			ERROR("IMX MMC strobe DLL lock timeout.\n");
+			return -ETIMEDOUT;
+		}
+		udelay(1);
+	}
+
+	return 0;
+}
+
 static int imx_usdhc_set_ios(unsigned int clk, unsigned int width)
 {
 	uintptr_t reg_base = imx_usdhc_params.reg_base;
@@ -258,18 +306,150 @@ static int imx_usdhc_set_ios(unsigned int clk, unsigned int width)
 	if (width == MMC_BUS_WIDTH_4)
 		mmio_clrsetbits32(reg_base + PROTCTRL, PROTCTRL_WIDTH_MASK,
 				  PROTCTRL_WIDTH_4);
-	else if (width == MMC_BUS_WIDTH_8)
+	else if ((width == MMC_BUS_WIDTH_8) || (width == MMC_BUS_WIDTH_DDR_8))
 		mmio_clrsetbits32(reg_base + PROTCTRL, PROTCTRL_WIDTH_MASK,
 				  PROTCTRL_WIDTH_8);
 
+	if (imx_usdhc_ddr)
+		return imx_usdhc_set_strobe_dll();
+
 	return 0;
 }
 
-static int imx_usdhc_prepare(int lba, uintptr_t buf, size_t size)
+static int imx_usdhc_set_timing(unsigned int timing)
+{
+	uintptr_t reg_base = imx_usdhc_params.reg_base;
+
+	/* The tuning done in HS200 is kept for HS400 */
+	imx_usdhc_ddr = (timing == MMC_HS_TIMING_HS400);
+	if (imx_usdhc_ddr) {
+		mmio_setbits32(reg_base + MIXCTRL,
+			       MIXCTRL_DDREN | MIXCTRL_HS400_EN);
+	} else {
+		mmio_clrbits32(reg_base + MIXCTRL,
+			       MIXCTRL_DDREN | MIXCTRL_HS400_EN);
+		mmio_write_32(reg_base + STROBE_DLL_CTRL, 0);
+	}
+
+	return 0;
+}
+
+/*
+ * Send one tuning command. Its data block is only used by the tuning circuit,
+ * so the command is complete once the buffer is ready to be read.
+ */
+static int imx_usdhc_send_tuning(unsigned int cmd_idx)
+{
+	uintptr_t reg_base = imx_usdhc_params.reg_base;
+	unsigned int blk_size, state, cmd_retries = 0;
+
+	/* The tuning block is 128 bytes on an 8-bit bus, 64 bytes on 4 bits */
+	blk_size = (imx_usdhc_params.bus_width == MMC_BUS_WIDTH_8) ? 128 : 64;
+
+	mmio_write_32(reg_base + INTSTAT, 0xffffffff);
+
+	while (mmio_read_32(reg_base + PSTATE) & (PSTATE_CDIHB | PSTATE_CIHB))
+		;
+
+	mmio_write_32(reg_base + BLKATT, (1 << 16) | blk_size);
+	mmio_write_32(reg_base + CMDARG, 0);
+	mmio_clrsetbits32(reg_base + MIXCTRL, MIXCTRL_DATMASK, MIXCTRL_DTDSEL);
+	mmio_write_32(reg_base + XFERTYPE,
+		      XFERTYPE_CMD(cmd_idx) | XFERTYPE_DPSEL | XFERTYPE_CICEN |
+		      XFERTYPE_CCCEN | XFERTYPE_RSPTYP_48);
+
+	do {
+		state = mmio_read_32(reg_base + INTSTAT);
+		if (state & INTSTAT_BRR)
+			return 0;
+		udelay(1);
+	} while (++cmd_retries < FSL_CMD_RETRIES);
+
+	/* Reset CMD and DATA */
+	mmio_setbits32(reg_base + SYSCTRL, SYSCTRL_RSTC | SYSCTRL_RSTD);
+	while (mmio_read_32(reg_base + SYSCTRL) & (SYSCTRL_RSTC | SYSCTRL_RSTD))
+		;
+
+	return -ETIMEDOUT;
+}
+
+#define IMX_USDHC_TUNING_RETRIES	40
+
+/*
+ * Standard tuning: the controller moves the sampling point after each tuning
+ * block it receives, and clears EXE_TUNE once it has found a good one.
+ */
+static int imx_usdhc_execute_tuning(unsigned int cmd_idx)
 {
 	uintptr_t reg_base = imx_usdhc_params.reg_base;
+	unsigned int i, state;
+	int err = -EIO;
+
+	mmio_clrsetbits32(reg_base + TUNINGCTRL,
+			  TUNINGCTRL_STEP_MASK | TUNINGCTRL_START_TAP_MASK,
+			  TUNINGCTRL_STD_TUNING_EN | TUNINGCTRL_STEP(1) | 1);
+	mmio_clrsetbits32(reg_base + AUTOCMD12ERR, AUTOCMD12ERR_SMPCLKSEL,
+			  AUTOCMD12ERR_EXE_TUNE);
+	mmio_setbits32(reg_base + MIXCTRL,
+		       MIXCTRL_FBCLK_SEL | MIXCTRL_AUTO_TUNE_EN);
+
+	for (i = 0; i < IMX_USDHC_TUNING_RETRIES; i++) {
+		if (imx_usdhc_send_tuning(cmd_idx) != 0)
+			break;
+
+		state = mmio_read_32(reg_base + AUTOCMD12ERR);
+		if (!(state & AUTOCMD12ERR_EXE_TUNE)) {
+			if (state & AUTOCMD12ERR_SMPCLKSEL)
+				err = 0;
+			break;
+		}
+	}
+
+	/* Go back to the fixed sampling point if the tuning failed */
+	if (err) {
+		mmio_clrbits32(reg_base + AUTOCMD12ERR,
+			       AUTOCMD12ERR_EXE_TUNE | AUTOCMD12ERR_SMPCLKSEL);
+		mmio_clrbits32(reg_base + MIXCTRL,
+			       MIXCTRL_FBCLK_SEL | MIXCTRL_AUTO_TUNE_EN);
+	}
+
+	mmio_write_32(reg_base + INTSTAT, 0xffffffff);
+
+	return err;
+}
+
+static size_t imx_usdhc_max_xfer_size(void)
+{
+	/* The block count field of BLKATT has 16 bits */
+	size_t max_size = 0xffff * MMC_BLOCK_SIZE;
 
-	mmio_write_32(reg_base + DSADDR, buf);
+	if (imx_usdhc_params.desc_base != 0U)
+		max_size = MIN(max_size, (imx_usdhc_params.desc_size /
+					  sizeof(struct mmc_adma2_desc)) *
+					 MMC_ADMA2_MAX_LEN);
+
+	return max_size;
+}
+
+static int imx_usdhc_prepare(int lba, uintptr_t buf, size_t size)
+{
+	uintptr_t reg_base = imx_usdhc_params.reg_base;
+	int ret;
+
+	if (imx_usdhc_params.desc_base != 0U) {
+		ret = mmc_adma2_build(
+			(struct mmc_adma2_desc *)imx_usdhc_params.desc_base,
+			imx_usdhc_params.desc_size /
+			sizeof(struct mmc_adma2_desc),
+			buf, size);
+		if (ret != 0)
+			return ret;
+
+		mmio_write_32(reg_base + ADMASYSADDR,
+			      imx_usdhc_params.desc_base);
+	} else {
+		mmio_write_32(reg_base + DSADDR, buf);
+	}
 	mmio_write_32(reg_base + BLKATT,
 		      (size / MMC_BLOCK_SIZE) << 16 | MMC_BLOCK_SIZE);
 
@@ -295,6 +475,9 @@ void imx_usdhc_init(imx_usdhc_params_t *params,
 	       ((params->bus_width == MMC_BUS_WIDTH_1) ||
 		(params->bus_width == MMC_BUS_WIDTH_4) ||
 		(params->bus_width == MMC_BUS_WIDTH_8)));
+	assert((params->desc_base == 0) ||
+	       (((params->desc_base & 0x7) == 0) &&
+		(params->desc_size >= sizeof(struct mmc_adma2_desc))));
 
 	memcpy(&imx_usdhc_params, params, sizeof(imx_usdhc_params_t));
 	mmc_init(&imx_usdhc_ops, params->clk_rate, params->bus_width,
@@ -14,6 +14,12 @@ typedef struct imx_usdhc_params {
 	int		clk_rate;
 	int		bus_width;
 	unsigned int	flags;
+	/*
+	 * Optional table of ADMA2 descriptors. When it is not provided, the
+	 * controller uses its simple DMA engine.
+	 */
+	uintptr_t	desc_base;
+	size_t		desc_size;
 } imx_usdhc_params_t;
 
 void imx_usdhc_init(imx_usdhc_params_t *params,
@@ -45,12 +51,15 @@ void imx_usdhc_init(imx_usdhc_params_t *params,
 #define PSTATE_CIHB		BIT(0)
 
 #define PROTCTRL		0x028
+#define PROTCTRL_DMASEL_ADMA2	(2 << 8)
+#define PROTCTRL_DMASEL_MASK	(3 << 8)
 #define PROTCTRL_LE		BIT(5)
 #define PROTCTRL_WIDTH_4	BIT(1)
 #define PROTCTRL_WIDTH_8	BIT(2)
 #define PROTCTRL_WIDTH_MASK	0x6
 
 #define SYSCTRL			0x02c
+#define SYSCTRL_RSTT		BIT(28)
 #define SYSCTRL_RSTD		BIT(26)
 #define SYSCTRL_RSTC		BIT(25)
 #define SYSCTRL_RSTA		BIT(24)
@@ -66,6 +75,7 @@ void imx_usdhc_init(imx_usdhc_params_t *params,
 #define INTSTAT_CIE		BIT(19)
 #define INTSTAT_CEBE		BIT(18)
 #define INTSTAT_CCE		BIT(17)
+#define INTSTAT_BRR		BIT(5)
 #define INTSTAT_DINT		BIT(3)
 #define INTSTAT_BGE		BIT(2)
 #define INTSTAT_TC		BIT(1)
@@ -97,12 +107,19 @@ void imx_usdhc_init(imx_usdhc_params_t *params,
 
 #define INTSIGEN		0x038
 
+#define AUTOCMD12ERR		0x03c
+#define AUTOCMD12ERR_SMPCLKSEL	BIT(23)
+#define AUTOCMD12ERR_EXE_TUNE	BIT(22)
+
 #define WATERMARKLEV		0x044
 #define WMKLV_RD_MASK		0xff
 #define WMKLV_WR_MASK		0x00ff0000
 #define WMKLV_MASK		(WMKLV_RD_MASK | WMKLV_WR_MASK)
 
 #define MIXCTRL			0x048
+#define MIXCTRL_HS400_EN	BIT(26)
+#define MIXCTRL_FBCLK_SEL	BIT(25)
+#define MIXCTRL_AUTO_TUNE_EN	BIT(24)
 #define MIXCTRL_MSBSEL		BIT(5)
 #define MIXCTRL_DTDSEL		BIT(4)
 #define MIXCTRL_DDREN		BIT(3)
@@ -111,10 +128,21 @@ void imx_usdhc_init(imx_usdhc_params_t *params,
 #define MIXCTRL_DMAEN		BIT(0)
 #define MIXCTRL_DATMASK		0x7f
 
+#define ADMASYSADDR		0x058
+
 #define DLLCTRL			0x060
 
 #define CLKTUNECTRLSTS		0x068
 
+#define STROBE_DLL_CTRL		0x070
+#define STROBE_DLL_CTRL_SLV_DLY_TARGET(x)	(((x) & 0xf) << 3)
+#define STROBE_DLL_CTRL_RESET	BIT(1)
+#define STROBE_DLL_CTRL_ENABLE	BIT(0)
+
+#define STROBE_DLL_STATUS	0x074
+#define STROBE_DLL_STS_REF_LOCK	BIT(1)
+#define STROBE_DLL_STS_SLV_LOCK	BIT(0)
+
 #define VENDSPEC		0x0c0
 #define VENDSPEC_RSRV1		BIT(29)
 #define VENDSPEC_CARD_CLKEN	BIT(14)
@@ -130,6 +158,12 @@ void imx_usdhc_init(imx_usdhc_params_t *params,
 
 #define MMCBOOT			0x0c4
 
+#define TUNINGCTRL		0x0cc
+#define TUNINGCTRL_STD_TUNING_EN	BIT(24)
+#define TUNINGCTRL_STEP_MASK	(0x7 << 16)
+#define TUNINGCTRL_STEP(x)	(((x) & 0x7) << 16)
+#define TUNINGCTRL_START_TAP_MASK	0xff
+
 #define mmio_clrsetbits32(addr, clear, set)	mmio_write_32(addr, (mmio_read_32(addr) & ~(clear)) | (set))
 #define mmio_clrbits32(addr, clear)		mmio_write_32(addr, mmio_read_32(addr) & ~(clear))
 #define mmio_setbits32(addr, set)		mmio_write_32(addr, mmio_read_32(addr) | (set))
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -21,6 +21,9 @@ typedef struct {
 	uintptr_t		base;
 	size_t			file_pos;
 	size_t			size;
+	/* Buffer and length of the asynchronous read in progress */
+	uintptr_t		async_buffer;
+	size_t			async_length;
 } block_dev_state_t;
 
 #define is_power_of_2(x)	((x != 0) && ((x & (x - 1)) == 0))
@@ -30,11 +33,15 @@ io_type_t device_type_block(void);
 static int block_open(io_dev_info_t *dev_info, const uintptr_t spec,
 		      io_entity_t *entity);
 static int block_seek(io_entity_t *entity, int mode, ssize_t offset);
+static int block_len(io_entity_t *entity, size_t *length);
 static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		      size_t *length_read);
 static int block_write(io_entity_t *entity, const uintptr_t buffer,
 		       size_t length, size_t *length_written);
 static int block_close(io_entity_t *entity);
+static int block_read_submit(io_entity_t *entity, uintptr_t buffer,
+			     size_t length);
+static int block_read_poll(io_entity_t *entity, size_t *length_read);
 static int block_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info);
 static int block_dev_close(io_dev_info_t *dev_info);
 
@@ -46,12 +53,14 @@ static const io_dev_funcs_t block_dev_funcs = {
 	.type		= device_type_block,
 	.open		= block_open,
 	.seek		= block_seek,
-	.size		= NULL,
+	.size		= block_len,
 	.read		= block_read,
 	.write		= block_write,
 	.close		= block_close,
 	.dev_init	= NULL,
 	.dev_close	= block_dev_close,
+	.read_submit	= block_read_submit,
+	.read_poll	= block_read_poll,
 };
 
 static block_dev_state_t state_pool[MAX_IO_BLOCK_DEVICES];
@@ -147,6 +156,34 @@ static int block_open(io_dev_info_t *dev_info, const uintptr_t spec,
 	return 0;
 }
 
+/*
+ * Return 1 if the transfer of the next blocks can be done straight to or from
+ * the caller buffer, without going through the device buffer. This requires
+ * the file position to be block-aligned, at least one whole block to be left
+ * and the caller buffer to meet the alignment required by the driver.
+ */
+static int is_direct_transfer(const io_block_dev_spec_t *dev_spec,
+			      uintptr_t buffer, size_t skip, size_t left)
+{
+	return (dev_spec->direct_align != 0U) && (skip == 0U) &&
+	       (left >= dev_spec->block_size) &&
+	       ((buffer & (dev_spec->direct_align - 1U)) == 0U);
+}
+
+/*
+ * Return 1 if only the unaligned head block should go through the device
+ * buffer because the following blocks can be transferred directly.
+ */
+static int is_direct_after_head(const io_block_dev_spec_t *dev_spec,
+				uintptr_t buffer, size_t skip, size_t left)
+{
+	size_t head = dev_spec->block_size - skip;
+
+	return (skip != 0U) && (left > head) &&
+	       (is_direct_transfer(dev_spec, buffer + head, 0U,
+				   left - head) != 0);
+}
+
 /* parameter offset is relative address at here */
 static int block_seek(io_entity_t *entity, int mode, ssize_t offset)
 {
@@ -171,6 +208,17 @@ static int block_seek(io_entity_t *entity, int mode, ssize_t offset)
 	return 0;
 }
 
+/* Return the size of the region that has been opened */
+static int block_len(io_entity_t *entity, size_t *length)
+{
+	assert(entity->info != (uintptr_t)NULL);
+	assert(length != NULL);
+
+	*length = ((block_dev_state_t *)entity->info)->size;
+
+	return 0;
+}
+
 /*
  * This function allows the caller to read any number of bytes
  * from any position. It hides from the caller that the low level
@@ -240,6 +288,10 @@ static int block_seek(io_entity_t *entity, int mode, ssize_t offset)
  *
  * Additionally, the IO driver has an underlying buffer that is at least
  * one block-size and may be big enough to allow.
+ *
+ * If the device declares a direct_align, the whole blocks in between are
+ * read straight into the caller buffer when it is suitably aligned, and only
+ * the head and tail blocks are copied through the underlying buffer.
  */
 static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		      size_t *length_read)
@@ -296,7 +348,27 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		 */
 		lba = (cur->file_pos + cur->base) / block_size;
 
-		if (skip + left > buf->length) {
+		if (is_direct_transfer(cur->dev_spec, buffer + count, skip,
+				       left) != 0) {
+			request = ops->read(lba, buffer + count,
+					    left & ~(block_size - 1));
+			if (request == 0) {
+				return -EIO;
+			}
+			nbytes = (request > left) ? left : request;
+			cur->file_pos += nbytes;
+			count += nbytes;
+			continue;
+		}
+
+		if (is_direct_after_head(cur->dev_spec, buffer + count, skip,
+					 left) != 0) {
+			/*
+			 * Only read the head block through the underlying
+			 * buffer, the next ones will be read directly.
+			 */
+			request = block_size;
+		} else if (skip + left > buf->length) {
 			/*
 			 * The underlying read buffer is too small to
 			 * read all the required data - limit to just
@@ -346,6 +418,83 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	return 0;
 }
 
+/*
+ * Start an asynchronous read. The whole blocks are read by the driver straight
+ * into the caller buffer, which requires the same conditions as a direct
+ * transfer. The bytes of a partial last block are read synchronously through
+ * the underlying buffer once the whole blocks have been read.
+ */
+static int block_read_submit(io_entity_t *entity, uintptr_t buffer,
+			     size_t length)
+{
+	block_dev_state_t *cur;
+	io_block_ops_t *ops;
+	size_t block_size;
+	int lba;
+	int result;
+
+	assert(entity->info != (uintptr_t)NULL);
+	cur = (block_dev_state_t *)entity->info;
+	ops = &(cur->dev_spec->ops);
+	block_size = cur->dev_spec->block_size;
+	assert((length <= cur->size) && (length > 0));
+
+	if ((ops->read_submit == NULL) ||
+	    (is_direct_transfer(cur->dev_spec, buffer,
+				cur->file_pos & (block_size - 1),
+				length) == 0)) {
+		return -ENOTSUP;
+	}
+	assert(ops->read_poll != NULL);
+
+	lba = (cur->file_pos + cur->base) / block_size;
+	result = ops->read_submit(lba, buffer, length & ~(block_size - 1));
+	if (result != 0) {
+		return result;
+	}
+
+	cur->async_buffer = buffer;
+	cur->async_length = length;
+	return 0;
+}
+
+static int block_read_poll(io_entity_t *entity, size_t *length_read)
+{
+	block_dev_state_t *cur;
+	io_block_ops_t *ops;
+	size_t block_size;
+	size_t nbytes, tail, tail_read = 0;
+	int result;
+
+	assert((entity->info != (uintptr_t)NULL) && (length_read != NULL));
+	cur = (block_dev_state_t *)entity->info;
+	ops = &(cur->dev_spec->ops);
+	block_size = cur->dev_spec->block_size;
+
+	result = ops->read_poll(&nbytes);
+	if (result == -EAGAIN) {
+		return result;
+	}
+	if ((result != 0) ||
+	    (nbytes != (cur->async_length & ~(block_size - 1)))) {
+		return -EIO;
+	}
+	cur->file_pos += nbytes;
+
+	/* Read the partial last block, if any */
+	tail = cur->async_length - nbytes;
+	if (tail != 0U) {
+		result = block_read(entity, cur->async_buffer + nbytes, tail,
+				    &tail_read);
+		if (result != 0) {
+			return result;
+		}
+	}
+
+	*length_read = nbytes + tail_read;
+	return 0;
+}
+
 /*
  * This function allows the caller to write any number of bytes
  * from any position. It hides from the caller that the low level
@@ -408,7 +557,27 @@ static int block_write(io_entity_t *entity, const uintptr_t buffer,
 		 */
 		lba = (cur->file_pos + cur->base) / block_size;
 
-		if (skip + left > buf->length) {
+		if (is_direct_transfer(cur->dev_spec, buffer + count, skip,
+				       left) != 0) {
+			request = ops->write(lba, buffer + count,
+					     left & ~(block_size - 1));
+			if (request == 0) {
+				return -EIO;
+			}
+			nbytes = (request > left) ? left : request;
+			cur->file_pos += nbytes;
+			count += nbytes;
+			continue;
+		}
+
+		if (is_direct_after_head(cur->dev_spec, buffer + count, skip,
+					 left) != 0) {
+			/*
+			 * Only write the head block through the underlying
+			 * buffer, the next ones will be written directly.
+			 */
+			request = block_size;
+		} else if (skip + left > buf->length) {
 			/*
 			 * The underlying read buffer is too small to
 			 * read all the required data - limit to just
@@ -517,6 +686,8 @@ static int block_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info)
 	       (is_power_of_2(block_size) != 0) &&
 	       ((buffer->offset % block_size) == 0) &&
 	       ((buffer->length % block_size) == 0));
+	assert((cur->dev_spec->direct_align == 0U) ||
+	       (is_power_of_2(cur->dev_spec->direct_align) != 0));
 
 	*dev_info = info;	/* cast away const */
 	(void)block_size;
@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -16,6 +17,7 @@
 #include <drivers/io/io_driver.h>
 #include <drivers/io/io_fip.h>
 #include <drivers/io/io_storage.h>
+#include <lib/cassert.h>
 #include <lib/utils.h>
 #include <plat/common/platform.h>
 #include <tools_share/firmware_image_package.h>
@@ -25,6 +27,18 @@
 #define MAX_FIP_DEVICES		1
 #endif
 
+/*
+ * Number of ToC entries cached per FIP device. The ToC is then read once when
+ * the device is initialised and image lookups no longer need any backend I/O.
+ * A value of 0 disables the cache.
+ */
+#ifndef FIP_TOC_CACHE_ENTRIES
+#define FIP_TOC_CACHE_ENTRIES	0
+#endif
+
+/* Number of slots of the UUID index of the ToC cache, must be a power of 2 */
+#define FIP_TOC_INDEX_SIZE	U(64)
+
 /* Useful for printing UUIDs when debugging.*/
 #define PRINT_UUID2(x)								\
 	"%08x-%04hx-%04hx-%02hhx%02hhx-%02hhx%02hhx%02hhx%02hhx%02hhx%02hhx",	\
@@ -36,8 +50,39 @@
 typedef struct {
 	unsigned int file_pos;
 	fip_toc_entry_t entry;
+	/* Backend handle and request of an asynchronous read */
+	uintptr_t backend_handle;
+	io_async_req_t backend_req;
 } file_state_t;
 
+#if FIP_TOC_CACHE_ENTRIES > 0
+/*
+ * Copy of the start of the ToC. 'complete' is set when the end of ToC marker
+ * was found within the cached entries, in which case a lookup miss means that
+ * the image is not in the package at all.
+ *
+ * The entries are indexed by UUID in an open addressing hash table, in which
+ * each slot holds the index of an entry plus one, or 0 if the slot is free.
+ *
+ * The cache belongs to the FIP found at 'backend_dev' and 'backend_spec', and
+ * is discarded when the device is initialised for a FIP at another location,
+ * e.g. the FWU FIP.
+ */
+typedef struct {
+	bool valid;
+	bool complete;
+	unsigned int num_entries;
+	uintptr_t backend_dev;
+	uintptr_t backend_spec;
+	fip_toc_entry_t entries[FIP_TOC_CACHE_ENTRIES];
+	uint8_t index[FIP_TOC_INDEX_SIZE];
+} fip_toc_cache_t;
+
+CASSERT(FIP_TOC_CACHE_ENTRIES < UINT8_MAX, assert_fip_toc_index_entry_size);
+CASSERT((2 * FIP_TOC_CACHE_ENTRIES) <= FIP_TOC_INDEX_SIZE,
+	assert_fip_toc_index_size);
+#endif
+
 /*
  * Maintain dev_spec per FIP Device
  * TODO - Add backend handles and file state
@@ -46,6 +91,9 @@ typedef struct {
  */
 typedef struct {
 	uintptr_t dev_spec;
+#if FIP_TOC_CACHE_ENTRIES > 0
+	fip_toc_cache_t toc_cache;
+#endif
 } fip_dev_state_t;
 
 static const uuid_t uuid_null;
@@ -74,6 +122,9 @@ static int fip_file_len(io_entity_t *entity, size_t *length);
 static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 			  size_t *length_read);
 static int fip_file_close(io_entity_t *entity);
+static int fip_file_read_submit(io_entity_t *entity, uintptr_t buffer,
+				size_t length);
+static int fip_file_read_poll(io_entity_t *entity, size_t *length_read);
 static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params);
 static int fip_dev_close(io_dev_info_t *dev_info);
 
@@ -95,6 +146,99 @@ static inline int is_valid_header(fip_toc_header_t *header)
 }
 
 
+#if FIP_TOC_CACHE_ENTRIES > 0
+static unsigned int uuid_hash(const uuid_t *uuid)
+{
+	const uint8_t *bytes = (const uint8_t *)uuid;
+	unsigned int hash = 5381U;
+	unsigned int i;
+
+	for (i = 0U; i < sizeof(uuid_t); i++) {
+		hash = (hash * 33U) ^ bytes[i];
+	}
+
+	return hash & (FIP_TOC_INDEX_SIZE - 1U);
+}
+
+static void fip_toc_cache_invalidate(fip_toc_cache_t *cache)
+{
+	zeromem(cache, sizeof(*cache));
+}
+
+/*
+ * Fill the ToC cache with a single read from the backend. The backend must be
+ * positioned right after the FIP header.
+ */
+static int fip_toc_cache_fill(fip_toc_cache_t *cache, uintptr_t backend_handle)
+{
+	int result;
+	size_t fip_size;
+	size_t length = sizeof(cache->entries);
+	size_t bytes_read;
+	unsigned int i, slot;
+
+	/* Do not read past the end of the package */
+	result = io_size(backend_handle, &fip_size);
+	if ((result == 0) && (fip_size > sizeof(fip_toc_header_t)) &&
+	    ((fip_size - sizeof(fip_toc_header_t)) < length)) {
+		length = fip_size - sizeof(fip_toc_header_t);
+	}
+
+	result = io_read(backend_handle, (uintptr_t)cache->entries, length,
+			 &bytes_read);
+	if (result != 0) {
+		return result;
+	}
+
+	cache->num_entries = (unsigned int)(bytes_read /
+					    sizeof(fip_toc_entry_t));
+	cache->complete = false;
+	for (i = 0U; i < cache->num_entries; i++) {
+		if (compare_uuids(&cache->entries[i].uuid, &uuid_null) == 0) {
+			cache->num_entries = i;
+			cache->complete = true;
+			break;
+		}
+	}
+
+	for (i = 0U; i < cache->num_entries; i++) {
+		slot = uuid_hash(&cache->entries[i].uuid);
+		while (cache->index[slot] != 0U) {
+			slot = (slot + 1U) & (FIP_TOC_INDEX_SIZE - 1U);
+		}
+		cache->index[slot] = (uint8_t)(i + 1U);
+	}
+
+	cache->backend_dev = backend_dev_handle;
+	cache->backend_spec = backend_image_spec;
+	cache->valid = true;
+
+	VERBOSE("FIP ToC cache: %u entries%s\n", cache->num_entries,
+		cache->complete ? "" : " (partial)");
+
+	return 0;
+}
+
+/* Look up an image in the ToC cache. Returns NULL if it is not cached. */
+static const fip_toc_entry_t *fip_toc_cache_lookup(
+		const fip_toc_cache_t *cache, const uuid_t *uuid)
+{
+	unsigned int slot = uuid_hash(uuid);
+	const fip_toc_entry_t *entry;
+
+	while (cache->index[slot] != 0U) {
+		entry = &cache->entries[cache->index[slot] - 1U];
+		if (compare_uuids(&entry->uuid, uuid) == 0) {
+			return entry;
+		}
+		slot = (slot + 1U) & (FIP_TOC_INDEX_SIZE - 1U);
+	}
+
+	return NULL;
+}
+#endif /* FIP_TOC_CACHE_ENTRIES > 0 */
+
+
 /* Identify the device type as a virtual driver */
 static io_type_t device_type_fip(void)
 {
@@ -117,6 +261,8 @@ static const io_dev_funcs_t fip_dev_funcs = {
 	.close = fip_file_close,
 	.dev_init = fip_dev_init,
 	.dev_close = fip_dev_close,
+	.read_submit = fip_file_read_submit,
+	.read_poll = fip_file_read_poll,
 };
 
 /* Locate a file state in the pool, specified by address */
@@ -174,7 +320,16 @@ static int free_dev_info(io_dev_info_t *dev_info)
 	result = find_first_fip_state(state->dev_spec, &index);
 	if (result ==  0) {
 		/* free if device info is valid */
+#if FIP_TOC_CACHE_ENTRIES > 0
+		/*
+		 * load_image() closes the device after every image, so the
+		 * ToC cache is kept until the device is initialised for
+		 * another FIP.
+		 */
+		state->dev_spec = (uintptr_t)NULL;
+#else
 		zeromem(state, sizeof(fip_dev_state_t));
+#endif
 		--fip_dev_count;
 	}
 
@@ -220,6 +375,9 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 	uintptr_t backend_handle;
 	fip_toc_header_t header;
 	size_t bytes_read;
+#if FIP_TOC_CACHE_ENTRIES > 0
+	fip_dev_state_t *state = (fip_dev_state_t *)dev_info->info;
+#endif
 
 	/* Obtain a reference to the image by querying the platform layer */
 	result = plat_get_image_source(image_id, &backend_dev_handle,
@@ -231,6 +389,18 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 		goto fip_dev_init_exit;
 	}
 
+#if FIP_TOC_CACHE_ENTRIES > 0
+	if (state->toc_cache.valid) {
+		/* The header has already been checked when the cache was filled */
+		if ((state->toc_cache.backend_dev == backend_dev_handle) &&
+		    (state->toc_cache.backend_spec == backend_image_spec)) {
+			goto fip_dev_init_exit;
+		}
+
+		fip_toc_cache_invalidate(&state->toc_cache);
+	}
+#endif
+
 	/* Attempt to access the FIP image */
 	result = io_open(backend_dev_handle, backend_image_spec,
 			 &backend_handle);
@@ -248,6 +418,13 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 			result = -ENOENT;
 		} else {
 			VERBOSE("FIP header looks OK.\n");
+#if FIP_TOC_CACHE_ENTRIES > 0
+			/* Failing to cache the ToC is not fatal */
+			if (fip_toc_cache_fill(&state->toc_cache,
+					       backend_handle) != 0) {
+				WARN("Failed to cache FIP ToC\n");
+			}
+#endif
 		}
 	}
 
@@ -279,6 +456,10 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 	const io_uuid_spec_t *uuid_spec = (io_uuid_spec_t *)spec;
 	size_t bytes_read;
 	int found_file = 0;
+#if FIP_TOC_CACHE_ENTRIES > 0
+	const fip_dev_state_t *state = (fip_dev_state_t *)dev_info->info;
+	const fip_toc_entry_t *cached_entry;
+#endif
 
 	assert(uuid_spec != NULL);
 	assert(entity != NULL);
@@ -294,6 +475,24 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 		return -ENOMEM;
 	}
 
+#if FIP_TOC_CACHE_ENTRIES > 0
+	if (state->toc_cache.valid) {
+		cached_entry = fip_toc_cache_lookup(&state->toc_cache,
+						    &uuid_spec->uuid);
+		if (cached_entry != NULL) {
+			current_file.entry = *cached_entry;
+			current_file.file_pos = 0;
+			entity->info = (uintptr_t)&current_file;
+			return 0;
+		}
+
+		/* The whole ToC is cached, so the file is not in the FIP */
+		if (state->toc_cache.complete) {
+			return -ENOENT;
+		}
+	}
+#endif
+
 	/* Attempt to access the FIP image */
 	result = io_open(backend_dev_handle, backend_image_spec,
 			 &backend_handle);
@@ -417,6 +616,87 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 }
 
 
+/*
+ * Start an asynchronous read of a file in the package. The backend stays open
+ * until the read has completed.
+ */
+static int fip_file_read_submit(io_entity_t *entity, uintptr_t buffer,
+				size_t length)
+{
+	int result;
+	file_state_t *fp;
+	size_t file_offset;
+
+	assert(entity != NULL);
+	assert(entity->info != (uintptr_t)NULL);
+
+	fp = (file_state_t *)entity->info;
+
+	/* Open the backend, attempt to access the blob image */
+	result = io_open(backend_dev_handle, backend_image_spec,
+			 &fp->backend_handle);
+	if (result != 0) {
+		WARN("Failed to open FIP (%i)\n", result);
+		return -ENOENT;
+	}
+
+	/* Seek to the position in the FIP where the payload lives */
+	file_offset = fp->entry.offset_address + fp->file_pos;
+	result = io_seek(fp->backend_handle, IO_SEEK_SET, file_offset);
+	if (result != 0) {
+		WARN("fip_file_read_submit: failed to seek\n");
+		io_close(fp->backend_handle);
+		return -ENOENT;
+	}
+
+	/* The backend falls back to a synchronous read if it has to */
+	result = io_read_submit(fp->backend_handle, buffer, length,
+				&fp->backend_req);
+	if (result != 0) {
+		WARN("Failed to read payload (%i)\n", result);
+		io_close(fp->backend_handle);
+		return -ENOENT;
+	}
+
+	return 0;
+}
+
+
+/* Complete an asynchronous read of a file in package */
+static int fip_file_read_poll(io_entity_t *entity, size_t *length_read)
+{
+	int result;
+	file_state_t *fp;
+	size_t bytes_read;
+
+	assert(entity != NULL);
+	assert(length_read != NULL);
+	assert(entity->info != (uintptr_t)NULL);
+
+	fp = (file_state_t *)entity->info;
+
+	result = io_read_poll(&fp->backend_req);
+	if (result == -EAGAIN) {
+		return result;
+	}
+
+	bytes_read = fp->backend_req.length_read;
+	io_close(fp->backend_handle);
+
+	if (result != 0) {
+		/* We cannot read our data. Fail. */
+		WARN("Failed to read payload (%i)\n", result);
+		return -ENOENT;
+	}
+
+	/* Set caller length and new file position. */
+	*length_read = bytes_read;
+	fp->file_pos += bytes_read;
+
+	return 0;
+}
+
+
 /* Close a file in package */
 static int fip_file_close(io_entity_t *entity)
 {
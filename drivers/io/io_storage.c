@@ -331,3 +331,84 @@ int io_close(uintptr_t handle)
 
 	return result;
 }
+
+
+/* Asynchronous operations */
+
+
+/* Start reading data from an IO entity. If the device doesn't support
+ * asynchronous reads, or not for this request, the data is read before
+ * returning and the request is already complete. Either way, the request must
+ * be completed with io_read_poll() or io_read_wait() before the next operation
+ * on the entity */
+int io_read_submit(uintptr_t handle,
+		uintptr_t buffer,
+		size_t length,
+		io_async_req_t *req)
+{
+	int result = -ENOTSUP;
+	assert(is_valid_entity(handle) && (req != NULL));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	req->handle = handle;
+	req->length_read = 0U;
+	req->pending = 0;
+
+	if (dev->funcs->read_submit != NULL) {
+		assert(dev->funcs->read_poll != NULL);
+		result = dev->funcs->read_submit(entity, buffer, length);
+		if (result == 0)
+			req->pending = 1;
+	}
+
+	/* Fall back to a synchronous read */
+	if (result == -ENOTSUP)
+		result = io_read(handle, buffer, length, &req->length_read);
+
+	req->result = result;
+	return result;
+}
+
+
+/* Return -EAGAIN while an asynchronous read is in progress, or its result once
+ * it has completed */
+int io_read_poll(io_async_req_t *req)
+{
+	int result;
+	assert((req != NULL) && is_valid_entity(req->handle));
+
+	io_entity_t *entity = (io_entity_t *)req->handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	if (req->pending != 0) {
+		result = dev->funcs->read_poll(entity, &req->length_read);
+		if (result == -EAGAIN)
+			return result;
+
+		req->pending = 0;
+		req->result = result;
+	}
+
+	return req->result;
+}
+
+
+/* Wait for an asynchronous read to complete */
+int io_read_wait(io_async_req_t *req, size_t *length_read)
+{
+	int result;
+	assert(req != NULL);
+
+	do {
+		result = io_read_poll(req);
+	} while (result == -EAGAIN);
+
+	if (length_read != NULL)
+		*length_read = req->length_read;
+
+	return result;
+}
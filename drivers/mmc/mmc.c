@@ -44,6 +44,12 @@ static bool is_cmd23_enabled(void)
 	return ((mmc_flags & MMC_FLAG_CMD23) != 0U);
 }
 
+static bool is_hs200_requested(void)
+{
+	return (((mmc_flags & (MMC_FLAG_HS200 | MMC_FLAG_HS400)) != 0U) &&
+		(mmc_dev_info->mmc_dev_type == MMC_IS_EMMC));
+}
+
 static int mmc_send_cmd(unsigned int idx, unsigned int arg,
 			unsigned int r_type, unsigned int *r_data)
 {
@@ -217,6 +223,124 @@ static int mmc_set_ios(unsigned int clk, unsigned int bus_width)
 	return ops->set_ios(clk, width);
 }
 
+/*
+ * Switch the HS_TIMING field of the device and the timing of the controller.
+ * The controller must use the new timing before the status of the device is
+ * read.
+ */
+static int mmc_switch_timing(unsigned int timing, unsigned int clk,
+			     unsigned int bus_width)
+{
+	int ret;
+
+	ret = mmc_send_cmd(MMC_CMD(6),
+			   EXTCSD_WRITE_BYTES |
+			   EXTCSD_CMD(CMD_EXTCSD_HS_TIMING) |
+			   EXTCSD_VALUE(timing) | EXTCSD_CMD_SET_NORMAL,
+			   MMC_RESPONSE_R1B, NULL);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = ops->set_timing(timing);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = ops->set_ios(clk, bus_width);
+	if (ret != 0) {
+		return ret;
+	}
+
+	do {
+		ret = mmc_device_state();
+		if (ret < 0) {
+			return ret;
+		}
+	} while (ret == MMC_STATE_PRG);
+
+	return 0;
+}
+
+/* Switch to the high speed timing, at up to 52MHz */
+static int mmc_set_hs52_timing(unsigned int hs_clk, unsigned int bus_width)
+{
+	int ret;
+
+	ret = mmc_switch_timing(MMC_HS_TIMING_HS, hs_clk, bus_width);
+	if (ret == 0) {
+		mmc_dev_info->max_bus_freq = hs_clk;
+	}
+
+	return ret;
+}
+
+/*
+ * Move an eMMC device from the legacy timing to HS200, or HS400 if requested,
+ * once the EXT CSD register has been read. Devices that don't support HS200,
+ * or for which the tuning fails, are switched to the high speed timing
+ * instead.
+ */
+static int mmc_set_hs_timing(unsigned int clk, unsigned int bus_width)
+{
+	unsigned int dev_type = mmc_ext_csd[CMD_EXTCSD_DEVICE_TYPE];
+	unsigned int hs_clk = MIN(clk, MMC_HS_MAX_CLK_RATE);
+	int ret;
+
+	if ((dev_type & MMC_DEVICE_TYPE_HS200) == 0U) {
+		if ((dev_type & MMC_DEVICE_TYPE_HS_52) == 0U) {
+			return 0;
+		}
+
+		VERBOSE("HS200 not supported, using high speed timing\n");
+		return mmc_set_hs52_timing(hs_clk, bus_width);
+	}
+
+	ret = mmc_switch_timing(MMC_HS_TIMING_HS200, clk, bus_width);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = ops->execute_tuning(MMC_CMD(21));
+	if (ret != 0) {
+		WARN("HS200 tuning failed (ret=%d), using high speed timing\n",
+		     ret);
+		/*
+		 * Without tuning, commands may not be sampled correctly at the
+		 * HS200 clock rate. Lower it before switching the timing.
+		 */
+		ret = ops->set_ios(hs_clk, bus_width);
+		if (ret != 0) {
+			return ret;
+		}
+
+		return mmc_set_hs52_timing(hs_clk, bus_width);
+	}
+
+	mmc_dev_info->max_bus_freq = clk;
+
+	if (((mmc_flags & MMC_FLAG_HS400) == 0U) ||
+	    ((dev_type & MMC_DEVICE_TYPE_HS400) == 0U)) {
+		return 0;
+	}
+
+	/*
+	 * HS400 is entered from the high speed timing, after the bus has been
+	 * switched to 8-bit DDR. The tuning done in HS200 is kept.
+	 */
+	ret = mmc_switch_timing(MMC_HS_TIMING_HS, hs_clk, bus_width);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = mmc_set_ext_csd(CMD_EXTCSD_BUS_WIDTH, MMC_BUS_WIDTH_DDR_8);
+	if (ret != 0) {
+		return ret;
+	}
+
+	return mmc_switch_timing(MMC_HS_TIMING_HS400, clk, MMC_BUS_WIDTH_DDR_8);
+}
+
 static int mmc_fill_device_info(void)
 {
 	unsigned long long c_size;
@@ -489,24 +613,58 @@ static int mmc_enumerate(unsigned int clk, unsigned int bus_width)
 		}
 	} while (ret != MMC_STATE_TRAN);
 
-	ret = mmc_set_ios(clk, bus_width);
+	/* HS200 is only entered after the EXT CSD register has been read */
+	if (is_hs200_requested()) {
+		ret = mmc_set_ios(MIN(clk, MMC_LEGACY_MAX_CLK_RATE), bus_width);
+	} else {
+		ret = mmc_set_ios(clk, bus_width);
+	}
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = mmc_fill_device_info();
 	if (ret != 0) {
 		return ret;
 	}
 
-	return mmc_fill_device_info();
+	if (is_hs200_requested()) {
+		return mmc_set_hs_timing(clk, bus_width);
+	}
+
+	return 0;
 }
 
-size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
+/*
+ * Largest transfer that can be done with a single read or write command,
+ * limited by the controller and by the block count of CMD23.
+ */
+static size_t mmc_max_xfer_size(void)
+{
+	size_t max_size = SIZE_MAX;
+
+	if (is_cmd23_enabled()) {
+		max_size = MMC_CMD23_MAX_BLOCKS * MMC_BLOCK_SIZE;
+	}
+
+	if (ops->max_xfer_size != NULL) {
+		size_t ops_max_size = ops->max_xfer_size();
+
+		if (ops_max_size != 0U) {
+			max_size = MIN(max_size, ops_max_size);
+		}
+	}
+
+	assert(max_size >= MMC_BLOCK_SIZE);
+
+	return max_size & ~(size_t)MMC_BLOCK_MASK;
+}
+
+static size_t mmc_read_xfer(int lba, uintptr_t buf, size_t size)
 {
 	int ret;
 	unsigned int cmd_idx, cmd_arg;
 
-	assert((ops != NULL) &&
-	       (ops->read != NULL) &&
-	       (size != 0U) &&
-	       ((size & MMC_BLOCK_MASK) == 0U));
-
 	ret = ops->prepare(lba, buf, size);
 	if (ret != 0) {
 		return 0;
@@ -564,17 +722,37 @@ size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
 	return size;
 }
 
-size_t mmc_write_blocks(int lba, const uintptr_t buf, size_t size)
+size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
 {
-	int ret;
-	unsigned int cmd_idx, cmd_arg;
+	size_t max_size, xfer_size;
+	size_t done = 0U;
 
 	assert((ops != NULL) &&
-	       (ops->write != NULL) &&
+	       (ops->read != NULL) &&
 	       (size != 0U) &&
-	       ((buf & MMC_BLOCK_MASK) == 0U) &&
 	       ((size & MMC_BLOCK_MASK) == 0U));
 
+	max_size = mmc_max_xfer_size();
+
+	while (done < size) {
+		xfer_size = MIN(size - done, max_size);
+
+		if (mmc_read_xfer(lba, buf + done, xfer_size) != xfer_size) {
+			break;
+		}
+
+		lba += (int)(xfer_size / MMC_BLOCK_SIZE);
+		done += xfer_size;
+	}
+
+	return done;
+}
+
+static size_t mmc_write_xfer(int lba, const uintptr_t buf, size_t size)
+{
+	int ret;
+	unsigned int cmd_idx, cmd_arg;
+
 	ret = ops->prepare(lba, buf, size);
 	if (ret != 0) {
 		return 0;
@@ -631,6 +809,33 @@ size_t mmc_write_blocks(int lba, const uintptr_t buf, size_t size)
 	return size;
 }
 
+size_t mmc_write_blocks(int lba, const uintptr_t buf, size_t size)
+{
+	size_t max_size, xfer_size;
+	size_t done = 0U;
+
+	assert((ops != NULL) &&
+	       (ops->write != NULL) &&
+	       (size != 0U) &&
+	       ((buf & MMC_BLOCK_MASK) == 0U) &&
+	       ((size & MMC_BLOCK_MASK) == 0U));
+
+	max_size = mmc_max_xfer_size();
+
+	while (done < size) {
+		xfer_size = MIN(size - done, max_size);
+
+		if (mmc_write_xfer(lba, buf + done, xfer_size) != xfer_size) {
+			break;
+		}
+
+		lba += (int)(xfer_size / MMC_BLOCK_SIZE);
+		done += xfer_size;
+	}
+
+	return done;
+}
+
 size_t mmc_erase_blocks(int lba, size_t size)
 {
 	int ret;
@@ -710,6 +915,79 @@ size_t mmc_rpmb_erase_blocks(int lba, size_t size)
 	return size_erased;
 }
 
+/*
+ * Fill the DMA descriptor table at 'table', of 'table_size' bytes, to transfer
+ * the 'size' bytes of the buffer 'buf', and clean it to memory. The buffer is
+ * split into as many descriptors of the format 'fmt' as needed.
+ */
+int mmc_dma_desc_build(const struct mmc_dma_desc_format *fmt,
+		       uintptr_t table, size_t table_size,
+		       uintptr_t buf, size_t size)
+{
+	unsigned int i, nb_desc;
+	size_t len;
+
+	assert((fmt != NULL) && (fmt->fill != NULL) &&
+	       (fmt->desc_size != 0U) && (fmt->max_len != 0U) &&
+	       (size != 0U));
+
+	nb_desc = div_round_up(size, fmt->max_len);
+	if (nb_desc > (table_size / fmt->desc_size)) {
+		return -EINVAL;
+	}
+
+	for (i = 0U; i < nb_desc; i++) {
+		len = MIN(size, fmt->max_len);
+		fmt->fill(table, i, buf, len, i == (nb_desc - 1U));
+		buf += len;
+		size -= len;
+	}
+
+	flush_dcache_range(table, nb_desc * fmt->desc_size);
+
+	return 0;
+}
+
+static void mmc_adma2_fill(uintptr_t table, unsigned int idx, uintptr_t addr,
+			   size_t len, bool last)
+{
+	struct mmc_adma2_desc *desc = (struct mmc_adma2_desc *)table + idx;
+
+	desc->attr = (uint16_t)(MMC_ADMA2_ATTR_VALID | MMC_ADMA2_ATTR_ACT_TRAN);
+	if (last) {
+		desc->attr |= (uint16_t)MMC_ADMA2_ATTR_END;
+	}
+	/* A length of MMC_ADMA2_MAX_LEN is encoded as 0 */
+	desc->len = (uint16_t)(len & (MMC_ADMA2_MAX_LEN - 1U));
+	desc->addr = (uint32_t)addr;
+}
+
+static const struct mmc_dma_desc_format mmc_adma2_format = {
+	.desc_size	= sizeof(struct mmc_adma2_desc),
+	.max_len	= MMC_ADMA2_MAX_LEN,
+	.fill		= mmc_adma2_fill,
+};
+
+/*
+ * Fill the ADMA2 descriptor table 'desc', of 'nb_desc' entries, to transfer
+ * the 'size' bytes of the buffer 'buf', and clean it to memory. The table and
+ * the buffer must be accessible with 32-bit addresses.
+ */
+int mmc_adma2_build(struct mmc_adma2_desc *desc, unsigned int nb_desc,
+		    uintptr_t buf, size_t size)
+{
+	assert(desc != NULL);
+
+	if (((buf & 3U) != 0U) ||
+	    (((unsigned long long)buf + size) > 0x100000000ULL)) {
+		return -EINVAL;
+	}
+
+	return mmc_dma_desc_build(&mmc_adma2_format, (uintptr_t)desc,
+				  nb_desc * sizeof(struct mmc_adma2_desc),
+				  buf, size);
+}
+
 int mmc_init(const struct mmc_ops *ops_ptr, unsigned int clk,
 	     unsigned int width, unsigned int flags,
 	     struct mmc_device_info *device_info)
@@ -728,6 +1006,11 @@ int mmc_init(const struct mmc_ops *ops_ptr, unsigned int clk,
 		(width == MMC_BUS_WIDTH_8) ||
 		(width == MMC_BUS_WIDTH_DDR_4) ||
 		(width == MMC_BUS_WIDTH_DDR_8)));
+	assert(((flags & (MMC_FLAG_HS200 | MMC_FLAG_HS400)) == 0U) ||
+	       ((ops_ptr->set_timing != NULL) &&
+		(ops_ptr->execute_tuning != NULL) &&
+		((width == MMC_BUS_WIDTH_4) || (width == MMC_BUS_WIDTH_8))));
+	assert(((flags & MMC_FLAG_HS400) == 0U) || (width == MMC_BUS_WIDTH_8));
 
 	ops = ops_ptr;
 	mmc_flags = flags;
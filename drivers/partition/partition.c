@@ -5,6 +5,9 @@
  */
 
 #include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -13,11 +16,51 @@
 #include <drivers/partition/partition.h>
 #include <drivers/partition/gpt.h>
 #include <drivers/partition/mbr.h>
+#include <lib/utils.h>
+#include <lib/utils_def.h>
 #include <plat/common/platform.h>
+#include <tf_crc32.h>
+
+/*
+ * Number of entries of the GPT entry array that are read at once. With the
+ * usual 128 entries, the array is read in one go when the platform can record
+ * all of them.
+ */
+#define GPT_ENTRY_BUF_COUNT	((PLAT_PARTITION_MAX_ENTRIES > 32) ?	\
+				 PLAT_PARTITION_MAX_ENTRIES : 32)
+
+/* Size of the name index, at least twice PLAT_PARTITION_MAX_ENTRIES */
+#define NAME_INDEX_SIZE		U(256)
+
+/*
+ * Largest entry array accepted when the size of the opened region is unknown,
+ * so that a corrupted header cannot make the driver read past the usual array.
+ */
+#define GPT_MAX_LIST_NUM	U(128)
+
+/* Size of the primary GPT: protective MBR, header and 128-entry array */
+#define GPT_PRIMARY_SIZE	(GPT_ENTRY_OFFSET +			\
+				 (GPT_MAX_LIST_NUM * sizeof(gpt_entry_t)))
+
+/* Size of the part of the GPT header covered by its CRC in revision 1.0 */
+#define GPT_HEADER_MIN_SIZE	(offsetof(gpt_header_t, part_crc) +	\
+				 sizeof(uint32_t))
 
 static uint8_t mbr_sector[PARTITION_BLOCK_SIZE];
+static uint8_t gpt_header_sector[PARTITION_BLOCK_SIZE];
+static gpt_entry_t gpt_entries[GPT_ENTRY_BUF_COUNT];
 static partition_entry_list_t list;
 
+/*
+ * Open addressing hash table of the partition names. Each slot holds the
+ * index of an entry of 'list' plus one, or 0 if it is free.
+ */
+static uint8_t name_index[NAME_INDEX_SIZE];
+
+CASSERT(PLAT_PARTITION_MAX_ENTRIES < UINT8_MAX, assert_name_index_entry_size);
+CASSERT((2 * PLAT_PARTITION_MAX_ENTRIES) <= NAME_INDEX_SIZE,
+	assert_name_index_size);
+
 #if LOG_LEVEL >= LOG_LEVEL_VERBOSE
 static void dump_entries(int num)
 {
@@ -74,34 +117,71 @@ static int load_mbr_header(uintptr_t image_handle, mbr_entry_t *mbr_entry)
 }
 
 /*
- * Load GPT header and check the GPT signature.
- * If partition numbers could be found, check & update it.
+ * Load the GPT header at 'offset' and check its signature, its CRC and its
+ * location. The entry array that it describes must fit in the 'region_size'
+ * bytes of the opened region, or have at most GPT_MAX_LIST_NUM entries if the
+ * size of the region is unknown.
  */
-static int load_gpt_header(uintptr_t image_handle)
+static int load_gpt_header(uintptr_t image_handle, size_t offset,
+			   size_t region_size, gpt_header_t *header)
 {
-	gpt_header_t header;
 	size_t bytes_read;
+	unsigned long long array_end;
+	uint32_t header_crc;
 	int result;
 
-	result = io_seek(image_handle, IO_SEEK_SET, GPT_HEADER_OFFSET);
+	result = io_seek(image_handle, IO_SEEK_SET, offset);
 	if (result != 0) {
 		return result;
 	}
-	result = io_read(image_handle, (uintptr_t)&header,
-			 sizeof(gpt_header_t), &bytes_read);
-	if ((result != 0) || (sizeof(gpt_header_t) != bytes_read)) {
+	result = io_read(image_handle, (uintptr_t)&gpt_header_sector,
+			 PARTITION_BLOCK_SIZE, &bytes_read);
+	if (result != 0) {
 		return result;
 	}
-	if (memcmp(header.signature, GPT_SIGNATURE,
-		   sizeof(header.signature)) != 0) {
+	if (bytes_read != PARTITION_BLOCK_SIZE) {
+		return -EIO;
+	}
+
+	memcpy(header, gpt_header_sector, sizeof(gpt_header_t));
+	if (memcmp(header->signature, GPT_SIGNATURE,
+		   sizeof(header->signature)) != 0) {
+		return -EINVAL;
+	}
+	if ((header->size < GPT_HEADER_MIN_SIZE) ||
+	    (header->size > PARTITION_BLOCK_SIZE)) {
+		return -EINVAL;
+	}
+
+	/* The CRC of the header is computed with its CRC field set to 0 */
+	header_crc = header->header_crc;
+	zeromem(&gpt_header_sector[offsetof(gpt_header_t, header_crc)],
+		sizeof(header_crc));
+	if (tf_crc32(0U, gpt_header_sector, header->size) != header_crc) {
+		WARN("GPT header at 0x%zx has a wrong CRC\n", offset);
+		return -EINVAL;
+	}
+
+	if ((header->current_lba * PARTITION_BLOCK_SIZE) != offset) {
+		return -EINVAL;
+	}
+
+	/* Only the entry size of revision 1.0 is supported */
+	if ((header->part_size != sizeof(gpt_entry_t)) ||
+	    (header->list_num == 0U)) {
 		return -EINVAL;
 	}
 
-	/* partition numbers can't exceed PLAT_PARTITION_MAX_ENTRIES */
-	list.entry_count = header.list_num;
-	if (list.entry_count > PLAT_PARTITION_MAX_ENTRIES) {
-		list.entry_count = PLAT_PARTITION_MAX_ENTRIES;
+	if (region_size == 0U) {
+		return (header->list_num > GPT_MAX_LIST_NUM) ? -EINVAL : 0;
+	}
+
+	array_end = (header->part_lba * PARTITION_BLOCK_SIZE) +
+		    ((unsigned long long)header->list_num * header->part_size);
+	if (array_end > region_size) {
+		return -EINVAL;
 	}
+
 	return 0;
 }
 
@@ -156,45 +236,159 @@ static int load_mbr_entries(uintptr_t image_handle)
 	return 0;
 }
 
-static int load_gpt_entry(uintptr_t image_handle, gpt_entry_t *entry)
+/*
+ * Read the whole GPT entry array described by 'header', in as few reads as the
+ * buffer allows, and check its CRC. The valid entries up to the first unused
+ * one are recorded in the partition list.
+ */
+static int load_gpt_entries(uintptr_t image_handle, const gpt_header_t *header)
 {
-	size_t bytes_read;
+	size_t entries_left = header->list_num;
+	size_t nb_entries, bytes_read, i;
+	uint32_t crc = 0U;
+	bool parsing = true;
+	int count = 0;
 	int result;
 
-	assert(entry != NULL);
-	result = io_read(image_handle, (uintptr_t)entry, sizeof(gpt_entry_t),
-			 &bytes_read);
-	if (sizeof(gpt_entry_t) != bytes_read)
-		return -EINVAL;
-	return result;
-}
+	result = io_seek(image_handle, IO_SEEK_SET,
+			 header->part_lba * PARTITION_BLOCK_SIZE);
+	if (result != 0) {
+		return result;
+	}
 
-static int verify_partition_gpt(uintptr_t image_handle)
-{
-	gpt_entry_t entry;
-	int result, i;
+	while (entries_left != 0U) {
+		nb_entries = MIN(entries_left, (size_t)GPT_ENTRY_BUF_COUNT);
 
-	for (i = 0; i < list.entry_count; i++) {
-		result = load_gpt_entry(image_handle, &entry);
-		assert(result == 0);
-		result = parse_gpt_entry(&entry, &list.list[i]);
+		result = io_read(image_handle, (uintptr_t)&gpt_entries,
+				 nb_entries * sizeof(gpt_entry_t), &bytes_read);
 		if (result != 0) {
-			break;
+			return result;
 		}
+		if (bytes_read != (nb_entries * sizeof(gpt_entry_t))) {
+			return -EIO;
+		}
+
+		crc = tf_crc32(crc, (const unsigned char *)gpt_entries,
+			       bytes_read);
+
+		for (i = 0U; parsing && (i < nb_entries); i++) {
+			if ((count == PLAT_PARTITION_MAX_ENTRIES) ||
+			    (parse_gpt_entry(&gpt_entries[i],
+					     &list.list[count]) != 0)) {
+				parsing = false;
+			} else {
+				count++;
+			}
+		}
+
+		entries_left -= nb_entries;
 	}
-	if (i == 0) {
+
+	if (crc != header->part_crc) {
+		WARN("GPT entry array has a wrong CRC\n");
 		return -EINVAL;
 	}
+	if (count == 0) {
+		return -EINVAL;
+	}
+
 	/*
 	 * Only records the valid partition number that is loaded from
 	 * partition table.
 	 */
-	list.entry_count = i;
+	list.entry_count = count;
 	dump_entries(list.entry_count);
 
 	return 0;
 }
 
+/*
+ * Load the primary GPT, or the backup GPT if the primary one is corrupted.
+ *
+ * The size of the opened region bounds all the accesses. The backup GPT can
+ * only be used if it lies in the region, which is the case when the platform
+ * opens the whole device rather than the primary GPT only.
+ */
+static int load_gpt(uintptr_t image_handle)
+{
+	gpt_header_t header;
+	size_t region_size;
+	size_t backup_offset = 0U;
+	int result;
+
+	if (io_size(image_handle, &region_size) != 0) {
+		region_size = 0U;
+	}
+
+	result = load_gpt_header(image_handle, GPT_HEADER_OFFSET, region_size,
+				 &header);
+	if (result == 0) {
+		result = load_gpt_entries(image_handle, &header);
+		if (result == 0) {
+			return 0;
+		}
+
+		if (header.backup_lba < (region_size / PARTITION_BLOCK_SIZE)) {
+			backup_offset = header.backup_lba *
+					PARTITION_BLOCK_SIZE;
+		}
+	} else if (region_size > GPT_PRIMARY_SIZE) {
+		/*
+		 * The region goes beyond the primary GPT, so it is taken to be
+		 * the whole device: the backup header is in its last block.
+		 * The location recorded in that header is checked as well.
+		 */
+		backup_offset = round_down(region_size, PARTITION_BLOCK_SIZE) -
+				PARTITION_BLOCK_SIZE;
+	}
+
+	if (backup_offset <= GPT_HEADER_OFFSET) {
+		return result;
+	}
+
+	WARN("Primary GPT is corrupted, using the backup GPT\n");
+
+	result = load_gpt_header(image_handle, backup_offset, region_size,
+				 &header);
+	if (result != 0) {
+		return result;
+	}
+
+	return load_gpt_entries(image_handle, &header);
+}
+
+static unsigned int name_hash(const char *name)
+{
+	unsigned int hash = 5381U;
+
+	while (*name != '\0') {
+		hash = (hash * 33U) ^ (unsigned char)*name;
+		name++;
+	}
+
+	return hash & (NAME_INDEX_SIZE - 1U);
+}
+
+/*
+ * Index the entries of the partition list by name. Entries with the same name
+ * are probed in the order of the list, so that lookups return the first one.
+ */
+static void build_name_index(void)
+{
+	unsigned int slot;
+	int i;
+
+	zeromem(name_index, sizeof(name_index));
+
+	for (i = 0; i < list.entry_count; i++) {
+		slot = name_hash(list.list[i].name);
+		while (name_index[slot] != 0U) {
+			slot = (slot + 1U) & (NAME_INDEX_SIZE - 1U);
+		}
+		name_index[slot] = (uint8_t)(i + 1);
+	}
+}
+
 int load_partition_table(unsigned int image_id)
 {
 	uintptr_t dev_handle, image_handle, image_spec = 0;
@@ -219,28 +413,34 @@ int load_partition_table(unsigned int image_id)
 		WARN("Failed to access image id=%u (%i)\n", image_id, result);
 		return result;
 	}
+	list.entry_count = 0;
+
 	if (mbr_entry.type == PARTITION_TYPE_GPT) {
-		result = load_gpt_header(image_handle);
-		assert(result == 0);
-		result = io_seek(image_handle, IO_SEEK_SET, GPT_ENTRY_OFFSET);
-		assert(result == 0);
-		result = verify_partition_gpt(image_handle);
+		result = load_gpt(image_handle);
+		if (result != 0) {
+			WARN("Failed to load the GPT (%i)\n", result);
+		}
 	} else {
 		result = load_mbr_entries(image_handle);
 	}
 
+	build_name_index();
+
 	io_close(image_handle);
 	return result;
 }
 
 const partition_entry_t *get_partition_entry(const char *name)
 {
-	int i;
+	unsigned int slot = name_hash(name);
+	const partition_entry_t *entry;
 
-	for (i = 0; i < list.entry_count; i++) {
-		if (strcmp(name, list.list[i].name) == 0) {
-			return &list.list[i];
+	while (name_index[slot] != 0U) {
+		entry = &list.list[name_index[slot] - 1U];
+		if (strcmp(name, entry->name) == 0) {
+			return entry;
 		}
+		slot = (slot + 1U) & (NAME_INDEX_SIZE - 1U);
 	}
 	return NULL;
 }
@@ -125,6 +125,7 @@ static int dw_set_ios(unsigned int clk, unsigned int width);
 static int dw_prepare(int lba, uintptr_t buf, size_t size);
 static int dw_read(int lba, uintptr_t buf, size_t size);
 static int dw_write(int lba, uintptr_t buf, size_t size);
+static size_t dw_max_xfer_size(void);
 
 static const struct mmc_ops dw_mmc_ops = {
 	.init		= dw_init,
@@ -133,6 +134,7 @@ static const struct mmc_ops dw_mmc_ops = {
 	.prepare	= dw_prepare,
 	.read		= dw_read,
 	.write		= dw_write,
+	.max_xfer_size	= dw_max_xfer_size,
 };
 
 static dw_mmc_params_t dw_params;
@@ -338,11 +340,42 @@ static int dw_set_ios(unsigned int clk, unsigned int width)
 	return 0;
 }
 
+static void dw_fill_desc(uintptr_t table, unsigned int idx, uintptr_t addr,
+			 size_t len, bool last)
+{
+	struct dw_idmac_desc *desc = (struct dw_idmac_desc *)table + idx;
+
+	desc->des0 = IDMAC_DES0_OWN;
+	if (idx == 0U)
+		desc->des0 |= IDMAC_DES0_FS;
+	if (last) {
+		desc->des0 |= IDMAC_DES0_LD;
+		/* set next descriptor address as 0 */
+		desc->des3 = 0;
+	} else {
+		desc->des0 |= IDMAC_DES0_CH | IDMAC_DES0_DIC;
+		desc->des3 = table + (sizeof(struct dw_idmac_desc)) * (idx + 1);
+	}
+	desc->des1 = IDMAC_DES1_BS1(len);
+	desc->des2 = addr;
+}
+
+static const struct mmc_dma_desc_format dw_desc_format = {
+	.desc_size	= sizeof(struct dw_idmac_desc),
+	.max_len	= DWMMC_DMA_MAX_BUFFER_SIZE,
+	.fill		= dw_fill_desc,
+};
+
+static size_t dw_max_xfer_size(void)
+{
+	return (dw_params.desc_size / sizeof(struct dw_idmac_desc)) *
+	       DWMMC_DMA_MAX_BUFFER_SIZE;
+}
+
 static int dw_prepare(int lba, uintptr_t buf, size_t size)
 {
-	struct dw_idmac_desc *desc;
-	int desc_cnt, i, last;
 	uintptr_t base;
+	int ret;
 
 	assert(((buf & DWMMC_ADDRESS_MASK) == 0) &&
 	       (dw_params.desc_size > 0) &&
@@ -352,12 +385,12 @@ static int dw_prepare(int lba, uintptr_t buf, size_t size)
 
 	flush_dcache_range(buf, size);
 
-	desc_cnt = (size + DWMMC_DMA_MAX_BUFFER_SIZE - 1) /
-		   DWMMC_DMA_MAX_BUFFER_SIZE;
-	assert(desc_cnt * sizeof(struct dw_idmac_desc) < dw_params.desc_size);
+	ret = mmc_dma_desc_build(&dw_desc_format, dw_params.desc_base,
+				 dw_params.desc_size, buf, size);
+	if (ret != 0)
+		return ret;
 
 	base = dw_params.reg_base;
-	desc = (struct dw_idmac_desc *)dw_params.desc_base;
 	mmio_write_32(base + DWMMC_BYTCNT, size);
 
 	if (size < MMC_BLOCK_SIZE)
@@ -366,28 +399,7 @@ static int dw_prepare(int lba, uintptr_t buf, size_t size)
 		mmio_write_32(base + DWMMC_BLKSIZ, MMC_BLOCK_SIZE);
 
 	mmio_write_32(base + DWMMC_RINTSTS, ~0);
-	for (i = 0; i < desc_cnt; i++) {
-		desc[i].des0 = IDMAC_DES0_OWN | IDMAC_DES0_CH | IDMAC_DES0_DIC;
-		desc[i].des1 = IDMAC_DES1_BS1(DWMMC_DMA_MAX_BUFFER_SIZE);
-		desc[i].des2 = buf + DWMMC_DMA_MAX_BUFFER_SIZE * i;
-		desc[i].des3 = dw_params.desc_base +
-			       (sizeof(struct dw_idmac_desc)) * (i + 1);
-	}
-	/* first descriptor */
-	desc->des0 |= IDMAC_DES0_FS;
-	/* last descriptor */
-	last = desc_cnt - 1;
-	(desc + last)->des0 |= IDMAC_DES0_LD;
-	(desc + last)->des0 &= ~(IDMAC_DES0_DIC | IDMAC_DES0_CH);
-	(desc + last)->des1 = IDMAC_DES1_BS1(size - (last *
-				  DWMMC_DMA_MAX_BUFFER_SIZE));
-	/* set next descriptor address as 0 */
-	(desc + last)->des3 = 0;
-
 	mmio_write_32(base + DWMMC_DBADDR, dw_params.desc_base);
-	flush_dcache_range(dw_params.desc_base,
-			   desc_cnt * DWMMC_DMA_MAX_BUFFER_SIZE);
-
 
 	return 0;
 }
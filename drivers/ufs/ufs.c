@@ -25,11 +25,46 @@
 #define UFS_DESC_SIZE			0x400
 #define MAX_UFS_DESC_SIZE		0x8000		/* 32 descriptors */
 
+/*
+ * The descriptor memory holds the UTP Transfer Request List, followed by the
+ * UTP Command Descriptor of each slot.
+ */
+#define UFS_MIN_DESC_SIZE		(2 * UFS_DESC_SIZE)
+#define UFS_MAX_SLOTS			(CAP_NUTRS_MASK + 1)
+
+/*
+ * Only the slots whose UTRD starts a cache line are used, so that the
+ * maintenance of the UTRD of a slot doesn't corrupt the UTRD of another slot
+ * that the host controller is updating.
+ */
+#if CACHE_WRITEBACK_GRANULE > UTP_TRD_SIZE
+#define UFS_SLOT_STRIDE		(CACHE_WRITEBACK_GRANULE / UTP_TRD_SIZE)
+#else
+#define UFS_SLOT_STRIDE			1
+#endif
+
 #define MAX_PRDT_SIZE			0x40000		/* 256KB */
 
+/* Size of the commands that the queued transfers are split into */
+#define UFS_QUEUE_CMD_SIZE		MAX_PRDT_SIZE
+
+/*
+ * A queued transfer fails if none of its commands completes for this long.
+ * ufs_queue_poll() waits UFS_QUEUE_POLL_US when it finds no progress.
+ */
+#define UFS_QUEUE_TIMEOUT_US		1000000
+#define UFS_QUEUE_POLL_US		10
+
+#define UFS_INT_ERR			(UFS_INT_UTPES | UFS_INT_DFES |	\
+					 UFS_INT_HCFES | UFS_INT_SBFES)
+
 static ufs_params_t ufs_params;
 static int nutrs;	/* Number of UTP Transfer Request Slots */
 
+/* Slots owned by queued transfers and length of their commands */
+static unsigned int ufs_queued_slots;
+static size_t ufs_slot_length[UFS_MAX_SLOTS];
+
 int ufshc_send_uic_cmd(uintptr_t base, uic_cmd_t *cmd)
 {
 	unsigned int data;
@@ -158,11 +193,10 @@ static int get_empty_slot(int *slot)
 	unsigned int data;
 	int i;
 
-	data = mmio_read_32(ufs_params.reg_base + UTRLDBR);
-	for (i = 0; i < nutrs; i++) {
-		if ((data & 1) == 0)
+	data = mmio_read_32(ufs_params.reg_base + UTRLDBR) | ufs_queued_slots;
+	for (i = 0; i < nutrs; i += UFS_SLOT_STRIDE) {
+		if ((data & (1U << i)) == 0)
 			break;
-		data = data >> 1;
 	}
 	if (i >= nutrs)
 		return -EBUSY;
@@ -170,30 +204,30 @@ static int get_empty_slot(int *slot)
 	return 0;
 }
 
-static void get_utrd(utp_utrd_t *utrd)
+/* Get the addresses of the UTRD and the UTP Command Descriptor of a slot */
+static void get_slot_utrd(int slot, utp_utrd_t *utrd)
 {
-	uintptr_t base;
-	int slot = 0, result;
-	utrd_header_t *hd;
-
-	assert(utrd != NULL);
-	result = get_empty_slot(&slot);
-	assert(result == 0);
-
 	/* clear utrd */
 	memset((void *)utrd, 0, sizeof(utp_utrd_t));
-	base = ufs_params.desc_base + (slot * UFS_DESC_SIZE);
-	/* clear the descriptor */
-	memset((void *)base, 0, UFS_DESC_SIZE);
 
-	utrd->header = base;
+	utrd->header = ufs_params.desc_base + (slot * UTP_TRD_SIZE);
 	utrd->task_tag = slot + 1;
 	/* CDB address should be aligned with 128 bytes */
-	utrd->upiu = ALIGN_CDB(utrd->header + sizeof(utrd_header_t));
+	utrd->upiu = ufs_params.desc_base + ((slot + 1) * UFS_DESC_SIZE);
 	utrd->resp_upiu = ALIGN_8(utrd->upiu + sizeof(cmd_upiu_t));
 	utrd->size_upiu = utrd->resp_upiu - utrd->upiu;
 	utrd->size_resp_upiu = ALIGN_8(sizeof(resp_upiu_t));
 	utrd->prdt = utrd->resp_upiu + utrd->size_resp_upiu;
+}
+
+static void setup_utrd(int slot, utp_utrd_t *utrd)
+{
+	utrd_header_t *hd;
+
+	get_slot_utrd(slot, utrd);
+	/* clear the descriptors */
+	memset((void *)utrd->header, 0, UTP_TRD_SIZE);
+	memset((void *)utrd->upiu, 0, UFS_DESC_SIZE);
 
 	hd = (utrd_header_t *)utrd->header;
 	hd->ucdba = utrd->upiu & UINT32_MAX;
@@ -201,9 +235,32 @@ static void get_utrd(utp_utrd_t *utrd)
 	/* Both RUL and RUO is based on DWORD */
 	hd->rul = utrd->size_resp_upiu >> 2;
 	hd->ruo = utrd->size_upiu >> 2;
+}
+
+static void get_utrd(utp_utrd_t *utrd)
+{
+	int slot = 0, result;
+
+	assert(utrd != NULL);
+	result = get_empty_slot(&slot);
+	assert(result == 0);
+
+	setup_utrd(slot, utrd);
 	(void)result;
 }
 
+static void flush_utrd(utp_utrd_t *utrd)
+{
+	flush_dcache_range((uintptr_t)utrd->header, UTP_TRD_SIZE);
+	flush_dcache_range((uintptr_t)utrd->upiu, UFS_DESC_SIZE);
+}
+
+static void inv_utrd(utp_utrd_t *utrd)
+{
+	inv_dcache_range((uintptr_t)utrd->header, UTP_TRD_SIZE);
+	inv_dcache_range((uintptr_t)utrd->upiu, UFS_DESC_SIZE);
+}
+
 /*
  * Prepare UTRD, Command UPIU, Response UPIU.
  */
@@ -217,12 +274,6 @@ static int ufs_prepare_cmd(utp_utrd_t *utrd, uint8_t op, uint8_t lun,
 	unsigned int lba_cnt;
 	int prdt_size;
 
-
-	mmio_write_32(ufs_params.reg_base + UTRLBA,
-		      utrd->header & UINT32_MAX);
-	mmio_write_32(ufs_params.reg_base + UTRLBAU,
-		      (utrd->upiu >> 32) & UINT32_MAX);
-
 	hd = (utrd_header_t *)utrd->header;
 	upiu = (cmd_upiu_t *)utrd->upiu;
 
@@ -306,7 +357,7 @@ static int ufs_prepare_cmd(utp_utrd_t *utrd, uint8_t op, uint8_t lun,
 	}
 
 	flush_dcache_range((uintptr_t)utrd, sizeof(utp_utrd_t));
-	flush_dcache_range((uintptr_t)utrd->header, UFS_DESC_SIZE);
+	flush_utrd(utrd);
 	return 0;
 }
 
@@ -317,16 +368,9 @@ static int ufs_prepare_query(utp_utrd_t *utrd, uint8_t op, uint8_t idn,
 	utrd_header_t *hd;
 	query_upiu_t *query_upiu;
 
-
 	hd = (utrd_header_t *)utrd->header;
 	query_upiu = (query_upiu_t *)utrd->upiu;
 
-	mmio_write_32(ufs_params.reg_base + UTRLBA,
-		      utrd->header & UINT32_MAX);
-	mmio_write_32(ufs_params.reg_base + UTRLBAU,
-		      (utrd->header >> 32) & UINT32_MAX);
-
-
 	hd->i = 1;
 	hd->ct = CT_UFS_STORAGE;
 	hd->ocs = OCS_MASK;
@@ -365,7 +409,7 @@ static int ufs_prepare_query(utp_utrd_t *utrd, uint8_t op, uint8_t idn,
 		break;
 	}
 	flush_dcache_range((uintptr_t)utrd, sizeof(utp_utrd_t));
-	flush_dcache_range((uintptr_t)utrd->header, UFS_DESC_SIZE);
+	flush_utrd(utrd);
 	return 0;
 }
 
@@ -374,11 +418,6 @@ static void ufs_prepare_nop_out(utp_utrd_t *utrd)
 	utrd_header_t *hd;
 	nop_out_upiu_t *nop_out;
 
-	mmio_write_32(ufs_params.reg_base + UTRLBA,
-		      utrd->header & UINT32_MAX);
-	mmio_write_32(ufs_params.reg_base + UTRLBAU,
-		      (utrd->header >> 32) & UINT32_MAX);
-
 	hd = (utrd_header_t *)utrd->header;
 	nop_out = (nop_out_upiu_t *)utrd->upiu;
 
@@ -389,17 +428,23 @@ static void ufs_prepare_nop_out(utp_utrd_t *utrd)
 	nop_out->trans_type = 0;
 	nop_out->task_tag = utrd->task_tag;
 	flush_dcache_range((uintptr_t)utrd, sizeof(utp_utrd_t));
-	flush_dcache_range((uintptr_t)utrd->header, UFS_DESC_SIZE);
+	flush_utrd(utrd);
 }
 
-static void ufs_send_request(int task_tag)
+/* Ring the doorbell of the given slots */
+static void ufs_send_requests(unsigned int slots)
 {
 	unsigned int data;
-	int slot;
 
-	slot = task_tag - 1;
-	/* clear all interrupts */
-	mmio_write_32(ufs_params.reg_base + IS, ~0);
+	/*
+	 * Clear the interrupts raised so far. The errors are left for
+	 * ufs_queue_poll() if other commands are outstanding, since they may
+	 * be theirs.
+	 */
+	data = mmio_read_32(ufs_params.reg_base + IS);
+	if ((ufs_queued_slots & ~slots) != 0)
+		data &= ~UFS_INT_ERR;
+	mmio_write_32(ufs_params.reg_base + IS, data);
 
 	mmio_write_32(ufs_params.reg_base + UTRLRSR, 1);
 	do {
@@ -410,7 +455,12 @@ static void ufs_send_request(int task_tag)
 	       UTRIACR_IATOVAL(0xFF);
 	mmio_write_32(ufs_params.reg_base + UTRIACR, data);
 	/* send request */
-	mmio_setbits_32(ufs_params.reg_base + UTRLDBR, 1 << slot);
+	mmio_setbits_32(ufs_params.reg_base + UTRLDBR, slots);
+}
+
+static void ufs_send_request(int task_tag)
+{
+	ufs_send_requests(1U << (task_tag - 1));
 }
 
 static int ufs_check_resp(utp_utrd_t *utrd, int trans_type)
@@ -422,7 +472,7 @@ static int ufs_check_resp(utp_utrd_t *utrd, int trans_type)
 
 	hd = (utrd_header_t *)utrd->header;
 	resp = (resp_upiu_t *)utrd->resp_upiu;
-	inv_dcache_range((uintptr_t)hd, UFS_DESC_SIZE);
+	inv_utrd(utrd);
 	inv_dcache_range((uintptr_t)utrd, sizeof(utp_utrd_t));
 	do {
 		data = mmio_read_32(ufs_params.reg_base + IS);
@@ -603,7 +653,7 @@ static void ufs_read_capacity(int lun, unsigned int *num, unsigned int *size)
 
 	assert((ufs_params.reg_base != 0) &&
 	       (ufs_params.desc_base != 0) &&
-	       (ufs_params.desc_size >= UFS_DESC_SIZE) &&
+	       (ufs_params.desc_size >= UFS_MIN_DESC_SIZE) &&
 	       (num != NULL) && (size != NULL));
 
 	/* align buf address */
@@ -642,28 +692,167 @@ static void ufs_read_capacity(int lun, unsigned int *num, unsigned int *size)
 	(void)result;
 }
 
-size_t ufs_read_blocks(int lun, int lba, uintptr_t buf, size_t size)
+/*
+ * Prepare the commands of a queued transfer for the free slots and ring the
+ * doorbell for all of them at once.
+ */
+static void ufs_queue_issue(ufs_xfer_t *xfer)
 {
 	utp_utrd_t utrd;
+	unsigned int slots = 0;
+	size_t length;
+	int slot;
+
+	while ((xfer->left > 0) && (get_empty_slot(&slot) == 0)) {
+		length = xfer->left;
+		if (length > UFS_QUEUE_CMD_SIZE)
+			length = UFS_QUEUE_CMD_SIZE;
+
+		setup_utrd(slot, &utrd);
+		ufs_prepare_cmd(&utrd, CDBCMD_READ_10, xfer->lun, xfer->lba,
+				xfer->buf, length);
+		ufs_slot_length[slot] = length;
+		ufs_queued_slots |= 1U << slot;
+		slots |= 1U << slot;
+
+		xfer->lba += length >> UFS_BLOCK_SHIFT;
+		xfer->buf += length;
+		xfer->left -= length;
+	}
+
+	if (slots != 0) {
+		xfer->pending |= slots;
+		ufs_send_requests(slots);
+	}
+}
+
+/* Check the response of a completed command and release its slot */
+static void ufs_queue_reap(ufs_xfer_t *xfer, int slot)
+{
+	utp_utrd_t utrd;
+	utrd_header_t *hd;
 	resp_upiu_t *resp;
+
+	get_slot_utrd(slot, &utrd);
+	inv_utrd(&utrd);
+	hd = (utrd_header_t *)utrd.header;
+	resp = (resp_upiu_t *)utrd.resp_upiu;
+#ifdef UFS_RESP_DEBUG
+	dump_upiu(&utrd);
+#endif
+
+	if ((hd->ocs != OCS_SUCCESS) ||
+	    ((resp->trans_type & TRANS_TYPE_CODE_MASK) != RESPONSE_UPIU) ||
+	    (resp->status != 0)) {
+		ERROR("UFS: command in slot %d failed (ocs 0x%x, status 0x%x)\n",
+		      slot, hd->ocs, resp->status);
+		xfer->error = -EIO;
+	} else {
+		xfer->done += ufs_slot_length[slot] -
+			      be32toh(resp->res_trans_cnt);
+	}
+
+	xfer->pending &= ~(1U << slot);
+	ufs_queued_slots &= ~(1U << slot);
+}
+
+int ufs_queue_read(int lun, int lba, uintptr_t buf, size_t size,
+		   ufs_xfer_t *xfer)
+{
+	assert((ufs_params.reg_base != 0) &&
+	       (ufs_params.desc_base != 0) &&
+	       (ufs_params.desc_size >= UFS_MIN_DESC_SIZE) &&
+	       (xfer != NULL));
+
+	if ((size & UFS_BLOCK_MASK) != 0)
+		return -EINVAL;
+
+	memset(xfer, 0, sizeof(ufs_xfer_t));
+	xfer->lun = lun;
+	xfer->lba = lba;
+	xfer->buf = buf;
+	xfer->left = size;
+
+	ufs_queue_issue(xfer);
+	return 0;
+}
+
+/* Abort the outstanding commands of a queued transfer */
+static int ufs_queue_abort(ufs_xfer_t *xfer, int error)
+{
+	mmio_write_32(ufs_params.reg_base + UTRLCLR, ~xfer->pending);
+	ufs_queued_slots &= ~xfer->pending;
+	xfer->pending = 0;
+	xfer->left = 0;
+	xfer->error = error;
+	return error;
+}
+
+int ufs_queue_poll(ufs_xfer_t *xfer)
+{
+	unsigned int data, done;
+	int slot;
+
+	assert(xfer != NULL);
+
+	data = mmio_read_32(ufs_params.reg_base + IS);
+	if ((data & UFS_INT_ERR) != 0) {
+		ERROR("UFS: transfer error (IS 0x%x)\n", data);
+		mmio_write_32(ufs_params.reg_base + IS, data & UFS_INT_ERR);
+		return ufs_queue_abort(xfer, -EIO);
+	}
+
+	/* The doorbell of a slot is cleared when its command completes */
+	done = xfer->pending & ~mmio_read_32(ufs_params.reg_base + UTRLDBR);
+	if (done != 0) {
+		xfer->idle_us = 0;
+	} else if (xfer->pending != 0) {
+		if (xfer->idle_us >= UFS_QUEUE_TIMEOUT_US) {
+			ERROR("UFS: transfer timed out (slots 0x%x)\n",
+			      xfer->pending);
+			return ufs_queue_abort(xfer, -ETIMEDOUT);
+		}
+		udelay(UFS_QUEUE_POLL_US);
+		xfer->idle_us += UFS_QUEUE_POLL_US;
+	}
+
+	for (slot = 0; done != 0; slot++, done >>= 1) {
+		if ((done & 1) != 0)
+			ufs_queue_reap(xfer, slot);
+	}
+
+	/* Stop issuing commands once one of them failed */
+	if (xfer->error != 0)
+		xfer->left = 0;
+	else
+		ufs_queue_issue(xfer);
+
+	if (xfer->pending != 0)
+		return -EAGAIN;
+
+	return xfer->error;
+}
+
+size_t ufs_read_blocks(int lun, int lba, uintptr_t buf, size_t size)
+{
+	ufs_xfer_t xfer;
 	int result;
 
 	assert((ufs_params.reg_base != 0) &&
 	       (ufs_params.desc_base != 0) &&
-	       (ufs_params.desc_size >= UFS_DESC_SIZE));
+	       (ufs_params.desc_size >= UFS_MIN_DESC_SIZE));
 
 	memset((void *)buf, 0, size);
-	get_utrd(&utrd);
-	ufs_prepare_cmd(&utrd, CDBCMD_READ_10, lun, lba, buf, size);
-	ufs_send_request(utrd.task_tag);
-	result = ufs_check_resp(&utrd, RESPONSE_UPIU);
+	result = ufs_queue_read(lun, lba, buf, size, &xfer);
+	if (result != 0)
+		return 0;
+
+	do {
+		result = ufs_queue_poll(&xfer);
+	} while (result == -EAGAIN);
 	assert(result == 0);
-#ifdef UFS_RESP_DEBUG
-	dump_upiu(&utrd);
-#endif
-	resp = (resp_upiu_t *)utrd.resp_upiu;
 	(void)result;
-	return size - resp->res_trans_cnt;
+	return xfer.done;
 }
 
 size_t ufs_write_blocks(int lun, int lba, const uintptr_t buf, size_t size)
@@ -674,7 +863,7 @@ size_t ufs_write_blocks(int lun, int lba, const uintptr_t buf, size_t size)
 
 	assert((ufs_params.reg_base != 0) &&
 	       (ufs_params.desc_base != 0) &&
-	       (ufs_params.desc_size >= UFS_DESC_SIZE));
+	       (ufs_params.desc_size >= UFS_MIN_DESC_SIZE));
 
 	memset((void *)buf, 0, size);
 	get_utrd(&utrd);
@@ -690,15 +879,38 @@ size_t ufs_write_blocks(int lun, int lba, const uintptr_t buf, size_t size)
 	return size - resp->res_trans_cnt;
 }
 
+/*
+ * The UTP Transfer Request List is at the start of the descriptor memory, with
+ * as many slots as there is room for their UTP Command Descriptor.
+ */
+static void ufs_init_utrl(void)
+{
+	/* 0 means 1 slot */
+	nutrs = (mmio_read_32(ufs_params.reg_base + CAP) & CAP_NUTRS_MASK) + 1;
+	if (nutrs > ((ufs_params.desc_size / UFS_DESC_SIZE) - 1))
+		nutrs = (ufs_params.desc_size / UFS_DESC_SIZE) - 1;
+	ufs_queued_slots = 0;
+}
+
+/*
+ * Program the base of the UTP Transfer Request List. Enabling the host
+ * controller resets its registers, so this must be done after ufshc_reset()
+ * and the link startup, and before the first doorbell.
+ */
+static void ufs_set_utrl_base(void)
+{
+	mmio_write_32(ufs_params.reg_base + UTRLBA,
+		      ufs_params.desc_base & UINT32_MAX);
+	mmio_write_32(ufs_params.reg_base + UTRLBAU,
+		      (ufs_params.desc_base >> 32) & UINT32_MAX);
+}
+
 static void ufs_enum(void)
 {
 	unsigned int blk_num, blk_size;
 	int i;
 
-	/* 0 means 1 slot */
-	nutrs = (mmio_read_32(ufs_params.reg_base + CAP) & CAP_NUTRS_MASK) + 1;
-	if (nutrs > (ufs_params.desc_size / UFS_DESC_SIZE))
-		nutrs = ufs_params.desc_size / UFS_DESC_SIZE;
+	ufs_set_utrl_base();
 
 	ufs_verify_init();
 	ufs_verify_ready();
@@ -740,9 +952,11 @@ int ufs_init(const ufs_ops_t *ops, ufs_params_t *params)
 	assert((params != NULL) &&
 	       (params->reg_base != 0) &&
 	       (params->desc_base != 0) &&
-	       (params->desc_size >= UFS_DESC_SIZE));
+	       (params->desc_size >= UFS_MIN_DESC_SIZE) &&
+	       ((params->desc_base & (UFS_DESC_SIZE - 1)) == 0));
 
 	memcpy(&ufs_params, params, sizeof(ufs_params_t));
+	ufs_init_utrl();
 
 	if (ufs_params.flags & UFS_FLAGS_SKIPINIT) {
 		result = ufshc_dme_get(0x1571, 0, &data);
@@ -768,6 +982,8 @@ int ufs_init(const ufs_ops_t *ops, ufs_params_t *params)
 		result = ufshc_dme_get(0x1568, 0, &data);
 		assert(result == 0);
 		assert((data > 0) && (data <= 3));
+
+		ufs_set_utrl_base();
 	} else {
 		assert((ops != NULL) && (ops->phy_init != NULL) &&
 		       (ops->phy_set_pwr_mode != NULL));
@@ -160,6 +160,12 @@
 #define ID_AA64PFR0_GIC_WIDTH	U(4)
 #define ID_AA64PFR0_GIC_MASK	ULL(0xf)
 
+/* ID_AA64ISAR0_EL1 definitions */
+#define ID_AA64ISAR0_TLB_SHIFT	U(56)
+#define ID_AA64ISAR0_TLB_WIDTH	U(4)
+#define ID_AA64ISAR0_TLB_MASK	ULL(0xf)
+#define ID_AA64ISAR0_TLB_RANGE	ULL(0x2)
+
 /* ID_AA64ISAR1_EL1 definitions */
 #define ID_AA64ISAR1_EL1	S3_0_C0_C6_1
 #define ID_AA64ISAR1_GPI_SHIFT	U(28)
@@ -223,6 +229,11 @@
 #define GET_VIRT_EXT(id)	(((id) >> ID_PFR1_VIRTEXT_SHIFT) \
 				 & ID_PFR1_VIRTEXT_MASK)
 
+/* DCZID_EL0 definitions */
+#define DCZID_BS_SHIFT		U(0)
+#define DCZID_BS_MASK		U(0xf)
+#define DCZID_DZP_BIT		(U(1) << 4)
+
 /* SCTLR definitions */
 #define SCTLR_EL2_RES1	((U(1) << 29) | (U(1) << 28) | (U(1) << 23) | \
 			 (U(1) << 22) | (U(1) << 18) | (U(1) << 16) | \
@@ -623,6 +634,15 @@
 #define TLBI_ADDR_MASK		ULL(0x00000FFFFFFFFFFF)
 #define TLBI_ADDR(x)		(((x) >> TLBI_ADDR_SHIFT) & TLBI_ADDR_MASK)
 
+/* Operand of the TLBI range instructions (ARMv8.4-TLBI) */
+#define TLBI_RANGE_TG_SHIFT	U(46)
+#define TLBI_RANGE_TG_4KB	ULL(0x1)
+#define TLBI_RANGE_SCALE_SHIFT	U(44)
+#define TLBI_RANGE_SCALE_MAX	U(3)
+#define TLBI_RANGE_NUM_SHIFT	U(39)
+#define TLBI_RANGE_NUM_MAX	U(31)
+#define TLBI_RANGE_BADDR_MASK	ULL(0x1FFFFFFFFF)
+
 /*******************************************************************************
  * Definitions of register offsets and fields in the CNTCTLBase Frame of the
  * system level implementation of the Generic Timer.
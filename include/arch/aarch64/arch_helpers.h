@@ -137,6 +137,7 @@ DEFINE_SYSOP_TYPE_FUNC(tlbi, alle3)
 DEFINE_SYSOP_TYPE_FUNC(tlbi, alle3is)
 #endif
 DEFINE_SYSOP_TYPE_FUNC(tlbi, vmalle1)
+DEFINE_SYSOP_TYPE_FUNC(tlbi, vmalle1is)
 
 DEFINE_SYSOP_TYPE_PARAM_FUNC(tlbi, vaae1is)
 DEFINE_SYSOP_TYPE_PARAM_FUNC(tlbi, vaale1is)
@@ -150,6 +151,22 @@ DEFINE_SYSOP_TYPE_PARAM_FUNC(tlbi, vae3is)
 DEFINE_SYSOP_TYPE_PARAM_FUNC(tlbi, vale3is)
 #endif
 
+/*
+ * TLBI range operations of ARMv8.4-TLBI. They are encoded as SYS instructions so
+ * that they can be assembled when targeting earlier versions of the
+ * architecture.
+ */
+#define DEFINE_TLBIOP_RANGE_PARAM_FUNC(_type, _op1, _crn, _crm, _op2)	\
+static inline void tlbi ## _type(u_register_t v)			\
+{									\
+	__asm__ volatile ("sys #" #_op1 ", " #_crn ", " #_crm ", #" #_op2 \
+			  ", %0" : : "r" (v));				\
+}
+
+DEFINE_TLBIOP_RANGE_PARAM_FUNC(rvaae1is, 0, c8, c2, 3)
+DEFINE_TLBIOP_RANGE_PARAM_FUNC(rvae2is, 4, c8, c2, 1)
+DEFINE_TLBIOP_RANGE_PARAM_FUNC(rvae3is, 6, c8, c2, 1)
+
 /*******************************************************************************
  * Cache maintenance accessor prototypes
  ******************************************************************************/
@@ -206,6 +223,7 @@ void disable_mmu_icache_el3(void);
 
 DEFINE_SYSREG_RW_FUNCS(par_el1)
 DEFINE_SYSREG_READ_FUNC(id_pfr1_el1)
+DEFINE_SYSREG_READ_FUNC(id_aa64isar0_el1)
 DEFINE_SYSREG_READ_FUNC(id_aa64isar1_el1)
 DEFINE_SYSREG_READ_FUNC(id_aa64pfr0_el1)
 DEFINE_SYSREG_READ_FUNC(id_aa64pfr1_el1)
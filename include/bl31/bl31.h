@@ -22,5 +22,6 @@ void bl31_register_bl32_init(int32_t (*func)(void));
 void bl31_warm_entrypoint(void);
 void bl31_main(void);
 void bl31_lib_init(void);
+void bl31_ring_store_warmboot_timestamps(unsigned long long exit_psci_ts);
 
 #endif /* BL31_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -86,6 +86,11 @@ void ehf_deactivate_priority(unsigned int priority);
 void ehf_register_priority_handler(unsigned int pri, ehf_handler_t handler);
 void ehf_allow_ns_preemption(uint64_t preempt_ret_code);
 unsigned int ehf_is_ns_preemption_allowed(void);
+#if EHF_LATENCY_STATS
+void ehf_lat_stats_complete(void);
+unsigned int ehf_lat_stats_ack(uint64_t ack_ts);
+void ehf_lat_stats_handler_done(unsigned int idx);
+#endif
 
 #endif /* __ASSEMBLY__ */
 
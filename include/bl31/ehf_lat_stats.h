@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef EHF_LAT_STATS_H
+#define EHF_LAT_STATS_H
+
+#include <lib/utils_def.h>
+
+/*******************************************************************************
+ * Layout of the EL3 interrupt latency statistics that are exported in the
+ * shared memory buffer at PLAT_EHF_LAT_STATS_BASE when EHF_LATENCY_STATS is
+ * enabled. The buffer starts with an 'ehf_lat_stats_hdr_t', followed by one
+ * record of 'record_size' bytes per CPU, in the order of plat_my_core_pos().
+ * Each record holds the statistics of the 'num_priorities' priority levels
+ * of the platform, in the order of their index.
+ *
+ * All the times are in ticks of the generic timer, whose frequency is given
+ * in the header. The handler time goes from the acknowledgement of the
+ * interrupt to the return of its handler. The completion time goes from the
+ * acknowledgement to the point where the priority of the interrupt stops
+ * running, which is later than the return of the handler if the interrupt
+ * was dispatched to a lower EL (e.g. an SDEI event).
+ *
+ * Each record is only updated by its CPU. Its 'seq' field is odd while it is
+ * being updated and is incremented again once the update is complete, so a
+ * reader must retry if 'seq' is odd or changed while it was reading the
+ * record.
+ ******************************************************************************/
+#define EHF_LAT_STATS_MAGIC		U(0x4C464845)	/* "EHFL" */
+#define EHF_LAT_STATS_VERSION		U(1)
+
+/*
+ * Latency histograms. Bucket 0 counts the values lower than 2 ticks, bucket N
+ * counts the values in [2^N, 2^(N+1)) and the last bucket also counts all the
+ * larger values. Percentiles can be estimated from them.
+ */
+#define EHF_LAT_STATS_BUCKETS		U(24)
+
+#ifndef __ASSEMBLY__
+
+#include <stdint.h>
+
+typedef struct ehf_lat_stats_hdr {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t num_buckets;
+	uint16_t num_priorities;
+	/* Number of top bits of the GIC priority used by the platform */
+	uint16_t pri_bits;
+	uint32_t num_cpus;
+	uint32_t record_size;
+	uint32_t reserved;
+	/* Frequency of the generic timer */
+	uint64_t freq;
+} ehf_lat_stats_hdr_t;
+
+typedef struct ehf_lat_stats_pri {
+	/* Number of interrupts acknowledged at this priority */
+	uint64_t count;
+	/* Number of them still running when their handler returned */
+	uint64_t deferred;
+	/* Shortest, longest and total completion time */
+	uint64_t min;
+	uint64_t max;
+	uint64_t total;
+	/*
+	 * Largest number of priority levels active on the CPU when an
+	 * interrupt was acknowledged, including its own.
+	 */
+	uint32_t max_nesting;
+	uint32_t reserved;
+	uint64_t handler_hist[EHF_LAT_STATS_BUCKETS];
+	uint64_t complete_hist[EHF_LAT_STATS_BUCKETS];
+} ehf_lat_stats_pri_t;
+
+typedef struct ehf_lat_stats_cpu {
+	uint32_t seq;
+	uint32_t reserved;
+	/* MPIDR of the CPU, or 0 until it has handled an interrupt */
+	uint64_t mpidr;
+	/* Statistics for each of the 'num_priorities' priority levels */
+	ehf_lat_stats_pri_t pri[];
+} ehf_lat_stats_cpu_t;
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* EHF_LAT_STATS_H */
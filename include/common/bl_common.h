@@ -225,10 +225,34 @@ typedef struct bl_params {
 	bl_params_node_t *head;
 } bl_params_t;
 
+/*
+ * Consumer of the data of an image while it is being loaded, e.g. a
+ * decompressor. When one is registered, the next image loaded by
+ * load_auth_image() is read in chunks of at most 'chunk_size' bytes into the
+ * buffer at 'chunk_base' instead of its load address:
+ *
+ *   - 'start' is called before the first chunk is read,
+ *   - 'consume' is called for each chunk as soon as it has been read,
+ *   - 'abort' is called if the image fails to load or to authenticate, so that
+ *     any data derived from it can be discarded.
+ */
+typedef struct image_load_stream {
+	uintptr_t chunk_base;
+	size_t chunk_size;
+	int (*start)(void);
+	int (*consume)(uintptr_t chunk, size_t len);
+	void (*abort)(void);
+} image_load_stream_t;
+
 /*******************************************************************************
  * Function & variable prototypes
  ******************************************************************************/
 int load_auth_image(unsigned int image_id, image_info_t *image_data);
+void bl_register_image_load_stream(const image_load_stream_t *stream);
+#if BL2_IMAGE_PREFETCH
+void bl_register_image_prefetch(unsigned int image_id, uintptr_t buf,
+				size_t size);
+#endif
 
 #if TRUSTED_BOARD_BOOT && defined(DYN_DISABLE_AUTH)
 /*
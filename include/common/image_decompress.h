@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -16,8 +16,29 @@ typedef int (decompressor_t)(uintptr_t *in_buf, size_t in_len,
 			     uintptr_t *out_buf, size_t out_len,
 			     uintptr_t work_buf, size_t work_len);
 
+/*
+ * Decompressor fed with the compressed data in chunks while it is being loaded.
+ * 'update' consumes a whole chunk of input and 'finish' returns the end of the
+ * output in 'out_buf'.
+ */
+typedef struct stream_decompressor {
+	int (*init)(uintptr_t out_buf, size_t out_len,
+		    uintptr_t work_buf, size_t work_len);
+	int (*update)(uintptr_t in_buf, size_t in_len);
+	int (*finish)(uintptr_t *out_buf);
+} stream_decompressor_t;
+
 void image_decompress_init(uintptr_t buf_base, uint32_t buf_size,
 			   decompressor_t *decompressor);
+/*
+ * With Trusted Board Boot, a streamed image can only be authenticated if its
+ * hash is calculated while it is loaded.
+ */
+#if !TRUSTED_BOARD_BOOT || AUTH_STREAM_HASH
+void image_decompress_stream_init(uintptr_t buf_base, uint32_t buf_size,
+				  uint32_t chunk_size,
+				  const stream_decompressor_t *decompressor);
+#endif
 void image_decompress_prepare(struct image_info *info);
 int image_decompress(struct image_info *info);
 
@@ -31,6 +31,24 @@
 #endif /* AARCH32 */
 #define SIZEOF_RT_SVC_DESC	(U(1) << RT_SVC_SIZE_LOG2)
 
+/*
+ * Constants to allow the assembler access the table of handlers registered for
+ * individual SMC function IDs. The table is indexed by a multiplicative hash of
+ * the function ID and is never more than half full.
+ */
+#ifdef AARCH32
+#define RT_SVC_FID_SIZE_LOG2	U(3)
+#define RT_SVC_FID_HANDLE	U(4)
+#else
+#define RT_SVC_FID_SIZE_LOG2	U(4)
+#define RT_SVC_FID_HANDLE	U(8)
+#endif /* AARCH32 */
+#define SIZEOF_RT_SVC_FID_DESC	(U(1) << RT_SVC_FID_SIZE_LOG2)
+#define RT_SVC_FID_TABLE_SIZE_LOG2	U(5)
+#define RT_SVC_FID_TABLE_SIZE	(U(1) << RT_SVC_FID_TABLE_SIZE_LOG2)
+#define RT_SVC_FID_MAX_HANDLERS	(RT_SVC_FID_TABLE_SIZE / U(2))
+#define RT_SVC_FID_HASH_MUL	U(0x9E3779B1)
+
 
 /*
  * In SMCCC 1.X, the function identifier has 6 bits for the owning entity number
@@ -97,6 +115,28 @@ CASSERT(RT_SVC_DESC_INIT == __builtin_offsetof(rt_svc_desc_t, init), \
 CASSERT(RT_SVC_DESC_HANDLE == __builtin_offsetof(rt_svc_desc_t, handle), \
 	assert_rt_svc_desc_handle_offset_mismatch);
 
+#if RT_SVC_FID_HANDLERS
+/* Handler registered for an individual SMC function ID */
+typedef struct rt_svc_fid_desc {
+	uint32_t smc_fid;
+	rt_svc_handle_t handle;
+} rt_svc_fid_desc_t;
+
+CASSERT((sizeof(rt_svc_fid_desc_t) == SIZEOF_RT_SVC_FID_DESC), \
+	assert_sizeof_rt_svc_fid_desc_mismatch);
+CASSERT(RT_SVC_FID_HANDLE == __builtin_offsetof(rt_svc_fid_desc_t, handle), \
+	assert_rt_svc_fid_desc_handle_offset_mismatch);
+
+/*
+ * This function returns the index in the 'rt_svc_fid_table' array at which the
+ * lookup of an SMC function ID starts.
+ */
+static inline uint32_t get_rt_svc_fid_hash(uint32_t fid)
+{
+	return (fid * RT_SVC_FID_HASH_MUL) >> (32U - RT_SVC_FID_TABLE_SIZE_LOG2);
+}
+#endif /* RT_SVC_FID_HANDLERS */
+
 
 /*
  * This function combines the call type and the owning entity number
@@ -134,5 +174,28 @@ void init_crash_reporting(void);
 
 extern uint8_t rt_svc_descs_indices[MAX_RT_SVCS];
 
+#if RT_SVC_DISPATCH_STATS
+/* Times of the SMCs handled by BL31, in ticks of the system counter */
+typedef struct rt_svc_dispatch_stat {
+	/* Number of SMCs whose handler returned */
+	uint64_t count;
+	/* Time from the SMC entry to the call of the handler */
+	uint64_t dispatch_ticks;
+	uint64_t max_dispatch_ticks;
+	/* Time spent in the handler */
+	uint64_t handler_ticks;
+	uint64_t max_handler_ticks;
+} rt_svc_dispatch_stat_t;
+
+void rt_svc_dispatch_stat_update(uint64_t entry_ts, uint64_t call_ts);
+void rt_svc_get_dispatch_stat(rt_svc_dispatch_stat_t *stat);
+#endif
+
+#if RT_SVC_FID_HANDLERS
+int rt_svc_register_fid_handler(uint32_t smc_fid, rt_svc_handle_t handle);
+
+extern rt_svc_fid_desc_t rt_svc_fid_table[RT_SVC_FID_TABLE_SIZE];
+#endif
+
 #endif /*__ASSEMBLY__*/
 #endif /* RUNTIME_SVC_H */
@@ -37,6 +37,11 @@ int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id);
 int auth_mod_verify_img(unsigned int img_id,
 			void *img_ptr,
 			unsigned int img_len);
+#if AUTH_STREAM_HASH
+int auth_mod_hash_stream_start(unsigned int img_id);
+int auth_mod_hash_stream_update(unsigned int img_id, void *data_ptr,
+				unsigned int data_len);
+#endif
 
 /* Macro to register a CoT defined as an array of auth_img_desc_t pointers */
 #define REGISTER_COT(_cot) \
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -16,6 +16,12 @@ enum crypto_ret_value {
 	CRYPTO_ERR_UNKNOWN
 };
 
+/*
+ * Size of the SHA-256 digests calculated by crypto_mod_calc_hash(), and of the
+ * HMAC-SHA-256 codes calculated by crypto_mod_calc_mac()
+ */
+#define CRYPTO_CALC_HASH_SIZE		32U
+
 /*
  * Cryptographic library descriptor
  */
@@ -37,6 +43,27 @@ typedef struct crypto_lib_desc_s {
 	/* Verify a hash. Return one of the 'enum crypto_ret_value' options */
 	int (*verify_hash)(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
+
+	/* Optional functions to verify a hash of data provided in several
+	 * chunks. 'hash_init' starts a new calculation with the algorithm in
+	 * the digest info, 'hash_update' adds data to it and 'hash_final'
+	 * compares the result with the hash in the digest info. Return one of
+	 * the 'enum crypto_ret_value' options */
+	int (*hash_init)(void *digest_info_ptr, unsigned int digest_info_len);
+	int (*hash_update)(void *data_ptr, unsigned int data_len);
+	int (*hash_final)(void *digest_info_ptr, unsigned int digest_info_len);
+
+	/* Optional function to calculate the SHA-256 hash of data, writing
+	 * CRYPTO_CALC_HASH_SIZE bytes to 'output'. Return one of the
+	 * 'enum crypto_ret_value' options */
+	int (*calc_hash)(void *data_ptr, unsigned int data_len,
+			 unsigned char *output);
+
+	/* Optional function to calculate the HMAC-SHA-256 of data with the
+	 * secret 'key', writing CRYPTO_CALC_HASH_SIZE bytes to 'output'.
+	 * Return one of the 'enum crypto_ret_value' options */
+	int (*calc_mac)(const void *key, unsigned int key_len, void *data_ptr,
+			unsigned int data_len, unsigned char *output);
 } crypto_lib_desc_t;
 
 /* Public functions */
@@ -47,6 +74,13 @@ int crypto_mod_verify_signature(void *data_ptr, unsigned int data_len,
 				void *pk_ptr, unsigned int pk_len);
 int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
+int crypto_mod_hash_init(void *digest_info_ptr, unsigned int digest_info_len);
+int crypto_mod_hash_update(void *data_ptr, unsigned int data_len);
+int crypto_mod_hash_final(void *digest_info_ptr, unsigned int digest_info_len);
+int crypto_mod_calc_hash(void *data_ptr, unsigned int data_len,
+			 unsigned char *output);
+int crypto_mod_calc_mac(const void *key, unsigned int key_len, void *data_ptr,
+			unsigned int data_len, unsigned char *output);
 
 /* Macro to register a cryptographic library */
 #define REGISTER_CRYPTO_LIB(_name, _init, _verify_signature, _verify_hash) \
@@ -57,6 +91,38 @@ int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 		.verify_hash = _verify_hash \
 	}
 
+/* Macro to register a cryptographic library that can hash data in chunks */
+#define REGISTER_CRYPTO_LIB_WITH_HASH_STREAM(_name, _init, _verify_signature, \
+		_verify_hash, _hash_init, _hash_update, _hash_final) \
+	const crypto_lib_desc_t crypto_lib_desc = { \
+		.name = _name, \
+		.init = _init, \
+		.verify_signature = _verify_signature, \
+		.verify_hash = _verify_hash, \
+		.hash_init = _hash_init, \
+		.hash_update = _hash_update, \
+		.hash_final = _hash_final \
+	}
+
+/*
+ * Macro to register a cryptographic library that can also calculate hashes
+ * and message authentication codes. The hash streaming functions may be NULL.
+ */
+#define REGISTER_CRYPTO_LIB_WITH_CALC_HASH(_name, _init, _verify_signature, \
+		_verify_hash, _hash_init, _hash_update, _hash_final, \
+		_calc_hash, _calc_mac) \
+	const crypto_lib_desc_t crypto_lib_desc = { \
+		.name = _name, \
+		.init = _init, \
+		.verify_signature = _verify_signature, \
+		.verify_hash = _verify_hash, \
+		.hash_init = _hash_init, \
+		.hash_update = _hash_update, \
+		.hash_final = _hash_final, \
+		.calc_hash = _calc_hash, \
+		.calc_mac = _calc_mac \
+	}
+
 extern const crypto_lib_desc_t crypto_lib_desc;
 
 #endif /* CRYPTO_MOD_H */
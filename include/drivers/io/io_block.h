@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -13,12 +13,27 @@
 typedef struct io_block_ops {
 	size_t	(*read)(int lba, uintptr_t buf, size_t size);
 	size_t	(*write)(int lba, const uintptr_t buf, size_t size);
+	/*
+	 * Optional asynchronous read of whole blocks, which is only used for
+	 * direct transfers (see 'direct_align'). read_submit() returns 0 once
+	 * the read has been started. read_poll() returns -EAGAIN until it has
+	 * completed, then its result and the number of bytes read.
+	 */
+	int	(*read_submit)(int lba, uintptr_t buf, size_t size);
+	int	(*read_poll)(size_t *length_read);
 } io_block_ops_t;
 
 typedef struct io_block_dev_spec {
 	io_block_spec_t	buffer;
 	io_block_ops_t	ops;
 	size_t		block_size;
+	/*
+	 * Alignment that ops->read() and ops->write() require for buffers other
+	 * than 'buffer'. If non-zero, block-aligned transfers bypass 'buffer'
+	 * and use the caller buffer directly whenever it is aligned to this
+	 * value. 0 means that all transfers go through 'buffer'.
+	 */
+	size_t		direct_align;
 } io_block_dev_spec_t;
 
 struct io_dev_connector;
@@ -48,6 +48,15 @@ typedef struct io_dev_funcs {
 	int (*close)(io_entity_t *entity);
 	int (*dev_init)(io_dev_info_t *dev_info, const uintptr_t init_params);
 	int (*dev_close)(io_dev_info_t *dev_info);
+	/*
+	 * Optional asynchronous read. read_submit() starts reading and may
+	 * return before the data is in the buffer, or return -ENOTSUP if it
+	 * can't do it for this request. read_poll() then returns -EAGAIN until
+	 * the read has completed. Only one read can be outstanding per entity.
+	 */
+	int (*read_submit)(io_entity_t *entity, uintptr_t buffer,
+			size_t length);
+	int (*read_poll)(io_entity_t *entity, size_t *length_read);
 } io_dev_funcs_t;
 
 
@@ -63,6 +63,15 @@ typedef struct io_block_spec {
 } io_block_spec_t;
 
 
+/* Asynchronous read request, see io_read_submit() */
+typedef struct io_async_req {
+	uintptr_t handle;
+	size_t length_read;
+	int result;
+	int pending;
+} io_async_req_t;
+
+
 /* Access modes used when accessing data on a device */
 #define IO_MODE_INVALID (0)
 #define IO_MODE_RO	(1 << 0)
@@ -99,4 +108,13 @@ int io_write(uintptr_t handle, const uintptr_t buffer, size_t length,
 int io_close(uintptr_t handle);
 
 
+/* Asynchronous operations */
+int io_read_submit(uintptr_t handle, uintptr_t buffer, size_t length,
+		io_async_req_t *req);
+
+int io_read_poll(io_async_req_t *req);
+
+int io_read_wait(io_async_req_t *req, size_t *length_read);
+
+
 #endif /* IO_STORAGE_H */
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LOGBUF_CONSOLE_H
+#define LOGBUF_CONSOLE_H
+
+#include <drivers/console.h>
+
+/*******************************************************************************
+ * Layout of the memory buffer of the log buffer console. The buffer starts
+ * with a 'logbuf_hdr_t', followed by one ring per CPU, in the order of
+ * plat_my_core_pos(). The first ring is at 'ring_offset' bytes from the start
+ * of the buffer and the rings are 'ring_size' bytes apart.
+ *
+ * Each CPU appends the characters that it prints to the 'data' array of its
+ * ring, at the index 'head % data_size', and then increments 'head'. Older
+ * characters are overwritten when the ring is full. A reader that wants the
+ * characters from position 'n' must read 'head', copy the data, and read
+ * 'head' again: the characters at positions lower than the second value of
+ * 'head' minus 'data_size' may have been overwritten while they were copied.
+ *
+ * The buffer may be in Non-secure memory so that the Normal world can read
+ * the logs. The firmware only writes to it: the positions it depends on are
+ * kept in Secure memory.
+ ******************************************************************************/
+#define LOGBUF_MAGIC			U(0x42474F4C)	/* "LOGB" */
+#define LOGBUF_VERSION			U(1)
+
+#ifndef __ASSEMBLY__
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct logbuf_hdr {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t reserved;
+	uint32_t num_cpus;
+	uint32_t ring_offset;
+	uint32_t ring_size;
+	/* Size of the 'data' array of each ring, a power of two */
+	uint32_t data_size;
+} logbuf_hdr_t;
+
+typedef struct logbuf_ring {
+	/* Number of characters that the CPU has written to the ring */
+	uint64_t head;
+	uint8_t data[];
+} logbuf_ring_t;
+
+typedef struct {
+	console_t console;
+	/* Console that the rings are drained to */
+	console_t *out;
+} console_logbuf_t;
+
+/*
+ * Register the log buffer console, with its rings in the buffer at 'base'.
+ * Only one instance can be registered. The characters printed on it are
+ * stored in the ring of the current CPU, and only written to the 'out'
+ * console when the log buffer console is flushed. Like the other consoles, it
+ * is registered with the boot and crash scopes: the platform is expected to
+ * give it the runtime scope instead, and to give the 'out' console the boot
+ * and crash scopes only.
+ */
+int console_logbuf_register(uintptr_t base, size_t size, console_t *out,
+			    console_logbuf_t *console);
+
+/*
+ * Write the content of the rings to the 'out' console when BL31 crashes,
+ * without waiting for another CPU that may be draining them.
+ */
+void console_logbuf_crash_drain(void);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* LOGBUF_CONSOLE_H */
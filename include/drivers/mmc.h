@@ -7,6 +7,7 @@
 #ifndef MMC_H
 #define MMC_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <lib/utils_def.h>
@@ -14,6 +15,9 @@
 #define MMC_BLOCK_SIZE			U(512)
 #define MMC_BLOCK_MASK			(MMC_BLOCK_SIZE - U(1))
 #define MMC_BOOT_CLK_RATE		(400 * 1000)
+#define MMC_LEGACY_MAX_CLK_RATE		U(26 * 1000 * 1000)
+#define MMC_HS_MAX_CLK_RATE		U(52 * 1000 * 1000)
+#define MMC_HS200_MAX_CLK_RATE		U(200 * 1000 * 1000)
 
 #define MMC_CMD(_x)			U(_x)
 
@@ -60,6 +64,7 @@
 #define CMD_EXTCSD_PARTITION_CONFIG	179
 #define CMD_EXTCSD_BUS_WIDTH		183
 #define CMD_EXTCSD_HS_TIMING		185
+#define CMD_EXTCSD_DEVICE_TYPE		196
 #define CMD_EXTCSD_SEC_CNT		212
 
 #define PART_CFG_BOOT_PARTITION1_ENABLE	(U(1) << 3)
@@ -74,6 +79,12 @@
 #define MMC_BOOT_MODE_BACKWARD		(U(0) << 3)
 #define MMC_BOOT_MODE_HS_TIMING		(U(1) << 3)
 #define MMC_BOOT_MODE_DDR		(U(2) << 3)
+#define MMC_HS_TIMING_HS		U(1)
+#define MMC_HS_TIMING_HS200		U(2)
+#define MMC_HS_TIMING_HS400		U(3)
+#define MMC_DEVICE_TYPE_HS_52		BIT(1)
+#define MMC_DEVICE_TYPE_HS200		(U(3) << 4)
+#define MMC_DEVICE_TYPE_HS400		(U(3) << 6)
 
 #define EXTCSD_SET_CMD			(U(0) << 24)
 #define EXTCSD_SET_BITS			(U(1) << 24)
@@ -104,6 +115,11 @@
 #define MMC_STATE_SLP			10
 
 #define MMC_FLAG_CMD23			(U(1) << 0)
+#define MMC_FLAG_HS200			(U(1) << 1)
+#define MMC_FLAG_HS400			(U(1) << 2)
+
+/* The block count of CMD23 is a 16-bit field */
+#define MMC_CMD23_MAX_BLOCKS		U(0xFFFF)
 
 #define CMD8_CHECK_PATTERN		U(0xAA)
 #define VHS_2_7_3_6_V			BIT(8)
@@ -125,6 +141,55 @@ struct mmc_ops {
 	int (*prepare)(int lba, uintptr_t buf, size_t size);
 	int (*read)(int lba, uintptr_t buf, size_t size);
 	int (*write)(int lba, const uintptr_t buf, size_t size);
+	/*
+	 * The following operations are optional and may be NULL.
+	 *
+	 * max_xfer_size() returns the largest transfer that prepare() can set
+	 * up, for instance the size covered by the DMA descriptor table of the
+	 * controller, or 0 if there is no limit. Larger reads and writes are
+	 * split by the MMC core.
+	 */
+	size_t (*max_xfer_size)(void);
+	/*
+	 * Switch the controller to one of the MMC_HS_TIMING_* bus timings. It
+	 * is called before set_ios() configures the clock of the new timing.
+	 * Both set_timing() and execute_tuning() are needed for MMC_FLAG_HS200
+	 * and MMC_FLAG_HS400.
+	 */
+	int (*set_timing)(unsigned int timing);
+	/*
+	 * Tune the sampling point of the controller, sending the tuning
+	 * command 'cmd_idx' as many times as the controller needs.
+	 */
+	int (*execute_tuning)(unsigned int cmd_idx);
+};
+
+/*
+ * ADMA2 descriptor with a 32-bit address, as defined by the SD Host Controller
+ * specification. A length of 0 stands for MMC_ADMA2_MAX_LEN bytes.
+ */
+#define MMC_ADMA2_ATTR_VALID		BIT_32(0)
+#define MMC_ADMA2_ATTR_END		BIT_32(1)
+#define MMC_ADMA2_ATTR_INT		BIT_32(2)
+#define MMC_ADMA2_ATTR_ACT_TRAN		(U(2) << 4)
+#define MMC_ADMA2_MAX_LEN		U(0x10000)
+
+struct mmc_adma2_desc {
+	uint16_t	attr;
+	uint16_t	len;
+	uint32_t	addr;
+};
+
+/*
+ * Format of the DMA descriptors of a controller, for mmc_dma_desc_build().
+ * fill() writes the descriptor 'idx' of the table at 'table', for the 'len'
+ * bytes at 'addr'. 'last' is set for the last descriptor of the transfer.
+ */
+struct mmc_dma_desc_format {
+	size_t	desc_size;
+	size_t	max_len;
+	void	(*fill)(uintptr_t table, unsigned int idx, uintptr_t addr,
+			size_t len, bool last);
 };
 
 struct mmc_csd_emmc {
@@ -230,6 +295,11 @@ size_t mmc_erase_blocks(int lba, size_t size);
 size_t mmc_rpmb_read_blocks(int lba, uintptr_t buf, size_t size);
 size_t mmc_rpmb_write_blocks(int lba, const uintptr_t buf, size_t size);
 size_t mmc_rpmb_erase_blocks(int lba, size_t size);
+int mmc_dma_desc_build(const struct mmc_dma_desc_format *fmt,
+		       uintptr_t table, size_t table_size,
+		       uintptr_t buf, size_t size);
+int mmc_adma2_build(struct mmc_adma2_desc *desc, unsigned int nb_desc,
+		    uintptr_t buf, size_t size);
 int mmc_init(const struct mmc_ops *ops_ptr, unsigned int clk,
 	     unsigned int width, unsigned int flags,
 	     struct mmc_device_info *device_info);
@@ -525,6 +525,21 @@ typedef struct ufs_params {
 	unsigned long	flags;
 } ufs_params_t;
 
+/*
+ * Queued transfer. It is split into several commands that are outstanding at
+ * the same time, in as many UTP Transfer Request slots as are free.
+ */
+typedef struct ufs_xfer {
+	int		lun;
+	int		lba;		/* LBA of the next command to issue */
+	uintptr_t	buf;		/* Buffer of the next command to issue */
+	size_t		left;		/* Bytes not requested yet */
+	size_t		done;		/* Bytes of the completed commands */
+	unsigned int	pending;	/* Slots of the outstanding commands */
+	unsigned int	idle_us;	/* Time since a command last completed */
+	int		error;
+} ufs_xfer_t;
+
 typedef struct ufs_ops {
 	int		(*phy_init)(ufs_params_t *params);
 	int		(*phy_set_pwr_mode)(ufs_params_t *params);
@@ -543,6 +558,16 @@ void ufs_read_desc(int idn, int index, uintptr_t buf, size_t size);
 void ufs_write_desc(int idn, int index, uintptr_t buf, size_t size);
 size_t ufs_read_blocks(int lun, int lba, uintptr_t buf, size_t size);
 size_t ufs_write_blocks(int lun, int lba, const uintptr_t buf, size_t size);
+/*
+ * Start a queued read of 'size' bytes and return without waiting for it. The
+ * transfer progresses and completes in ufs_queue_poll(), which returns -EAGAIN
+ * until then, and -ETIMEDOUT if none of the commands of the transfer completes
+ * for a second. The other UFS functions must not be called while a queued
+ * transfer is in progress.
+ */
+int ufs_queue_read(int lun, int lba, uintptr_t buf, size_t size,
+		   ufs_xfer_t *xfer);
+int ufs_queue_poll(ufs_xfer_t *xfer);
 int ufs_init(const ufs_ops_t *ops, ufs_params_t *params);
 
 #endif /* UFS_H */
@@ -129,6 +129,33 @@
  */
 #define CTX_SYSREGS_END		CTX_TIMER_SYSREGS_END
 
+/*
+ * Groups of EL1 system registers that el1_sysregs_context_save_mask() and
+ * el1_sysregs_context_restore_mask() can switch independently of each other:
+ *
+ * SYSTEM:    SCTLR, ACTLR, CPACR, CSSELR, TTBR0/1, MAIR, AMAIR, TCR, TPIDR_EL1,
+ *            CONTEXTIDR, VBAR
+ * EXCEPTION: SPSR_EL1, ELR_EL1, SP_EL1, ESR, PAR, FAR, AFSR0/1
+ * THREAD:    TPIDR_EL0, TPIDRRO_EL0
+ * PMU:       PMCR_EL0
+ * AARCH32:   the AArch32 registers, if CTX_INCLUDE_AARCH32_REGS
+ * TIMER:     the NS timer registers, if NS_TIMER_SWITCH
+ */
+#define CTX_EL1_REGS_SYSTEM_BIT		U(0)
+#define CTX_EL1_REGS_EXCEPTION_BIT	U(1)
+#define CTX_EL1_REGS_THREAD_BIT		U(2)
+#define CTX_EL1_REGS_PMU_BIT		U(3)
+#define CTX_EL1_REGS_AARCH32_BIT	U(4)
+#define CTX_EL1_REGS_TIMER_BIT		U(5)
+
+#define CTX_EL1_REGS_SYSTEM	(U(1) << CTX_EL1_REGS_SYSTEM_BIT)
+#define CTX_EL1_REGS_EXCEPTION	(U(1) << CTX_EL1_REGS_EXCEPTION_BIT)
+#define CTX_EL1_REGS_THREAD	(U(1) << CTX_EL1_REGS_THREAD_BIT)
+#define CTX_EL1_REGS_PMU	(U(1) << CTX_EL1_REGS_PMU_BIT)
+#define CTX_EL1_REGS_AARCH32	(U(1) << CTX_EL1_REGS_AARCH32_BIT)
+#define CTX_EL1_REGS_TIMER	(U(1) << CTX_EL1_REGS_TIMER_BIT)
+#define CTX_EL1_REGS_ALL	U(0x3f)
+
 /*******************************************************************************
  * Constants that allow assembler code to access members of and the 'fp_regs'
  * structure at their correct offsets.
@@ -379,6 +406,8 @@ CASSERT(CTX_PAUTH_REGS_OFFSET == __builtin_offsetof(cpu_context_t, pauth_ctx), \
  ******************************************************************************/
 void el1_sysregs_context_save(el1_sys_regs_t *regs);
 void el1_sysregs_context_restore(el1_sys_regs_t *regs);
+void el1_sysregs_context_save_mask(el1_sys_regs_t *regs, unsigned int mask);
+void el1_sysregs_context_restore_mask(el1_sys_regs_t *regs, unsigned int mask);
 #if CTX_INCLUDE_FPREGS
 void fpregs_context_save(fp_regs_t *regs);
 void fpregs_context_restore(fp_regs_t *regs);
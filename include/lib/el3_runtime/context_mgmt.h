@@ -38,6 +38,13 @@ void cm_prepare_el3_exit(uint32_t security_state);
 #ifndef AARCH32
 void cm_el1_sysregs_context_save(uint32_t security_state);
 void cm_el1_sysregs_context_restore(uint32_t security_state);
+void cm_el1_sysregs_context_save_mask(uint32_t security_state,
+				      unsigned int mask);
+void cm_el1_sysregs_context_restore_mask(uint32_t security_state,
+					 unsigned int mask);
+#if CTX_FPREGS_LAZY
+void cm_handle_fpregs_trap(void);
+#endif
 void cm_set_elr_el3(uint32_t security_state, uintptr_t entrypoint);
 void cm_set_elr_spsr_el3(uint32_t security_state,
 			uintptr_t entrypoint, uint32_t spsr);
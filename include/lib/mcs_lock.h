@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef MCS_LOCK_H
+#define MCS_LOCK_H
+
+#include <platform_def.h>
+
+/*
+ * Maximum number of MCS locks that a CPU can hold or wait for at the same
+ * time. Platforms can override it with PLAT_MCS_LOCK_MAX_NESTING.
+ */
+#ifdef PLAT_MCS_LOCK_MAX_NESTING
+#define MCS_LOCK_MAX_NESTING	PLAT_MCS_LOCK_MAX_NESTING
+#else
+#define MCS_LOCK_MAX_NESTING	U(4)
+#endif
+
+#ifndef __ASSEMBLY__
+#include <cdefs.h>
+#include <stdint.h>
+
+#include <lib/utils_def.h>
+
+/*****************************************************************************
+ * Internal helpers used by the MCS lock implementation.
+ ****************************************************************************/
+
+/* Value of the tail of a free lock, or of the next field of a node */
+#define MCS_NODE_NONE		U(0)
+
+/*
+ * Queue node. Each CPU waits for the lock spinning on the 'locked' field of
+ * its own node, which is in a cache line of its own.
+ */
+typedef struct mcs_node {
+	/* Set while the CPU waits in the queue of the lock */
+	volatile uint32_t locked;
+	/* Node of the CPU that is queued after this one, or MCS_NODE_NONE */
+	volatile uint32_t next;
+	/* Lock that the node is used for, or NULL if the node is free */
+	const void *lock;
+} __aligned(CACHE_WRITEBACK_GRANULE) mcs_node_t;
+
+uint32_t mcs_lock_swap(volatile uint32_t *addr, uint32_t val);
+uint32_t mcs_lock_cas(volatile uint32_t *addr, uint32_t old, uint32_t val);
+void mcs_lock_wait_while(volatile uint32_t *addr, uint32_t val);
+void mcs_lock_store_release(volatile uint32_t *addr, uint32_t val);
+
+/*****************************************************************************
+ * External MCS lock interface.
+ ****************************************************************************/
+
+/*
+ * MCS locks are queue-based spinlocks. The CPUs that wait for a lock are put
+ * in a queue and each one spins on its own cache line, so that releasing the
+ * lock only affects the next CPU in the queue. The lock is granted in the
+ * order in which it is requested.
+ *
+ * They use exclusive access instructions, so all the contenders must have
+ * caches and address translation enabled, and they must be coherent.
+ */
+typedef struct mcs_lock {
+	/* Node of the last CPU in the queue, or MCS_NODE_NONE if free */
+	volatile uint32_t tail;
+} mcs_lock_t;
+
+static inline void mcs_lock_init(mcs_lock_t *lock)
+{
+	lock->tail = MCS_NODE_NONE;
+}
+
+void mcs_lock_get(mcs_lock_t *lock);
+void mcs_lock_release(mcs_lock_t *lock);
+
+#define DEFINE_MCS_LOCK(_name) mcs_lock_t _name
+
+#define DECLARE_MCS_LOCK(_name) extern mcs_lock_t _name
+
+#endif /* __ASSEMBLY__ */
+#endif /* MCS_LOCK_H */
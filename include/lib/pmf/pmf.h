@@ -40,7 +40,13 @@
  */
 #define PMF_SMC_GET_TIMESTAMP_32	U(0x82000010)
 #define PMF_SMC_GET_TIMESTAMP_64	U(0xC2000010)
+#define PMF_SMC_GET_RING_BUFFER_32	U(0x82000011)
+#define PMF_SMC_GET_RING_BUFFER_64	U(0xC2000011)
+#if PMF_RING_BUFFERS
+#define PMF_NUM_SMC_CALLS		4
+#else
 #define PMF_NUM_SMC_CALLS		2
+#endif
 
 /*
  * The macros below are used to identify
@@ -120,7 +126,7 @@
  */
 #define PMF_REGISTER_SERVICE(_name, _svcid, _totalid, _flags)	\
 	PMF_ALLOCATE_TIMESTAMP_MEMORY(_name, _totalid)		\
-	PMF_DEFINE_CAPTURE_TIMESTAMP(_name, _flags)		\
+	PMF_DEFINE_CAPTURE_TIMESTAMP(_name, _svcid, _flags)	\
 	PMF_DEFINE_GET_TIMESTAMP(_name)
 
 /*
@@ -165,6 +171,8 @@ int pmf_get_timestamp_smc(unsigned int tid,
 		unsigned int flags,
 		unsigned long long *ts_value);
 int pmf_setup(void);
+void pmf_ring_setup(void);
+int pmf_ring_get_buffer(uintptr_t *base, size_t *size);
 uintptr_t pmf_smc_handler(unsigned int smc_fid,
 		u_register_t x1,
 		u_register_t x2,
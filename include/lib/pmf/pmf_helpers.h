@@ -8,6 +8,7 @@
 #define PMF_HELPERS_H
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -61,12 +62,26 @@ typedef struct pmf_svc_desc {
 #define PMF_VALIDATE_TID(_name, _tid)	\
 	assert((_tid & PMF_TID_MASK) < (ARRAY_SIZE(pmf_ts_mem_ ## _name)))
 
+/*
+ * Convenience macro to append a time-stamp to the ring buffer of the current
+ * CPU, if PMF_RING_BUFFERS is enabled.
+ */
+#if PMF_RING_BUFFERS
+#define PMF_RING_STORE_TIMESTAMP(_svcid, _tid, _ts, _cache_maint)	\
+	__pmf_ring_store_timestamp(					\
+		(((unsigned int)(_svcid) << PMF_SVC_ID_SHIFT) &		\
+			PMF_SVC_ID_MASK) | ((_tid) & PMF_TID_MASK),	\
+		(_ts), (_cache_maint))
+#else
+#define PMF_RING_STORE_TIMESTAMP(_svcid, _tid, _ts, _cache_maint)
+#endif
+
 /*
  * Convenience macros for capturing time-stamp.
  *
  * The extern declaration is there to satisfy MISRA C-2012 rule 8.4.
  */
-#define PMF_DEFINE_CAPTURE_TIMESTAMP(_name, _flags)			\
+#define PMF_DEFINE_CAPTURE_TIMESTAMP(_name, _svcid, _flags)		\
 	void pmf_capture_timestamp_ ## _name(				\
 			unsigned int tid,				\
 			unsigned long long ts);				\
@@ -77,8 +92,10 @@ typedef struct pmf_svc_desc {
 		CASSERT(_flags, select_proper_config);			\
 		PMF_VALIDATE_TID(_name, tid);				\
 		uintptr_t base_addr = (uintptr_t) pmf_ts_mem_ ## _name;	\
-		if (((_flags) & PMF_STORE_ENABLE) != 0)			\
+		if (((_flags) & PMF_STORE_ENABLE) != 0) {		\
 			__pmf_store_timestamp(base_addr, tid, ts);	\
+			PMF_RING_STORE_TIMESTAMP(_svcid, tid, ts, false); \
+		}							\
 		if (((_flags) & PMF_DUMP_ENABLE) != 0)			\
 			__pmf_dump_timestamp(tid, ts);			\
 	}								\
@@ -92,8 +109,10 @@ typedef struct pmf_svc_desc {
 		CASSERT(_flags, select_proper_config);			\
 		PMF_VALIDATE_TID(_name, tid);				\
 		uintptr_t base_addr = (uintptr_t) pmf_ts_mem_ ## _name;	\
-		if (((_flags) & PMF_STORE_ENABLE) != 0)			\
+		if (((_flags) & PMF_STORE_ENABLE) != 0) {		\
 			__pmf_store_timestamp_with_cache_maint(base_addr, tid, ts);\
+			PMF_RING_STORE_TIMESTAMP(_svcid, tid, ts, true); \
+		}							\
 		if (((_flags) & PMF_DUMP_ENABLE) != 0)			\
 			__pmf_dump_timestamp(tid, ts);			\
 	}
@@ -159,4 +178,7 @@ unsigned long long __pmf_get_timestamp(uintptr_t base_addr,
 		unsigned int tid,
 		unsigned int cpuid,
 		unsigned int flags);
+void __pmf_ring_store_timestamp(unsigned int tid,
+		unsigned long long ts,
+		bool cache_maint);
 #endif /* PMF_HELPERS_H */
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef PMF_RING_H
+#define PMF_RING_H
+
+#include <lib/utils_def.h>
+
+/*******************************************************************************
+ * Layout of the PMF ring buffers that are exported in the shared memory buffer
+ * at PLAT_PMF_RING_BASE when PMF_RING_BUFFERS is enabled. The buffer starts
+ * with a 'pmf_ring_hdr_t', followed by one ring per CPU, in the order of
+ * plat_my_core_pos(). The first ring is at 'ring_offset' bytes from the start
+ * of the buffer and the rings are 'ring_size' bytes apart.
+ *
+ * Each CPU appends a 'pmf_ring_entry_t' to its ring for every time-stamp that
+ * it captures, and then increments the 'head' field of the ring. The sequence
+ * number of an event is the value of 'head' before it was incremented, and
+ * the event is stored in the entry 'seq % num_entries'. Older entries are
+ * overwritten when the ring is full.
+ *
+ * The 'seq' field of an entry is PMF_RING_SEQ_INVALID while it is being
+ * written. A reader that wants the event 'n' must read 'seq', then the other
+ * fields, then 'seq' again. The event was read correctly if both values of
+ * 'seq' are equal to 'n'; if they are not, it was overwritten by a newer one.
+ ******************************************************************************/
+#define PMF_RING_MAGIC			U(0x52464d50)	/* "PMFR" */
+#define PMF_RING_VERSION		U(1)
+
+#define PMF_RING_SEQ_INVALID		ULL(0xFFFFFFFFFFFFFFFF)
+
+#ifndef __ASSEMBLY__
+
+#include <stdint.h>
+
+typedef struct pmf_ring_hdr {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t reserved;
+	uint32_t num_cpus;
+	/* Number of entries in each ring, a power of two */
+	uint32_t num_entries;
+	uint32_t ring_offset;
+	uint32_t ring_size;
+	/* Frequency of the counter that the time-stamps are read from */
+	uint64_t freq;
+} pmf_ring_hdr_t;
+
+typedef struct pmf_ring_entry {
+	uint64_t seq;
+	uint64_t ts;
+	/* Time-stamp ID, including the ID of the PMF service */
+	uint32_t tid;
+	uint32_t reserved;
+} pmf_ring_entry_t;
+
+typedef struct pmf_ring {
+	/* Number of events that the CPU has written to the ring */
+	uint64_t head;
+	uint64_t reserved;
+	pmf_ring_entry_t entries[];
+} pmf_ring_t;
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* PMF_RING_H */
@@ -325,6 +325,22 @@ typedef struct plat_psci_ops {
 				int reset_type, u_register_t cookie);
 } plat_psci_ops_t;
 
+#if ENABLE_PSCI_STAT
+/*
+ * Contention statistics of the power domain locks at a power level, in ticks
+ * of the system counter.
+ */
+typedef struct psci_lock_stat {
+	/* Number of times a lock at this level has been acquired */
+	uint64_t acquisitions;
+	/* Total and maximum time spent waiting for the locks */
+	uint64_t wait_ticks;
+	uint64_t max_wait_ticks;
+	/* Number of times CPU_SUSPEND did not need the lock at this level */
+	uint64_t skipped;
+} psci_lock_stat_t;
+#endif
+
 /*******************************************************************************
  * Function & Data prototypes
  ******************************************************************************/
@@ -346,6 +362,9 @@ int psci_node_hw_state(u_register_t target_cpu,
 		       unsigned int power_level);
 int psci_features(unsigned int psci_fid);
 void __dead2 psci_power_down_wfi(void);
+#if ENABLE_PSCI_STAT
+int psci_get_lock_stat(unsigned int pwrlvl, psci_lock_stat_t *stat);
+#endif
 void psci_arch_setup(void);
 
 #endif /*__ASSEMBLY__*/
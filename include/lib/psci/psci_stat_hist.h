@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef PSCI_STAT_HIST_H
+#define PSCI_STAT_HIST_H
+
+#include <lib/utils_def.h>
+
+/*******************************************************************************
+ * Layout of the PSCI statistics histograms that are exported in the shared
+ * memory buffer at PLAT_PSCI_STAT_HIST_BASE when PSCI_STAT_HISTOGRAMS is
+ * enabled. The buffer starts with a 'psci_stat_hist_hdr_t', followed by
+ * 'num_nodes' records of 'record_size' bytes. The first 'num_cpus' records
+ * describe the CPU power domains, in the order of plat_my_core_pos(), and the
+ * others describe the non-CPU power domains.
+ *
+ * Each record is updated by a single CPU at a time. Its 'seq' field is odd
+ * while it is being updated and is incremented again once the update is
+ * complete, so a reader must retry if 'seq' is odd or changed while it was
+ * reading the record.
+ ******************************************************************************/
+#define PSCI_STAT_HIST_MAGIC		U(0x48545350)	/* "PSTH" */
+#define PSCI_STAT_HIST_VERSION		U(1)
+
+/*
+ * Residency and wake-up latency histograms in microseconds. Bucket 0 counts
+ * the values lower than 2, bucket N counts the values in [2^N, 2^(N+1)) and
+ * the last bucket also counts all the larger values.
+ */
+#define PSCI_STAT_HIST_BUCKETS		U(24)
+
+/*
+ * Number of interrupts whose wake-ups are counted separately. The last entry
+ * counts the wake-ups whose source is unknown or did not fit in the others.
+ * PSCI_STAT_HIST_UNKNOWN_SOURCE has the same value as INTR_ID_UNAVAILABLE.
+ */
+#define PSCI_STAT_HIST_WAKE_SOURCES	U(8)
+#define PSCI_STAT_HIST_UNKNOWN_SOURCE	U(0xFFFFFFFF)
+
+#define PSCI_STAT_HIST_NO_PARENT	U(0xFFFFFFFF)
+
+#ifndef __ASSEMBLY__
+
+#include <stdint.h>
+
+typedef struct psci_stat_hist_hdr {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t num_buckets;
+	uint16_t num_wake_sources;
+	uint16_t num_states;
+	uint32_t num_cpus;
+	uint32_t num_nodes;
+	uint32_t record_size;
+	uint64_t reserved;
+} psci_stat_hist_hdr_t;
+
+/* Histograms of one local power state of a power domain */
+typedef struct psci_stat_hist_state {
+	/* Time spent in the state */
+	uint64_t residency[PSCI_STAT_HIST_BUCKETS];
+	/*
+	 * Time from the start of the warm boot of the CPU that woke the power
+	 * domain up to the point where its statistics are updated. Not
+	 * recorded for the wake-ups from retention states.
+	 */
+	uint64_t wake_latency[PSCI_STAT_HIST_BUCKETS];
+} psci_stat_hist_state_t;
+
+typedef struct psci_stat_hist_wake_src {
+	uint32_t intr_id;
+	uint32_t reserved;
+	uint64_t count;
+} psci_stat_hist_wake_src_t;
+
+typedef struct psci_stat_hist_node {
+	uint32_t seq;
+	uint32_t pwr_lvl;
+	/* Index of the record of the parent power domain */
+	uint32_t parent;
+	uint32_t reserved;
+	/* MPIDR of the CPU, or 0 for a non-CPU power domain */
+	uint64_t mpidr;
+	psci_stat_hist_wake_src_t wake_src[PSCI_STAT_HIST_WAKE_SOURCES];
+	/* Histograms for each of the 'num_states' local power states */
+	psci_stat_hist_state_t state[];
+} psci_stat_hist_node_t;
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* PSCI_STAT_HIST_H */
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef XLAT_TABLES_AOT_H
+#define XLAT_TABLES_AOT_H
+
+/*
+ * Format of the translation tables that are generated at build time by the
+ * xlat_gen tool when XLAT_TABLES_AOT is enabled. This file is shared between
+ * the translation tables library and xlat_gen.
+ *
+ * The tool maps the static regions of a platform with the same algorithm as
+ * init_xlat_tables_ctx(). The result is a list of the valid entries of the
+ * tables instead of the tables themselves, since the addresses of the tables
+ * are only known at link time and the descriptor attributes depend on the
+ * translation regime, which is only known at run time. The library writes the
+ * entries into the tables of the context when it initializes them.
+ */
+
+#define XLAT_AOT_MAGIC			0x544f4158U	/* "XAOT" */
+
+/* Value of 'table' for the entries of the base table */
+#define XLAT_AOT_BASE_TABLE		0xFFFFU
+
+/* Types of entries */
+#define XLAT_AOT_ENTRY_BLOCK		1U
+#define XLAT_AOT_ENTRY_TABLE		2U
+
+#ifndef __ASSEMBLY__
+
+#include <stdint.h>
+
+/* Static region mapped by the generated tables, see mmap_region_t */
+typedef struct xlat_aot_region {
+	uint64_t	base_pa;
+	uint64_t	base_va;
+	uint64_t	size;
+	uint64_t	granularity;
+	uint32_t	attr;
+} xlat_aot_region_t;
+
+/* Valid entry of one of the generated tables */
+typedef struct xlat_aot_entry {
+	/* Index of the table in the context, or XLAT_AOT_BASE_TABLE */
+	uint16_t	table;
+	/* Index of the entry in the table */
+	uint16_t	index;
+	/*
+	 * For a block or page descriptor, index of the region that it maps.
+	 * For a table descriptor, index of the next level table.
+	 */
+	uint16_t	next;
+	/* Lookup level of the table */
+	uint8_t		level;
+	/* XLAT_AOT_ENTRY_BLOCK or XLAT_AOT_ENTRY_TABLE */
+	uint8_t		type;
+	/* Output address of a block or page descriptor */
+	uint64_t	pa;
+} xlat_aot_entry_t;
+
+typedef struct xlat_aot_tables {
+	uint32_t			magic;
+	/* Number of tables used, not counting the base table */
+	uint32_t			tables_num;
+	/* Size of the virtual address space the tables were generated for */
+	uint64_t			va_size;
+	uint32_t			regions_num;
+	uint32_t			entries_num;
+	const xlat_aot_region_t		*regions;
+	const xlat_aot_entry_t		*entries;
+	/* Number of regions mapped in each table, see xlat_ctx_t */
+	const int			*mapped_regions;
+} xlat_aot_tables_t;
+
+/* Generated by xlat_gen */
+extern const xlat_aot_tables_t xlat_aot_tables;
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* XLAT_TABLES_AOT_H */
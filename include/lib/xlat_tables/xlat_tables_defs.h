@@ -29,6 +29,8 @@
 #define PAGE_SIZE_64KB		U(65536)
 
 #define INVALID_DESC		U(0x0)
+/* Descriptors with this bit cleared are ignored by the hardware. */
+#define VALID_DESC		U(0x1)
 /*
  * A block descriptor points to a region of memory bigger than the granule size
  * (e.g. a 2MB region when the granule size is 4KB).
@@ -90,6 +92,13 @@
 #define XLAT_TABLE_ENTRIES	(U(1) << XLAT_TABLE_ENTRIES_SHIFT)
 #define XLAT_TABLE_ENTRIES_MASK	(XLAT_TABLE_ENTRIES - U(1))
 
+/*
+ * Number of consecutive block or page descriptors that can be marked with the
+ * contiguous hint so that they are cached as a single TLB entry. This value is
+ * for the 4KB translation granule.
+ */
+#define XLAT_CONT_ENTRIES	U(16)
+
 /* Values to convert a memory address to an index into a translation table */
 #define L3_XLAT_ADDRESS_SHIFT	PAGE_SIZE_SHIFT
 #define L2_XLAT_ADDRESS_SHIFT	(L3_XLAT_ADDRESS_SHIFT + XLAT_TABLE_ENTRIES_SHIFT)
@@ -209,6 +209,18 @@ typedef struct xlat_ctx xlat_ctx_t;
 void init_xlat_tables(void);
 void init_xlat_tables_ctx(xlat_ctx_t *ctx);
 
+#if XLAT_TABLES_AOT
+/*
+ * Same as init_xlat_tables_ctx(), but start from the tables generated at build
+ * time by xlat_gen for some of the static regions of the context. It falls back
+ * to init_xlat_tables_ctx() if they don't match the current list of mmap
+ * regions.
+ */
+struct xlat_aot_tables;
+void init_xlat_tables_aot_ctx(xlat_ctx_t *ctx,
+			      const struct xlat_aot_tables *aot);
+#endif
+
 /*
  * Fill all fields of a dynamic translation tables context. It must be done
  * either statically with REGISTER_XLAT_CONTEXT() or at runtime with this
@@ -237,6 +249,15 @@ void mmap_add_region_ctx(xlat_ctx_t *ctx, const mmap_region_t *mm);
 void mmap_add(const mmap_region_t *mm);
 void mmap_add_ctx(xlat_ctx_t *ctx, const mmap_region_t *mm);
 
+/*
+ * Same as mmap_add(), but the regions are checked and sorted all at once
+ * instead of one at a time, which is faster for large arrays of regions. The
+ * regions can be in any order. The regions that overlap must be nested within
+ * each other with no more than 8 levels of nesting.
+ */
+void mmap_add_bulk(const mmap_region_t *mm);
+void mmap_add_bulk_ctx(xlat_ctx_t *ctx, const mmap_region_t *mm);
+
 /*
  * Add a region with defined base PA. Returns base VA calculated using the
  * highest existing region in the mmap array even if it fails to allocate the
@@ -345,6 +366,19 @@ int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 				   size_t size, uint32_t attr);
 int xlat_change_mem_attributes(uintptr_t base_va, size_t size, uint32_t attr);
 
+/*
+ * Get the number of successful calls to xlat_change_mem_attributes_ctx(), for
+ * all the translation contexts, and the number of TLB maintenance operations
+ * that they have issued. A TLBI range operation or a TLBI of the whole
+ * translation regime counts as one operation.
+ *
+ * NOTE: The counters are updated without any locking, like the translation
+ * tables, so concurrent calls of xlat_change_mem_attributes_ctx() on different
+ * contexts may not all be accounted for.
+ */
+void xlat_get_change_mem_attributes_stat(unsigned long long *calls,
+					 unsigned long long *tlbi_ops);
+
 /*
  * Query the memory attributes of a memory page in a set of translation tables.
  *
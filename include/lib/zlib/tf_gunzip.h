@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -10,7 +10,17 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <common/image_decompress.h>
+
 int gunzip(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
 	   size_t out_len, uintptr_t work_buf, size_t work_len);
 
+int gunzip_stream_init(uintptr_t out_buf, size_t out_len, uintptr_t work_buf,
+		       size_t work_len);
+int gunzip_stream_update(uintptr_t in_buf, size_t in_len);
+int gunzip_stream_finish(uintptr_t *out_buf);
+
+/* Streaming decompressor for image_decompress_stream_init() */
+extern const stream_decompressor_t gunzip_stream_decompressor;
+
 #endif /* TF_GUNZIP_H */
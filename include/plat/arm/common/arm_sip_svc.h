@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -19,8 +19,20 @@
 /* Function ID for requesting state switch of lower EL */
 #define ARM_SIP_SVC_EXE_STATE_SWITCH	U(0x82000020)
 
+/*
+ * Function ID for reading the contention statistics of the PSCI locks. Unlike
+ * the other calls, it only has an SMC64 variant because the statistics are
+ * 64-bit values.
+ */
+/*					U(0x82000021) is reserved */
+#define ARM_SIP_SVC_PSCI_LOCK_STAT64	U(0xc2000021)
+
+/* Function ID for reading the SMC dispatch statistics, SMC64 like the above */
+/*					U(0x82000022) is reserved */
+#define ARM_SIP_SVC_SMC_DISPATCH_STAT64	U(0xc2000022)
+
 /* ARM SiP Service Calls version numbers */
 #define ARM_SIP_SVC_VERSION_MAJOR		U(0x0)
-#define ARM_SIP_SVC_VERSION_MINOR		U(0x2)
+#define ARM_SIP_SVC_VERSION_MINOR		U(0x3)
 
 #endif /* ARM_SIP_SVC_H */
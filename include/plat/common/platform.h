@@ -262,6 +262,8 @@ int plat_get_nv_ctr(void *cookie, unsigned int *nv_ctr);
 int plat_set_nv_ctr(void *cookie, unsigned int nv_ctr);
 int plat_set_nv_ctr2(void *cookie, const struct auth_img_desc_s *img_desc,
 		unsigned int nv_ctr);
+int plat_get_auth_cache(void **cache_ptr, size_t *cache_size);
+int plat_get_auth_cache_key(void **key_ptr, unsigned int *key_len);
 
 /*******************************************************************************
  * Secure Partitions functions
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,6 +7,7 @@
 #ifndef SDEI_H
 #define SDEI_H
 
+#include <lib/cassert.h>
 #include <lib/spinlock.h>
 #include <lib/utils_def.h>
 
@@ -85,6 +86,14 @@
 #define SDEI_MAPF_NORMAL	0
 #define SDEI_MAPF_CRITICAL	BIT(SDEI_MAPF_CRITICAL_SHIFT_)
 
+/*
+ * Log2 of the number of slots of the tables that index the event maps by event
+ * number and by interrupt. At most three quarters of the slots can be used, so
+ * this also limits the number of event maps that a platform can register.
+ */
+#define SDEI_MAP_INDEX_BITS	8U
+#define SDEI_MAX_MAPS		(((1U << SDEI_MAP_INDEX_BITS) * 3U) / 4U)
+
 /* Indices of private and shared mappings */
 #define SDEI_MAP_IDX_PRIV_	0U
 #define SDEI_MAP_IDX_SHRD_	1U
@@ -124,6 +133,8 @@
  * declared. Only then would ARRAY_SIZE() yield a meaningful value.
  */
 #define REGISTER_SDEI_MAP(_private, _shared) \
+	CASSERT((ARRAY_SIZE(_private) + ARRAY_SIZE(_shared)) <= \
+		SDEI_MAX_MAPS, assert_sdei_map_count); \
 	sdei_entry_t sdei_private_event_table \
 		[PLATFORM_CORE_COUNT * ARRAY_SIZE(_private)]; \
 	sdei_entry_t sdei_shared_event_table[ARRAY_SIZE(_shared)]; \
@@ -166,18 +177,21 @@ typedef struct sdei_mapping {
 } sdei_mapping_t;
 
 /* Handler to be called to handle SDEI smc calls */
-uint64_t sdei_smc_handler(uint32_t smc_fid,
-		uint64_t x1,
-		uint64_t x2,
-		uint64_t x3,
-		uint64_t x4,
+uintptr_t sdei_smc_handler(uint32_t smc_fid,
+		u_register_t x1,
+		u_register_t x2,
+		u_register_t x3,
+		u_register_t x4,
 		void *cookie,
 		void *handle,
-		uint64_t flags);
+		u_register_t flags);
 
 void sdei_init(void);
 
 /* Public API to dispatch an event to Normal world */
 int sdei_dispatch_event(int ev_num);
 
+/* Public API to signal event 0 to a set of PEs */
+int sdei_signal_pes(const u_register_t *target_pes, unsigned int num_pes);
+
 #endif /* SDEI_H */
@@ -26,6 +26,86 @@
 #include <smccc_helpers.h>
 
 
+#if IMAGE_BL31 && CTX_FPREGS_LAZY
+/*
+ * Security state whose FP registers are live in the hardware of each CPU, plus
+ * one. Zero means that the FP registers do not belong to either world, e.g.
+ * after the CPU has been powered down.
+ */
+#define FPREGS_NO_OWNER		U(0)
+#define FPREGS_OWNER(_state)	((_state) + U(1))
+
+static unsigned int fpregs_owner[PLATFORM_CORE_COUNT];
+
+/* Let EL3, and lower ELs after the next ERET, access the FP registers */
+static void fpregs_enable_access(void)
+{
+	write_cptr_el3(read_cptr_el3() & ~TFP_BIT);
+	isb();
+}
+
+/*
+ * Called when entering a security state. Accesses to the FP registers are only
+ * allowed if that security state owns them, otherwise they trap to
+ * cm_handle_fpregs_trap().
+ */
+static void fpregs_lazy_enter(uint32_t security_state)
+{
+	u_register_t cptr = read_cptr_el3();
+
+	if (fpregs_owner[plat_my_core_pos()] == FPREGS_OWNER(security_state))
+		cptr &= ~TFP_BIT;
+	else
+		cptr |= TFP_BIT;
+
+	/* No explicit ISB required here as ERET covers it */
+	write_cptr_el3(cptr);
+}
+
+/*
+ * Called when the Non-secure context of a CPU is initialized, which happens
+ * when it is about to be powered on or down. The FP registers of the Secure
+ * world are saved if they are live on the current CPU, since the Non-secure
+ * world cannot rely on their content after a power cycle anyway.
+ */
+static void fpregs_lazy_reset(unsigned int cpu_idx)
+{
+	if ((cpu_idx == plat_my_core_pos()) &&
+	    (fpregs_owner[cpu_idx] == FPREGS_OWNER(SECURE))) {
+		fpregs_enable_access();
+		fpregs_context_save(get_fpregs_ctx(cm_get_context(SECURE)));
+	}
+
+	fpregs_owner[cpu_idx] = FPREGS_NO_OWNER;
+}
+
+/*******************************************************************************
+ * Handler of the FP/SIMD access traps set up when CTX_FPREGS_LAZY is enabled.
+ * It saves the FP registers of the world that owns them, if any, and restores
+ * those of the world that trapped, which then owns them.
+ ******************************************************************************/
+void cm_handle_fpregs_trap(void)
+{
+	unsigned int cpu_idx = plat_my_core_pos();
+	unsigned int owner = fpregs_owner[cpu_idx];
+	uint32_t security_state;
+
+	security_state = ((read_scr_el3() & SCR_NS_BIT) != 0U) ?
+			 NON_SECURE : SECURE;
+
+	fpregs_enable_access();
+
+	if (owner == FPREGS_OWNER(security_state))
+		return;
+
+	if (owner != FPREGS_NO_OWNER)
+		fpregs_context_save(get_fpregs_ctx(cm_get_context(owner - U(1))));
+
+	fpregs_context_restore(get_fpregs_ctx(cm_get_context(security_state)));
+	fpregs_owner[cpu_idx] = FPREGS_OWNER(security_state);
+}
+#endif /* IMAGE_BL31 && CTX_FPREGS_LAZY */
+
 /*******************************************************************************
  * Context management library initialisation routine. This library is used by
  * runtime services to share pointers to 'cpu_context' structures for the secure
@@ -287,6 +367,11 @@ void cm_init_context_by_index(unsigned int cpu_idx,
 	cpu_context_t *ctx;
 	ctx = cm_get_context_by_index(cpu_idx, GET_SECURITY_STATE(ep->h.attr));
 	cm_setup_context(ctx, ep);
+
+#if IMAGE_BL31 && CTX_FPREGS_LAZY
+	if (GET_SECURITY_STATE(ep->h.attr) == NON_SECURE)
+		fpregs_lazy_reset(cpu_idx);
+#endif
 }
 
 /*******************************************************************************
@@ -299,6 +384,11 @@ void cm_init_my_context(const entry_point_info_t *ep)
 	cpu_context_t *ctx;
 	ctx = cm_get_context(GET_SECURITY_STATE(ep->h.attr));
 	cm_setup_context(ctx, ep);
+
+#if IMAGE_BL31 && CTX_FPREGS_LAZY
+	if (GET_SECURITY_STATE(ep->h.attr) == NON_SECURE)
+		fpregs_lazy_reset(plat_my_core_pos());
+#endif
 }
 
 /*******************************************************************************
@@ -493,18 +583,36 @@ void cm_prepare_el3_exit(uint32_t security_state)
 }
 
 /*******************************************************************************
- * The next four functions are used by runtime services to save and restore
+ * The next two functions are used by runtime services to save and restore
  * EL1 context on the 'cpu_context' structure for the specified security
  * state.
  ******************************************************************************/
 void cm_el1_sysregs_context_save(uint32_t security_state)
+{
+	cm_el1_sysregs_context_save_mask(security_state, CTX_EL1_REGS_ALL);
+}
+
+void cm_el1_sysregs_context_restore(uint32_t security_state)
+{
+	cm_el1_sysregs_context_restore_mask(security_state, CTX_EL1_REGS_ALL);
+}
+
+/*******************************************************************************
+ * As above, but only the groups of EL1 registers selected by the
+ * CTX_EL1_REGS_* flags in 'mask' are saved or restored. A Secure Payload
+ * Dispatcher can use these to only switch the registers that its Secure
+ * Payload uses. The other registers keep the values of the Normal world while
+ * the Secure Payload runs, so it must neither depend on nor modify them.
+ ******************************************************************************/
+void cm_el1_sysregs_context_save_mask(uint32_t security_state,
+				      unsigned int mask)
 {
 	cpu_context_t *ctx;
 
 	ctx = cm_get_context(security_state);
 	assert(ctx != NULL);
 
-	el1_sysregs_context_save(get_sysregs_ctx(ctx));
+	el1_sysregs_context_save_mask(get_sysregs_ctx(ctx), mask);
 
 #if IMAGE_BL31
 	if (security_state == SECURE)
@@ -514,16 +622,21 @@ void cm_el1_sysregs_context_save(uint32_t security_state)
 #endif
 }
 
-void cm_el1_sysregs_context_restore(uint32_t security_state)
+void cm_el1_sysregs_context_restore_mask(uint32_t security_state,
+					 unsigned int mask)
 {
 	cpu_context_t *ctx;
 
 	ctx = cm_get_context(security_state);
 	assert(ctx != NULL);
 
-	el1_sysregs_context_restore(get_sysregs_ctx(ctx));
+	el1_sysregs_context_restore_mask(get_sysregs_ctx(ctx), mask);
 
 #if IMAGE_BL31
+#if CTX_FPREGS_LAZY
+	fpregs_lazy_enter(security_state);
+#endif
+
 	if (security_state == SECURE)
 		PUBLISH_EVENT(cm_entering_secure_world);
 	else
@@ -28,6 +28,15 @@ LIBC_SRCS	:=	$(addprefix lib/libc/,		\
 ifeq (${ARCH},aarch64)
 LIBC_SRCS	+=	$(addprefix lib/libc/aarch64/,	\
 			setjmp.S)
+
+ifeq (${USE_OPTIMIZED_MEMFUNCS},1)
+LIBC_SRCS	:=	$(filter-out $(addprefix lib/libc/,memcpy.c memmove.c memset.c), \
+			${LIBC_SRCS})
+LIBC_SRCS	+=	$(addprefix lib/libc/aarch64/,	\
+			memcpy.S			\
+			memmove.S			\
+			memset.S)
+endif
 endif
 
 INCLUDES	+=	-Iinclude/lib/libc		\
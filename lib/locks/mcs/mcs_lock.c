@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <lib/mcs_lock.h>
+#include <plat/common/platform.h>
+
+/*
+ * Functions in this file implement the MCS queue lock (Mellor-Crummey and
+ * Scott). Unlike bakery locks, acquiring an MCS lock doesn't need to look at
+ * the state of every CPU: a contender appends its node to the queue of the lock
+ * with a single atomic swap, and then waits until the previous CPU in the
+ * queue hands the lock over by writing to its node. The nodes are in cache
+ * lines of their own, so the waiters don't generate any traffic on the cache
+ * lines of the other contenders.
+ *
+ * Each CPU has MCS_LOCK_MAX_NESTING nodes, so that it can hold or wait for
+ * several locks at the same time. The tail of a lock and the next field of a
+ * node identify a node by its index in mcs_nodes plus one, so that
+ * MCS_NODE_NONE can be used as the empty value.
+ */
+
+static mcs_node_t mcs_nodes[PLATFORM_CORE_COUNT * MCS_LOCK_MAX_NESTING];
+
+static inline uint32_t mcs_node_id(int idx)
+{
+	return (uint32_t)idx + 1U;
+}
+
+static inline mcs_node_t *mcs_node_get(uint32_t id)
+{
+	assert((id != MCS_NODE_NONE) && (id <= ARRAY_SIZE(mcs_nodes)));
+
+	return &mcs_nodes[id - 1U];
+}
+
+/*
+ * Returns the index of the node that the current CPU uses for the given lock,
+ * or of a free node if 'lock' is NULL. Returns -1 if there is no such node.
+ */
+static int mcs_node_find(const mcs_lock_t *lock)
+{
+	unsigned int first = plat_my_core_pos() * MCS_LOCK_MAX_NESTING;
+
+	for (unsigned int i = first; i < (first + MCS_LOCK_MAX_NESTING); i++) {
+		if (mcs_nodes[i].lock == lock)
+			return (int)i;
+	}
+
+	return -1;
+}
+
+void mcs_lock_get(mcs_lock_t *lock)
+{
+	int idx;
+	uint32_t prev;
+	mcs_node_t *node;
+
+	assert(lock != NULL);
+
+	/* Prevent recursive acquisition */
+	assert(mcs_node_find(lock) < 0);
+
+	idx = mcs_node_find(NULL);
+
+	/* The CPU is using more than MCS_LOCK_MAX_NESTING locks */
+	assert(idx >= 0);
+
+	node = &mcs_nodes[idx];
+	node->lock = lock;
+	node->next = MCS_NODE_NONE;
+	node->locked = 1U;
+
+	/*
+	 * Add the node to the queue. The swap has release semantics, so the
+	 * previous CPU in the queue sees the initialized node.
+	 */
+	prev = mcs_lock_swap(&lock->tail, mcs_node_id(idx));
+	if (prev == MCS_NODE_NONE)
+		return;
+
+	/* Link the node to the previous one and wait for the lock. */
+	mcs_lock_store_release(&mcs_node_get(prev)->next, mcs_node_id(idx));
+	mcs_lock_wait_while(&node->locked, 1U);
+}
+
+void mcs_lock_release(mcs_lock_t *lock)
+{
+	int idx;
+	mcs_node_t *node;
+
+	assert(lock != NULL);
+
+	idx = mcs_node_find(lock);
+
+	/* The CPU must hold the lock */
+	assert(idx >= 0);
+
+	node = &mcs_nodes[idx];
+
+	if (node->next == MCS_NODE_NONE) {
+		/* If there are no waiters, mark the lock as free. */
+		if (mcs_lock_cas(&lock->tail, mcs_node_id(idx), MCS_NODE_NONE) ==
+		    mcs_node_id(idx)) {
+			node->lock = NULL;
+			return;
+		}
+
+		/*
+		 * Another CPU has added its node to the queue, but it hasn't
+		 * linked it to this one yet.
+		 */
+		mcs_lock_wait_while(&node->next, MCS_NODE_NONE);
+	}
+
+	/* Hand the lock over to the next CPU in the queue. */
+	mcs_lock_store_release(&mcs_node_get(node->next)->locked, 0U);
+
+	node->lock = NULL;
+}
@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Decompressor for the LZ4 frame format, as produced by "lz4 -9".
+ *
+ * Only a single frame is decompressed and the data following it is ignored.
+ * Dictionaries are not supported. The block and content checksums are skipped
+ * rather than verified, since the integrity of the compressed images is
+ * expected to be checked by Trusted Board Boot.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <common/debug.h>
+#include <tf_lz4.h>
+
+#define LZ4_FRAME_MAGIC		0x184D2204U
+
+/* Frame descriptor FLG byte */
+#define LZ4_FLG_VERSION_SHIFT	6
+#define LZ4_FLG_VERSION_MASK	0x3U
+#define LZ4_FLG_VERSION		0x1U
+#define LZ4_FLG_BLOCK_CSUM	(1U << 4)
+#define LZ4_FLG_CONTENT_SIZE	(1U << 3)
+#define LZ4_FLG_CONTENT_CSUM	(1U << 2)
+#define LZ4_FLG_RESERVED	(1U << 1)
+#define LZ4_FLG_DICT_ID		(1U << 0)
+
+/* Frame descriptor BD byte */
+#define LZ4_BD_BLOCK_MAX_SHIFT	4
+#define LZ4_BD_BLOCK_MAX_MASK	0x7U
+#define LZ4_BD_RESERVED		0x8FU
+
+#define LZ4_BLOCK_UNCOMPRESSED	(1U << 31)
+
+#define LZ4_MIN_MATCH		4U
+#define LZ4_RUN_MASK		0xFU
+
+/* XXH32 constants, used to check the frame descriptor */
+#define XXH_PRIME32_1		0x9E3779B1U
+#define XXH_PRIME32_2		0x85EBCA77U
+#define XXH_PRIME32_3		0xC2B2AE3DU
+#define XXH_PRIME32_4		0x27D4EB2FU
+#define XXH_PRIME32_5		0x165667B1U
+
+static uint32_t lz4_read_le32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+	       ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t xxh_rotl32(uint32_t x, unsigned int r)
+{
+	return (x << r) | (x >> (32U - r));
+}
+
+/*
+ * XXH32 with seed 0 of an input shorter than 16 bytes, which is all that the
+ * frame descriptor checksum needs.
+ */
+static uint32_t xxh32_short(const uint8_t *p, size_t len)
+{
+	const uint8_t *end = p + len;
+	uint32_t h = XXH_PRIME32_5 + (uint32_t)len;
+
+	for (; p + 4 <= end; p += 4) {
+		h += lz4_read_le32(p) * XXH_PRIME32_3;
+		h = xxh_rotl32(h, 17) * XXH_PRIME32_4;
+	}
+
+	for (; p < end; p++) {
+		h += *p * XXH_PRIME32_5;
+		h = xxh_rotl32(h, 11) * XXH_PRIME32_1;
+	}
+
+	h ^= h >> 15;
+	h *= XXH_PRIME32_2;
+	h ^= h >> 13;
+	h *= XXH_PRIME32_3;
+	h ^= h >> 16;
+
+	return h;
+}
+
+/*
+ * Read the extension of a literal or match length encoded as a sequence of
+ * bytes terminated by a byte other than 255.
+ */
+static int lz4_read_length(const uint8_t **ip, const uint8_t *ip_end,
+			   size_t *len)
+{
+	uint8_t b;
+
+	do {
+		if (*ip >= ip_end)
+			return -EIO;
+		b = *(*ip)++;
+		*len += b;
+	} while (b == 255U);
+
+	return 0;
+}
+
+/*
+ * Decompress one block. Matches may refer to the output of the previous blocks
+ * of the frame, since the whole output is contiguous.
+ */
+static int lz4_decompress_block(const uint8_t *ip, size_t in_len,
+				const uint8_t *out_start, uint8_t **out,
+				const uint8_t *out_end)
+{
+	const uint8_t *ip_end = ip + in_len;
+	uint8_t *op = *out;
+	const uint8_t *match;
+	size_t len, offset;
+	uint8_t token;
+
+	for (;;) {
+		if (ip >= ip_end)
+			return -EIO;
+		token = *ip++;
+
+		/* Literals */
+		len = token >> 4;
+		if ((len == LZ4_RUN_MASK) &&
+		    (lz4_read_length(&ip, ip_end, &len) != 0))
+			return -EIO;
+		if ((len > (size_t)(ip_end - ip)) ||
+		    (len > (size_t)(out_end - op)))
+			return -EIO;
+		memcpy(op, ip, len);
+		op += len;
+		ip += len;
+
+		/* The last sequence of a block only has literals */
+		if (ip == ip_end)
+			break;
+
+		/* Match */
+		if ((ip_end - ip) < 2)
+			return -EIO;
+		offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+		ip += 2;
+		if ((offset == 0U) || (offset > (size_t)(op - out_start)))
+			return -EIO;
+
+		len = token & LZ4_RUN_MASK;
+		if ((len == LZ4_RUN_MASK) &&
+		    (lz4_read_length(&ip, ip_end, &len) != 0))
+			return -EIO;
+		len += LZ4_MIN_MATCH;
+		if (len > (size_t)(out_end - op))
+			return -EIO;
+
+		match = op - offset;
+		if (offset >= len) {
+			memcpy(op, match, len);
+			op += len;
+		} else {
+			/* Overlapping match: repeat the last 'offset' bytes */
+			while (len-- != 0U)
+				*op++ = *match++;
+		}
+	}
+
+	*out = op;
+
+	return 0;
+}
+
+/*
+ * lz4_decompress - decompress LZ4 frame data
+ * @in_buf: source of compressed input. Upon exit, the end of input.
+ * @in_len: length of in_buf
+ * @out_buf: destination of decompressed output. Upon exit, the end of output.
+ * @out_len: length of out_buf
+ * @work_buf: workspace (unused)
+ * @work_len: length of workspace (unused)
+ */
+int lz4_decompress(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+		   size_t out_len, uintptr_t work_buf, size_t work_len)
+{
+	const uint8_t *ip = (const uint8_t *)*in_buf;
+	const uint8_t *ip_end = ip + in_len;
+	const uint8_t *desc;
+	uint8_t *out_start = (uint8_t *)*out_buf;
+	uint8_t *op = out_start;
+	uint8_t *out_end = out_start + out_len;
+	uint64_t content_size = 0U;
+	uint32_t block_size;
+	uint8_t flg, bd;
+	size_t desc_len;
+	int ret;
+
+	/* Magic number and the fixed part of the frame descriptor */
+	if ((in_len < 7U) || (lz4_read_le32(ip) != LZ4_FRAME_MAGIC)) {
+		ERROR("lz4: not an LZ4 frame\n");
+		return -EIO;
+	}
+	ip += 4;
+
+	desc = ip;
+	flg = desc[0];
+	bd = desc[1];
+	if ((((flg >> LZ4_FLG_VERSION_SHIFT) & LZ4_FLG_VERSION_MASK) !=
+	     LZ4_FLG_VERSION) || ((flg & LZ4_FLG_RESERVED) != 0U) ||
+	    ((bd & LZ4_BD_RESERVED) != 0U) ||
+	    (((bd >> LZ4_BD_BLOCK_MAX_SHIFT) & LZ4_BD_BLOCK_MAX_MASK) < 4U)) {
+		ERROR("lz4: unsupported frame descriptor\n");
+		return -EIO;
+	}
+	if ((flg & LZ4_FLG_DICT_ID) != 0U) {
+		ERROR("lz4: dictionaries are not supported\n");
+		return -EIO;
+	}
+
+	desc_len = 2U;
+	if ((flg & LZ4_FLG_CONTENT_SIZE) != 0U)
+		desc_len += 8U;
+	if ((size_t)(ip_end - desc) < (desc_len + 1U))
+		return -EIO;
+	if ((flg & LZ4_FLG_CONTENT_SIZE) != 0U)
+		content_size = lz4_read_le32(desc + 2) |
+			       ((uint64_t)lz4_read_le32(desc + 6) << 32);
+
+	if (((xxh32_short(desc, desc_len) >> 8) & 0xFFU) != desc[desc_len]) {
+		ERROR("lz4: corrupted frame descriptor\n");
+		return -EIO;
+	}
+	ip = desc + desc_len + 1U;
+
+	if (content_size > out_len) {
+		ERROR("lz4: output buffer too small\n");
+		return -ENOMEM;
+	}
+
+	/* Data blocks, terminated by a zero-sized block */
+	for (;;) {
+		if ((ip_end - ip) < 4)
+			return -EIO;
+		block_size = lz4_read_le32(ip);
+		ip += 4;
+		if (block_size == 0U)
+			break;
+
+		if ((block_size & LZ4_BLOCK_UNCOMPRESSED) != 0U) {
+			block_size &= ~LZ4_BLOCK_UNCOMPRESSED;
+			if ((block_size > (size_t)(ip_end - ip)) ||
+			    (block_size > (size_t)(out_end - op)))
+				return -EIO;
+			memcpy(op, ip, block_size);
+			op += block_size;
+		} else {
+			if (block_size > (size_t)(ip_end - ip))
+				return -EIO;
+			ret = lz4_decompress_block(ip, block_size, out_start,
+						   &op, out_end);
+			if (ret != 0) {
+				ERROR("lz4: corrupted block\n");
+				return ret;
+			}
+		}
+		ip += block_size;
+
+		if ((flg & LZ4_FLG_BLOCK_CSUM) != 0U) {
+			if ((ip_end - ip) < 4)
+				return -EIO;
+			ip += 4;
+		}
+	}
+
+	if ((flg & LZ4_FLG_CONTENT_CSUM) != 0U) {
+		if ((ip_end - ip) < 4)
+			return -EIO;
+		ip += 4;
+	}
+
+	if (((flg & LZ4_FLG_CONTENT_SIZE) != 0U) &&
+	    (content_size != (uint64_t)(op - out_start))) {
+		ERROR("lz4: content size mismatch\n");
+		return -EIO;
+	}
+
+	VERBOSE("lz4: %lu byte input\n", (unsigned long)((uintptr_t)ip - *in_buf));
+	VERBOSE("lz4: %lu byte output\n", (unsigned long)(op - out_start));
+
+	*in_buf = (uintptr_t)ip;
+	*out_buf = (uintptr_t)op;
+
+	return 0;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -66,6 +66,10 @@ int pmf_setup(void)
 
 	assert(pmf_svc_descs_num < PMF_SVC_DESCS_MAX);
 
+#if PMF_RING_BUFFERS
+	pmf_ring_setup();
+#endif
+
 	pmf_svc_descs = (pmf_svc_desc_t *) PMF_SVC_DESCS_START;
 	for (ii = 0; ii < pmf_svc_descs_num; ii++) {
 
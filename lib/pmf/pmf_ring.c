@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <lib/pmf/pmf.h>
+#include <lib/pmf/pmf_ring.h>
+#include <lib/utils.h>
+#include <lib/utils_def.h>
+#include <plat/common/platform.h>
+
+/*
+ * The ring buffers are written directly in the shared memory buffer, see
+ * pmf_ring.h for its layout. Each CPU is the only writer of its ring, so no
+ * locks are needed.
+ */
+#define PMF_RING_HDR_SIZE	round_up(sizeof(pmf_ring_hdr_t),	\
+					 CACHE_WRITEBACK_GRANULE)
+
+CASSERT(PLAT_PMF_RING_SIZE > (PMF_RING_HDR_SIZE + (PLATFORM_CORE_COUNT *
+	(sizeof(pmf_ring_t) + sizeof(pmf_ring_entry_t)))),
+	assert_pmf_ring_buffer_size);
+
+/* Number of entries of each ring, a power of two */
+static unsigned int pmf_ring_entries;
+
+/* Size of each ring, a multiple of the cache line size */
+static size_t pmf_ring_size;
+
+static inline pmf_ring_t *pmf_ring_get(unsigned int cpuid)
+{
+	assert(cpuid < PLATFORM_CORE_COUNT);
+
+	return (pmf_ring_t *)(PLAT_PMF_RING_BASE + PMF_RING_HDR_SIZE +
+			      (cpuid * pmf_ring_size));
+}
+
+/*
+ * Initialize the header of the shared memory buffer and empty all the rings.
+ * Each ring gets the largest number of entries that is a power of two and that
+ * fits in its share of the buffer.
+ */
+void pmf_ring_setup(void)
+{
+	pmf_ring_hdr_t *hdr = (pmf_ring_hdr_t *)PLAT_PMF_RING_BASE;
+	size_t max_size = (PLAT_PMF_RING_SIZE - PMF_RING_HDR_SIZE) /
+			  PLATFORM_CORE_COUNT;
+	unsigned int entries = 1U;
+
+	while ((sizeof(pmf_ring_t) + (2U * entries * sizeof(pmf_ring_entry_t)))
+	       <= max_size) {
+		entries *= 2U;
+	}
+
+	pmf_ring_entries = entries;
+	pmf_ring_size = round_up(sizeof(pmf_ring_t) +
+				 (entries * sizeof(pmf_ring_entry_t)),
+				 CACHE_WRITEBACK_GRANULE);
+	assert((PMF_RING_HDR_SIZE + (PLATFORM_CORE_COUNT * pmf_ring_size)) <=
+	       PLAT_PMF_RING_SIZE);
+
+	zeromem((void *)PLAT_PMF_RING_BASE, PLAT_PMF_RING_SIZE);
+
+	hdr->version = PMF_RING_VERSION;
+	hdr->num_cpus = PLATFORM_CORE_COUNT;
+	hdr->num_entries = entries;
+	hdr->ring_offset = PMF_RING_HDR_SIZE;
+	hdr->ring_size = (uint32_t)pmf_ring_size;
+	hdr->freq = read_cntfrq_el0();
+
+	for (unsigned int i = 0U; i < PLATFORM_CORE_COUNT; i++) {
+		pmf_ring_t *ring = pmf_ring_get(i);
+
+		for (unsigned int j = 0U; j < entries; j++)
+			ring->entries[j].seq = PMF_RING_SEQ_INVALID;
+	}
+
+	/* The magic value tells the readers that the buffer is valid */
+	dmbish();
+	hdr->magic = PMF_RING_MAGIC;
+
+	flush_dcache_range(PLAT_PMF_RING_BASE, PLAT_PMF_RING_SIZE);
+
+	/* The geometry is also read with the data cache disabled */
+	flush_dcache_range((uintptr_t)&pmf_ring_entries,
+			   sizeof(pmf_ring_entries));
+	flush_dcache_range((uintptr_t)&pmf_ring_size, sizeof(pmf_ring_size));
+
+	INFO("PMF: %u ring buffer entries per CPU at 0x%lx\n", entries,
+	     (unsigned long)PLAT_PMF_RING_BASE);
+}
+
+/* Returns true if the data cache is enabled at the current exception level */
+static inline bool pmf_ring_dcache_enabled(void)
+{
+#ifdef AARCH32
+	return (read_sctlr() & SCTLR_C_BIT) != 0U;
+#else
+	return (read_sctlr_el3() & SCTLR_C_BIT) != 0U;
+#endif
+}
+
+/*
+ * Append a time-stamp to the ring of the current CPU. 'tid' includes the
+ * service ID. If 'cache_maint' is true, the entry and the head of the ring are
+ * flushed for the readers that don't see the caches of this CPU.
+ *
+ * Some time-stamps are captured with the data cache disabled, in which case the
+ * accesses go straight to memory. The cache lines that hold the head and the
+ * entry are then cleaned and invalidated first, so that the head is read from
+ * memory and that no stale copy of them is written back over the update later.
+ */
+void __pmf_ring_store_timestamp(unsigned int tid, unsigned long long ts,
+				bool cache_maint)
+{
+	pmf_ring_t *ring;
+	pmf_ring_entry_t *entry;
+	uint64_t seq;
+	bool dcache_off = !pmf_ring_dcache_enabled();
+
+	/* Drop the events captured before the rings are set up */
+	if (pmf_ring_entries == 0U)
+		return;
+
+	ring = pmf_ring_get(plat_my_core_pos());
+	if (dcache_off)
+		flush_dcache_range((uintptr_t)&ring->head, sizeof(ring->head));
+
+	seq = ring->head;
+	entry = &ring->entries[seq & (pmf_ring_entries - 1U)];
+	if (dcache_off)
+		flush_dcache_range((uintptr_t)entry, sizeof(pmf_ring_entry_t));
+
+	entry->seq = PMF_RING_SEQ_INVALID;
+	dmbishst();
+	entry->ts = ts;
+	entry->tid = tid;
+	dmbishst();
+	entry->seq = seq;
+	dmbishst();
+	ring->head = seq + 1U;
+
+	if (cache_maint && !dcache_off) {
+		flush_dcache_range((uintptr_t)entry, sizeof(pmf_ring_entry_t));
+		flush_dcache_range((uintptr_t)&ring->head, sizeof(ring->head));
+	}
+}
+
+/* Returns the location of the shared memory buffer with the rings */
+int pmf_ring_get_buffer(uintptr_t *base, size_t *size)
+{
+	if (pmf_ring_entries == 0U)
+		return -ENODEV;
+
+	*base = PLAT_PMF_RING_BASE;
+	*size = PLAT_PMF_RING_SIZE;
+
+	return 0;
+}
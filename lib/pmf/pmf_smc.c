@@ -1,10 +1,12 @@
 /*
- * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <assert.h>
+#include <errno.h>
+#include <stdint.h>
 
 #include <common/debug.h>
 #include <lib/pmf/pmf.h>
@@ -25,6 +27,10 @@ uintptr_t pmf_smc_handler(unsigned int smc_fid,
 {
 	int rc;
 	unsigned long long ts_value;
+#if PMF_RING_BUFFERS
+	uintptr_t ring_base = 0U;
+	size_t ring_size = 0U;
+#endif
 
 	if (((smc_fid >> FUNCID_CC_SHIFT) & FUNCID_CC_MASK) == SMC_32) {
 
@@ -44,6 +50,27 @@ uintptr_t pmf_smc_handler(unsigned int smc_fid,
 			SMC_RET3(handle, rc, (uint32_t)ts_value,
 					(uint32_t)(ts_value >> 32));
 		}
+#if PMF_RING_BUFFERS
+		if (smc_fid == PMF_SMC_GET_RING_BUFFER_32) {
+			/*
+			 * Return error code and the location of the
+			 * ring buffers to the caller.
+			 * x0 --> error code.
+			 * x1 --> base address.
+			 * x2 --> size.
+			 * The buffer must be entirely below 4GB.
+			 */
+			rc = pmf_ring_get_buffer(&ring_base, &ring_size);
+			if ((rc == 0) && (((uint64_t)ring_base + ring_size) >
+					  (UINT32_MAX + 1ULL))) {
+				rc = -EINVAL;
+				ring_base = 0U;
+				ring_size = 0U;
+			}
+			SMC_RET3(handle, rc, (uint32_t)ring_base,
+					(uint32_t)ring_size);
+		}
+#endif
 	} else {
 		if (smc_fid == PMF_SMC_GET_TIMESTAMP_64) {
 			/*
@@ -56,6 +83,19 @@ uintptr_t pmf_smc_handler(unsigned int smc_fid,
 					(unsigned int)x3, &ts_value);
 			SMC_RET2(handle, rc, ts_value);
 		}
+#if PMF_RING_BUFFERS
+		if (smc_fid == PMF_SMC_GET_RING_BUFFER_64) {
+			/*
+			 * Return error code and the location of the
+			 * ring buffers to the caller.
+			 * x0 --> error code.
+			 * x1 --> base address.
+			 * x2 --> size.
+			 */
+			rc = pmf_ring_get_buffer(&ring_base, &ring_size);
+			SMC_RET3(handle, rc, ring_base, ring_size);
+		}
+#endif
 	}
 
 	WARN("Unimplemented PMF Call: 0x%x \n", smc_fid);
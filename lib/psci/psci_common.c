@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -12,6 +12,7 @@
 #include <common/bl_common.h>
 #include <common/debug.h>
 #include <context.h>
+#include <lib/cassert.h>
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/utils.h>
 #include <plat/common/platform.h>
@@ -60,6 +61,12 @@ __section("tzfw_coherent_mem")
 /* Lock for PSCI state coordination */
 DEFINE_PSCI_LOCK(psci_locks[PSCI_NUM_NON_CPU_PWR_DOMAINS]);
 
+#if HW_ASSISTED_COHERENCY && PSCI_MCS_LOCKS
+/* A CPU can hold the locks of all its ancestor power domains at once */
+CASSERT(PLAT_MAX_PWR_LVL <= MCS_LOCK_MAX_NESTING,
+	assert_psci_mcs_lock_nesting);
+#endif
+
 cpu_pd_node_t psci_cpu_pd_nodes[PLATFORM_CORE_COUNT];
 
 /*******************************************************************************
@@ -432,6 +439,17 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 		psci_set_req_local_pwr_state(lvl, cpu_idx,
 					     state_info->pwr_domain_state[lvl]);
 
+#if PSCI_SUSPEND_FAST_PATH
+		/*
+		 * Make the requested state visible before reading the states
+		 * requested by the other CPUs. Pairs with the barrier in
+		 * psci_try_fast_state_coordination(), so that at least one of
+		 * two CPUs going down concurrently sees the request of the
+		 * other.
+		 */
+		dmbish();
+#endif
+
 		/* Get the requested power states for this power level */
 		start_idx = psci_non_cpu_pd_nodes[parent_idx].cpu_start_idx;
 		req_states = psci_get_req_local_pwr_states(lvl, start_idx);
@@ -471,6 +489,114 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 	psci_set_target_local_pwr_states(end_pwrlvl, state_info);
 }
 
+#if PSCI_SUSPEND_FAST_PATH
+/******************************************************************************
+ * Lock-free variant of psci_do_state_coordination() for CPU_SUSPEND. It
+ * publishes the local power states requested by this CPU and then checks
+ * whether another CPU of its level 1 power domain has requested to stay in
+ * RUN. If so, the level 1 power domain and all the levels above it stay in RUN
+ * whatever this CPU requests, so their state does not need to be coordinated
+ * and their power domain nodes do not need to be updated. 'state_info' is then
+ * updated with the target states and 1 is returned.
+ *
+ * Otherwise 0 is returned and the caller must coordinate the states with
+ * psci_do_state_coordination() under the power domain locks. The requested
+ * states have been published either way, so the caller must not back out of
+ * the suspend.
+ *
+ * This relies on the platform returning RUN from plat_get_target_pwr_state()
+ * whenever one of the requested states is RUN.
+ *****************************************************************************/
+int psci_try_fast_state_coordination(unsigned int end_pwrlvl,
+				     psci_power_state_t *state_info)
+{
+	unsigned int lvl, parent_idx, ncpus, i;
+	unsigned int cpu_idx = plat_my_core_pos();
+	int start_idx;
+	const plat_local_state_t *req_states;
+
+	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
+
+	/* No locks are taken for the CPU power level */
+	if (end_pwrlvl == PSCI_CPU_PWR_LVL)
+		return 0;
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= end_pwrlvl; lvl++) {
+		psci_set_req_local_pwr_state(lvl, cpu_idx,
+					     state_info->pwr_domain_state[lvl]);
+	}
+
+	/* Pairs with the barrier in psci_do_state_coordination() */
+	dmbish();
+
+	parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
+	start_idx = psci_non_cpu_pd_nodes[parent_idx].cpu_start_idx;
+	ncpus = psci_non_cpu_pd_nodes[parent_idx].ncpus;
+	req_states = psci_get_req_local_pwr_states(PSCI_CPU_PWR_LVL + 1U,
+						   start_idx);
+
+	for (i = 0U; i < ncpus; i++) {
+		if (((unsigned int)start_idx + i) == cpu_idx)
+			continue;
+		if (is_local_state_run(req_states[i]) != 0)
+			break;
+	}
+
+	if (i == ncpus)
+		return 0;
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= end_pwrlvl; lvl++)
+		state_info->pwr_domain_state[lvl] = PSCI_LOCAL_STATE_RUN;
+
+	/*
+	 * Only the CPU power domain changes state. The power domain nodes above
+	 * it are already in RUN since this CPU is running.
+	 */
+	psci_set_cpu_local_state(state_info->pwr_domain_state[PSCI_CPU_PWR_LVL]);
+	psci_flush_cpu_data(psci_svc_cpu_data.local_state);
+
+	return 1;
+}
+
+/******************************************************************************
+ * Withdraw the local power states published by this CPU in
+ * psci_try_fast_state_coordination(), so that it can back out of the suspend
+ * when a wake-up interrupt is pending. This is only possible while no other CPU
+ * has coordinated the state of an ancestor power domain with these requests,
+ * i.e. while all the ancestors up to 'end_pwrlvl' are still in RUN. The caller
+ * must hold the power domain locks up to 'end_pwrlvl'.
+ *
+ * Returns 1 if the requests have been withdrawn, or 0 if this CPU must go on
+ * with the suspend.
+ *****************************************************************************/
+int psci_withdraw_req_local_pwr_states(unsigned int end_pwrlvl)
+{
+	unsigned int lvl, parent_idx;
+	unsigned int cpu_idx = plat_my_core_pos();
+
+	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
+
+	parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
+	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= end_pwrlvl; lvl++) {
+		if (is_local_state_run(
+			get_non_cpu_pd_node_local_state(parent_idx)) == 0)
+			return 0;
+		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
+	}
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= end_pwrlvl; lvl++) {
+		psci_set_req_local_pwr_state(lvl, cpu_idx,
+					     PSCI_LOCAL_STATE_RUN);
+	}
+
+	/* The fast path may already have set the CPU power domain state */
+	psci_set_cpu_local_state(PSCI_LOCAL_STATE_RUN);
+	psci_flush_cpu_data(psci_svc_cpu_data.local_state);
+
+	return 1;
+}
+#endif /* PSCI_SUSPEND_FAST_PATH */
+
 /******************************************************************************
  * This function validates a suspend request by making sure that if a standby
  * state is requested then no power level is turned off and the highest power
@@ -576,10 +702,19 @@ void psci_acquire_pwr_domain_locks(unsigned int end_pwrlvl, int cpu_idx)
 {
 	unsigned int parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
 	unsigned int level;
+#if ENABLE_PSCI_STAT
+	uint64_t start;
+#endif
 
 	/* No locking required for level 0. Hence start locking from level 1 */
 	for (level = PSCI_CPU_PWR_LVL + 1U; level <= end_pwrlvl; level++) {
+#if ENABLE_PSCI_STAT
+		start = read_cntpct_el0();
+#endif
 		psci_lock_get(&psci_non_cpu_pd_nodes[parent_idx]);
+#if ENABLE_PSCI_STAT
+		psci_stats_update_lock_wait(level, read_cntpct_el0() - start);
+#endif
 		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
 	}
 }
@@ -765,6 +900,9 @@ void psci_warmboot_entrypoint(void)
 	unsigned int end_pwrlvl;
 	int cpu_idx = (int) plat_my_core_pos();
 	psci_power_state_t state_info = { {PSCI_LOCAL_STATE_RUN} };
+#if ENABLE_PSCI_STAT
+	uint64_t wake_ts = read_cntpct_el0();
+#endif
 
 	/*
 	 * Verify that we have been explicitly turned ON or resumed from
@@ -824,7 +962,7 @@ void psci_warmboot_entrypoint(void)
 	 * Since caches are now enabled, it's necessary to do cache
 	 * maintenance before reading that same data.
 	 */
-	psci_stats_update_pwr_up(end_pwrlvl, &state_info);
+	psci_stats_update_pwr_up(end_pwrlvl, &state_info, wake_ts);
 #endif
 
 	/*
@@ -30,6 +30,11 @@ else
 PSCI_LIB_SOURCES		+=	lib/locks/bakery/bakery_lock_normal.c
 endif
 
+ifeq (${PSCI_MCS_LOCKS}, 1)
+PSCI_LIB_SOURCES		+=	lib/locks/mcs/mcs_lock.c		\
+				lib/locks/mcs/aarch64/mcs_lock_helpers.S
+endif
+
 ifeq (${ENABLE_PSCI_STAT}, 1)
 PSCI_LIB_SOURCES		+=	lib/psci/psci_stat.c
 endif
@@ -120,7 +120,7 @@ int psci_cpu_suspend(unsigned int power_state,
 		plat_psci_stat_accounting_stop(&state_info);
 
 		/* Update PSCI stats */
-		psci_stats_update_pwr_up(PSCI_CPU_PWR_LVL, &state_info);
+		psci_stats_update_pwr_up(PSCI_CPU_PWR_LVL, &state_info, 0U);
 #endif
 
 		return PSCI_E_SUCCESS;
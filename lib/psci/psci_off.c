@@ -10,6 +10,7 @@
 #include <arch.h>
 #include <arch_helpers.h>
 #include <common/debug.h>
+#include <drivers/console.h>
 #include <lib/pmf/pmf.h>
 #include <lib/runtime_instr.h>
 #include <plat/common/platform.h>
@@ -55,6 +56,16 @@ int psci_do_cpu_off(unsigned int end_pwrlvl)
 	/* Construct the psci_power_state for CPU_OFF */
 	psci_set_power_off_state(&state_info);
 
+#if CONSOLE_LOGBUF
+	/*
+	 * Drain the logs buffered in memory while this cpu is going idle,
+	 * before its data cache is turned off. This is done before taking
+	 * the power domain locks so that the other cpus don't wait for the
+	 * console.
+	 */
+	(void)console_flush();
+#endif
+
 	/*
 	 * This function acquires the lock corresponding to each power
 	 * level so that by the time all locks are taken, the system topology
@@ -14,6 +14,7 @@
 #include <common/bl_common.h>
 #include <lib/bakery_lock.h>
 #include <lib/el3_runtime/cpu_data.h>
+#include <lib/mcs_lock.h>
 #include <lib/psci/psci.h>
 #include <lib/spinlock.h>
 
@@ -158,12 +159,21 @@ typedef struct cpu_pwr_domain_node {
  * The following are helpers and declarations of locks.
  ******************************************************************************/
 #if HW_ASSISTED_COHERENCY
+#if PSCI_MCS_LOCKS
+/*
+ * On systems where participant CPUs are cache-coherent, we can use MCS locks,
+ * which scale better than spinlocks when many CPUs contend for them.
+ */
+#define DEFINE_PSCI_LOCK(_name)		DEFINE_MCS_LOCK(_name)
+#define DECLARE_PSCI_LOCK(_name)	DECLARE_MCS_LOCK(_name)
+#else
 /*
  * On systems where participant CPUs are cache-coherent, we can use spinlocks
  * instead of bakery locks.
  */
 #define DEFINE_PSCI_LOCK(_name)		spinlock_t _name
 #define DECLARE_PSCI_LOCK(_name)	extern DEFINE_PSCI_LOCK(_name)
+#endif
 
 /* One lock is required per non-CPU power domain node */
 DECLARE_PSCI_LOCK(psci_locks[PSCI_NUM_NON_CPU_PWR_DOMAINS]);
@@ -187,6 +197,17 @@ static inline void psci_dsbish(void)
 	/* Empty */
 }
 
+#if PSCI_MCS_LOCKS
+static inline void psci_lock_get(non_cpu_pd_node_t *non_cpu_pd_node)
+{
+	mcs_lock_get(&psci_locks[non_cpu_pd_node->lock_index]);
+}
+
+static inline void psci_lock_release(non_cpu_pd_node_t *non_cpu_pd_node)
+{
+	mcs_lock_release(&psci_locks[non_cpu_pd_node->lock_index]);
+}
+#else
 static inline void psci_lock_get(non_cpu_pd_node_t *non_cpu_pd_node)
 {
 	spin_lock(&psci_locks[non_cpu_pd_node->lock_index]);
@@ -196,6 +217,7 @@ static inline void psci_lock_release(non_cpu_pd_node_t *non_cpu_pd_node)
 {
 	spin_unlock(&psci_locks[non_cpu_pd_node->lock_index]);
 }
+#endif
 
 #else /* if HW_ASSISTED_COHERENCY == 0 */
 /*
@@ -274,6 +296,11 @@ void psci_get_parent_pwr_domain_nodes(int cpu_idx,
 				      unsigned int *node_index);
 void psci_do_state_coordination(unsigned int end_pwrlvl,
 				psci_power_state_t *state_info);
+#if PSCI_SUSPEND_FAST_PATH
+int psci_try_fast_state_coordination(unsigned int end_pwrlvl,
+				     psci_power_state_t *state_info);
+int psci_withdraw_req_local_pwr_states(unsigned int end_pwrlvl);
+#endif
 void psci_acquire_pwr_domain_locks(unsigned int end_pwrlvl, int cpu_idx);
 void psci_release_pwr_domain_locks(unsigned int end_pwrlvl, int cpu_idx);
 int psci_validate_suspend_req(const psci_power_state_t *state_info,
@@ -323,11 +350,17 @@ u_register_t psci_system_reset2(uint32_t reset_type, u_register_t cookie);
 void psci_stats_update_pwr_down(unsigned int end_pwrlvl,
 			const psci_power_state_t *state_info);
 void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
-			const psci_power_state_t *state_info);
+			const psci_power_state_t *state_info,
+			uint64_t wake_ts);
 u_register_t psci_stat_residency(u_register_t target_cpu,
 			unsigned int power_state);
 u_register_t psci_stat_count(u_register_t target_cpu,
 			unsigned int power_state);
+void psci_stats_update_lock_wait(unsigned int pwrlvl, uint64_t wait_ticks);
+void psci_stats_update_lock_skip(unsigned int end_pwrlvl);
+#if PSCI_STAT_HISTOGRAMS
+void psci_stats_hist_init(void);
+#endif
 
 /* Private exported functions from psci_mem_protect.c */
 u_register_t psci_mem_protect(unsigned int enable);
@@ -260,6 +260,10 @@ int __init psci_setup(const psci_lib_args_t *lib_args)
 	psci_caps |=  define_psci_cap(PSCI_STAT_COUNT_AARCH64);
 #endif
 
+#if PSCI_STAT_HISTOGRAMS
+	psci_stats_hist_init();
+#endif
+
 	return 0;
 }
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -8,7 +8,10 @@
 
 #include <platform_def.h>
 
+#include <arch_helpers.h>
 #include <common/debug.h>
+#include <lib/psci/psci_stat_hist.h>
+#include <lib/utils.h>
 #include <plat/common/platform.h>
 
 #include "psci_private.h"
@@ -17,6 +20,8 @@
 #define PLAT_MAX_PWR_LVL_STATES		2U
 #endif
 
+#define MHZ_TICKS_PER_SEC		1000000U
+
 /* Following structure is used for PSCI STAT */
 typedef struct psci_stat {
 	u_register_t residency;
@@ -39,6 +44,144 @@ static psci_stat_t psci_cpu_stat[PLATFORM_CORE_COUNT]
 static psci_stat_t psci_non_cpu_stat[PSCI_NUM_NON_CPU_PWR_DOMAINS]
 				[PLAT_MAX_PWR_LVL_STATES];
 
+/*
+ * Following are used to store the contention statistics of the power domain
+ * locks. Each CPU only updates its own entries, which are summed up when read.
+ */
+static psci_lock_stat_t psci_lock_stat[PLATFORM_CORE_COUNT][PLAT_MAX_PWR_LVL];
+
+#if PSCI_STAT_HISTOGRAMS
+/*
+ * The histograms are kept directly in the shared memory buffer provided by the
+ * platform, whose layout is described in psci_stat_hist.h.
+ */
+#define PSCI_STAT_HIST_NODES	(PLATFORM_CORE_COUNT + \
+				 PSCI_NUM_NON_CPU_PWR_DOMAINS)
+#define PSCI_STAT_HIST_RECORD_SIZE					\
+	(sizeof(psci_stat_hist_node_t) +				\
+	 (PLAT_MAX_PWR_LVL_STATES * sizeof(psci_stat_hist_state_t)))
+
+CASSERT((sizeof(psci_stat_hist_hdr_t) +
+	 (PSCI_STAT_HIST_NODES * PSCI_STAT_HIST_RECORD_SIZE)) <=
+	PLAT_PSCI_STAT_HIST_SIZE, assert_psci_stat_hist_size);
+CASSERT((PLAT_PSCI_STAT_HIST_BASE % sizeof(uint64_t)) == 0U,
+	assert_psci_stat_hist_base_alignment);
+
+static psci_stat_hist_node_t *psci_stat_hist_node(unsigned int node_idx)
+{
+	return (psci_stat_hist_node_t *)(PLAT_PSCI_STAT_HIST_BASE +
+		sizeof(psci_stat_hist_hdr_t) +
+		(node_idx * PSCI_STAT_HIST_RECORD_SIZE));
+}
+
+/* Return the histogram bucket of a value, see PSCI_STAT_HIST_BUCKETS */
+static unsigned int psci_stat_hist_bucket(u_register_t value)
+{
+	unsigned int bucket = 0U;
+
+	while ((value > 1U) && (bucket < (PSCI_STAT_HIST_BUCKETS - 1U))) {
+		value >>= 1;
+		bucket++;
+	}
+
+	return bucket;
+}
+
+/*
+ * Update the histograms of local state `stat_idx` of the power domain whose
+ * record is `node_idx`. A `wake_latency` of 0 means that it is unknown.
+ */
+static void psci_stat_hist_update(unsigned int node_idx, int stat_idx,
+				  u_register_t residency,
+				  u_register_t wake_latency,
+				  unsigned int intr_id)
+{
+	psci_stat_hist_node_t *node = psci_stat_hist_node(node_idx);
+	psci_stat_hist_state_t *state = &node->state[stat_idx];
+	psci_stat_hist_wake_src_t *src;
+	unsigned int i;
+
+	/* Let the readers know that the record is being updated */
+	node->seq++;
+	dmbishst();
+
+	if (node_idx < PLATFORM_CORE_COUNT)
+		node->mpidr = read_mpidr() & MPIDR_AFFINITY_MASK;
+
+	state->residency[psci_stat_hist_bucket(residency)]++;
+	if (wake_latency != 0U)
+		state->wake_latency[psci_stat_hist_bucket(wake_latency)]++;
+
+	/*
+	 * The last entry is kept for the unknown sources and for the ones that
+	 * did not fit in the others.
+	 */
+	i = PSCI_STAT_HIST_WAKE_SOURCES - 1U;
+	if (intr_id != PSCI_STAT_HIST_UNKNOWN_SOURCE) {
+		for (i = 0U; i < (PSCI_STAT_HIST_WAKE_SOURCES - 1U); i++) {
+			src = &node->wake_src[i];
+			if ((src->count == 0U) || (src->intr_id == intr_id))
+				break;
+		}
+	}
+	src = &node->wake_src[i];
+	if ((i < (PSCI_STAT_HIST_WAKE_SOURCES - 1U)) && (src->count == 0U))
+		src->intr_id = intr_id;
+	src->count++;
+
+	dmbishst();
+	node->seq++;
+}
+
+/*******************************************************************************
+ * This function initializes the shared memory buffer holding the PSCI
+ * statistics histograms. It is called by the primary CPU during cold boot.
+ ******************************************************************************/
+void __init psci_stats_hist_init(void)
+{
+	psci_stat_hist_hdr_t *hdr =
+		(psci_stat_hist_hdr_t *)PLAT_PSCI_STAT_HIST_BASE;
+	psci_stat_hist_node_t *node;
+	unsigned int node_idx, parent_idx;
+
+	zeromem(hdr, sizeof(*hdr) +
+		     (PSCI_STAT_HIST_NODES * PSCI_STAT_HIST_RECORD_SIZE));
+
+	for (node_idx = 0U; node_idx < PSCI_STAT_HIST_NODES; node_idx++) {
+		node = psci_stat_hist_node(node_idx);
+
+		if (node_idx < PLATFORM_CORE_COUNT) {
+			node->pwr_lvl = PSCI_CPU_PWR_LVL;
+			parent_idx = psci_cpu_pd_nodes[node_idx].parent_node;
+		} else {
+			parent_idx = node_idx - PLATFORM_CORE_COUNT;
+			node->pwr_lvl = psci_non_cpu_pd_nodes[parent_idx].level;
+			parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
+		}
+
+		if (parent_idx < PSCI_NUM_NON_CPU_PWR_DOMAINS)
+			node->parent = PLATFORM_CORE_COUNT + parent_idx;
+		else
+			node->parent = PSCI_STAT_HIST_NO_PARENT;
+
+		node->wake_src[PSCI_STAT_HIST_WAKE_SOURCES - 1U].intr_id =
+			PSCI_STAT_HIST_UNKNOWN_SOURCE;
+	}
+
+	hdr->version = PSCI_STAT_HIST_VERSION;
+	hdr->num_buckets = PSCI_STAT_HIST_BUCKETS;
+	hdr->num_wake_sources = PSCI_STAT_HIST_WAKE_SOURCES;
+	hdr->num_states = PLAT_MAX_PWR_LVL_STATES;
+	hdr->num_cpus = PLATFORM_CORE_COUNT;
+	hdr->num_nodes = PSCI_STAT_HIST_NODES;
+	hdr->record_size = PSCI_STAT_HIST_RECORD_SIZE;
+
+	/* Publish the buffer once it is complete */
+	dmbishst();
+	hdr->magic = PSCI_STAT_HIST_MAGIC;
+}
+#endif /* PSCI_STAT_HISTOGRAMS */
+
 /*
  * This functions returns the index into the `psci_stat_t` array given the
  * local power state and power domain level. If the platform implements the
@@ -105,15 +248,32 @@ void psci_stats_update_pwr_down(unsigned int end_pwrlvl,
  * This function updates the PSCI STATS(residency time and count) for CPU
  * and NON-CPU power domains.
  * It is called with caches enabled and locks acquired(for NON-CPU domain)
+ * `wake_ts` is the value of the system counter when the CPU started its warm
+ * boot, or 0 if it is waking up from a retention state.
  ******************************************************************************/
 void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
-			const psci_power_state_t *state_info)
+			const psci_power_state_t *state_info,
+			uint64_t wake_ts)
 {
 	unsigned int lvl, parent_idx;
 	int cpu_idx = (int) plat_my_core_pos();
 	int stat_idx;
 	plat_local_state_t local_state;
 	u_register_t residency;
+#if PSCI_STAT_HISTOGRAMS
+	/* No pending interrupt is reported as PSCI_STAT_HIST_UNKNOWN_SOURCE */
+	unsigned int intr_id = plat_ic_get_pending_interrupt_id();
+	u_register_t wake_latency = 0U;
+	u_register_t cntfrq = read_cntfrq_el0();
+
+	/*
+	 * Convert the wake-up latency to microseconds. It is left unknown if
+	 * the frequency of the system counter has not been programmed.
+	 */
+	if ((wake_ts != 0U) && (cntfrq != 0U))
+		wake_latency = ((read_cntpct_el0() - wake_ts) *
+				MHZ_TICKS_PER_SEC) / cntfrq;
+#endif
 
 	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
 	assert(state_info != NULL);
@@ -129,6 +289,10 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 	/* Update CPU stats. */
 	psci_cpu_stat[cpu_idx][stat_idx].residency += residency;
 	psci_cpu_stat[cpu_idx][stat_idx].count++;
+#if PSCI_STAT_HISTOGRAMS
+	psci_stat_hist_update((unsigned int)cpu_idx, stat_idx, residency,
+			      wake_latency, intr_id);
+#endif
 
 	/*
 	 * Check what power domains above CPU were off
@@ -161,6 +325,11 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 		/* Update non cpu stats */
 		psci_non_cpu_stat[parent_idx][stat_idx].residency += residency;
 		psci_non_cpu_stat[parent_idx][stat_idx].count++;
+#if PSCI_STAT_HISTOGRAMS
+		psci_stat_hist_update(PLATFORM_CORE_COUNT + parent_idx,
+				      stat_idx, residency, wake_latency,
+				      intr_id);
+#endif
 
 		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
 	}
@@ -248,3 +417,77 @@ u_register_t psci_stat_count(u_register_t target_cpu,
 	else
 		return 0;
 }
+
+/*******************************************************************************
+ * This function records the time the current CPU waited for the power domain
+ * lock at power level `pwrlvl`.
+ ******************************************************************************/
+void psci_stats_update_lock_wait(unsigned int pwrlvl, uint64_t wait_ticks)
+{
+	psci_lock_stat_t *stat;
+
+	assert((pwrlvl > PSCI_CPU_PWR_LVL) && (pwrlvl <= PLAT_MAX_PWR_LVL));
+
+#if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
+	/*
+	 * On the warm boot path, the locks are taken before the data cache is
+	 * enabled. The statistics are not updated then, since stale copies of
+	 * them may still be held in the caches.
+	 */
+#ifdef AARCH32
+	if ((read_sctlr() & SCTLR_C_BIT) == 0U)
+		return;
+#else
+	if ((read_sctlr_el3() & SCTLR_C_BIT) == 0U)
+		return;
+#endif
+#endif
+
+	stat = &psci_lock_stat[plat_my_core_pos()][pwrlvl - 1U];
+	stat->acquisitions++;
+	stat->wait_ticks += wait_ticks;
+	if (wait_ticks > stat->max_wait_ticks)
+		stat->max_wait_ticks = wait_ticks;
+}
+
+/*******************************************************************************
+ * This function records that CPU_SUSPEND on the current CPU did not need the
+ * power domain locks up to power level `end_pwrlvl`.
+ ******************************************************************************/
+void psci_stats_update_lock_skip(unsigned int end_pwrlvl)
+{
+	unsigned int lvl, cpu_idx = plat_my_core_pos();
+
+	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= end_pwrlvl; lvl++)
+		psci_lock_stat[cpu_idx][lvl - 1U].skipped++;
+}
+
+/*******************************************************************************
+ * This function returns the contention statistics of the power domain locks at
+ * power level `pwrlvl`, accumulated over all CPUs. The statistics of a CPU
+ * which is updating them concurrently may be slightly out of date.
+ ******************************************************************************/
+int psci_get_lock_stat(unsigned int pwrlvl, psci_lock_stat_t *stat)
+{
+	const psci_lock_stat_t *cpu_stat;
+	unsigned int cpu_idx;
+
+	if ((pwrlvl <= PSCI_CPU_PWR_LVL) || (pwrlvl > PLAT_MAX_PWR_LVL) ||
+	    (stat == NULL))
+		return PSCI_E_INVALID_PARAMS;
+
+	zeromem(stat, sizeof(*stat));
+
+	for (cpu_idx = 0U; cpu_idx < PLATFORM_CORE_COUNT; cpu_idx++) {
+		cpu_stat = &psci_lock_stat[cpu_idx][pwrlvl - 1U];
+		stat->acquisitions += cpu_stat->acquisitions;
+		stat->wait_ticks += cpu_stat->wait_ticks;
+		stat->skipped += cpu_stat->skipped;
+		if (cpu_stat->max_wait_ticks > stat->max_wait_ticks)
+			stat->max_wait_ticks = cpu_stat->max_wait_ticks;
+	}
+
+	return PSCI_E_SUCCESS;
+}
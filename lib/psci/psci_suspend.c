@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -12,6 +12,7 @@
 #include <common/bl_common.h>
 #include <common/debug.h>
 #include <context.h>
+#include <drivers/console.h>
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/el3_runtime/cpu_data.h>
 #include <lib/el3_runtime/pubsub_events.h>
@@ -42,7 +43,7 @@ static void psci_suspend_to_standby_finisher(int cpu_idx,
 
 #if ENABLE_PSCI_STAT
 	plat_psci_stat_accounting_stop(&state_info);
-	psci_stats_update_pwr_up(end_pwrlvl, &state_info);
+	psci_stats_update_pwr_up(end_pwrlvl, &state_info, 0U);
 #endif
 
 	/*
@@ -155,7 +156,9 @@ void psci_cpu_suspend_start(const entry_point_info_t *ep,
 			    unsigned int is_power_down_state)
 {
 	int skip_wfi = 0;
+	int fast_path = 0;
 	int idx = (int) plat_my_core_pos();
+	unsigned int lock_pwrlvl = end_pwrlvl;
 
 	/*
 	 * This function must only be called on platforms where the
@@ -164,12 +167,46 @@ void psci_cpu_suspend_start(const entry_point_info_t *ep,
 	assert((psci_plat_pm_ops->pwr_domain_suspend != NULL) &&
 	       (psci_plat_pm_ops->pwr_domain_suspend_finish != NULL));
 
+#if CONSOLE_LOGBUF
+	/*
+	 * Drain the logs buffered in memory while this cpu is going idle,
+	 * before its data cache is turned off. This is done before taking
+	 * the power domain locks so that the other cpus don't wait for the
+	 * console, and before the check for pending interrupts.
+	 */
+	if (is_power_down_state != 0U)
+		(void)console_flush();
+#endif
+
+#if PSCI_SUSPEND_FAST_PATH
+	/*
+	 * Once the requested states of this CPU have been published, backing
+	 * out of the suspend needs the power domain locks, so pending
+	 * interrupts are first checked beforehand.
+	 */
+	if (read_isr_el1() != 0U)
+		return;
+
+	/*
+	 * If another CPU of the level 1 power domain stays in RUN, no power
+	 * domain above this CPU can be powered down and the states can be
+	 * coordinated without taking the locks.
+	 */
+	fast_path = psci_try_fast_state_coordination(end_pwrlvl, state_info);
+	if (fast_path != 0) {
+		lock_pwrlvl = PSCI_CPU_PWR_LVL;
+#if ENABLE_PSCI_STAT
+		psci_stats_update_lock_skip(end_pwrlvl);
+#endif
+	}
+#endif
+
 	/*
 	 * This function acquires the lock corresponding to each power
 	 * level so that by the time all locks are taken, the system topology
 	 * is snapshot and state management can be done safely.
 	 */
-	psci_acquire_pwr_domain_locks(end_pwrlvl,
+	psci_acquire_pwr_domain_locks(lock_pwrlvl,
 				      idx);
 
 	/*
@@ -178,8 +215,23 @@ void psci_cpu_suspend_start(const entry_point_info_t *ep,
 	 * detection that a wake-up interrupt has fired.
 	 */
 	if (read_isr_el1() != 0U) {
+#if PSCI_SUSPEND_FAST_PATH
+		/*
+		 * The requested states of this CPU have already been published
+		 * and other CPUs may have coordinated their states with them.
+		 * Withdrawing them needs all the locks, which the fast path has
+		 * not taken.
+		 */
+		if (lock_pwrlvl != end_pwrlvl) {
+			lock_pwrlvl = end_pwrlvl;
+			psci_acquire_pwr_domain_locks(lock_pwrlvl, idx);
+		}
+		skip_wfi = psci_withdraw_req_local_pwr_states(end_pwrlvl);
+#else
 		skip_wfi = 1;
-		goto exit;
+#endif
+		if (skip_wfi == 1)
+			goto exit;
 	}
 
 	/*
@@ -187,7 +239,8 @@ void psci_cpu_suspend_start(const entry_point_info_t *ep,
 	 * it returns the negotiated state info for each power level upto
 	 * the end level specified.
 	 */
-	psci_do_state_coordination(end_pwrlvl, state_info);
+	if (fast_path == 0)
+		psci_do_state_coordination(end_pwrlvl, state_info);
 
 #if ENABLE_PSCI_STAT
 	/* Update the last cpu for each level till end_pwrlvl */
@@ -214,7 +267,7 @@ exit:
 	 * Release the locks corresponding to each power level in the
 	 * reverse order to which they were acquired.
 	 */
-	psci_release_pwr_domain_locks(end_pwrlvl,
+	psci_release_pwr_domain_locks(lock_pwrlvl,
 				  idx);
 	if (skip_wfi == 1)
 		return;
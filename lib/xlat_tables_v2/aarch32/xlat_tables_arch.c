@@ -86,6 +86,22 @@ uint64_t xlat_arch_regime_get_xn_desc(int xlat_regime)
 	}
 }
 
+/*
+ * From this number of pages on, it is cheaper to invalidate all the TLB entries
+ * of the translation regime than to invalidate them one page at a time.
+ */
+#define XLAT_TLBI_VA_MAX_PAGES		XLAT_TABLE_ENTRIES
+
+static void xlat_arch_tlbi_page(uintptr_t va, int xlat_regime)
+{
+	if (xlat_regime == EL1_EL0_REGIME) {
+		tlbimvaais(TLBI_ADDR(va));
+	} else {
+		assert(xlat_regime == EL2_REGIME);
+		tlbimvahis(TLBI_ADDR(va));
+	}
+}
+
 void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
 {
 	/*
@@ -94,12 +110,41 @@ void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
 	 */
 	dsbishst();
 
-	if (xlat_regime == EL1_EL0_REGIME) {
-		tlbimvaais(TLBI_ADDR(va));
-	} else {
-		assert(xlat_regime == EL2_REGIME);
-		tlbimvahis(TLBI_ADDR(va));
+	xlat_arch_tlbi_page(va, xlat_regime);
+}
+
+unsigned int xlat_arch_tlbi_va_range(uintptr_t va, size_t size,
+				     int xlat_regime)
+{
+	size_t pages = size / PAGE_SIZE;
+
+	assert(IS_PAGE_ALIGNED(va));
+	assert((size % PAGE_SIZE) == 0U);
+
+	/*
+	 * Ensure the translation table writes have drained into memory before
+	 * invalidating the TLB entries.
+	 */
+	dsbishst();
+
+	/* There are no TLBI range operations in AArch32 */
+	if (pages >= XLAT_TLBI_VA_MAX_PAGES) {
+		if (xlat_regime == EL1_EL0_REGIME) {
+			tlbiallis();
+		} else {
+			assert(xlat_regime == EL2_REGIME);
+			tlbiallhis();
+		}
+
+		return 1U;
 	}
+
+	for (size_t i = 0U; i < pages; i++) {
+		xlat_arch_tlbi_page(va, xlat_regime);
+		va += PAGE_SIZE;
+	}
+
+	return (unsigned int)pages;
 }
 
 void xlat_arch_tlbi_va_sync(void)
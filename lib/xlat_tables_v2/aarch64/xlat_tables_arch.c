@@ -157,14 +157,28 @@ uint64_t xlat_arch_regime_get_xn_desc(int xlat_regime)
 	}
 }
 
-void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
-{
-	/*
-	 * Ensure the translation table write has drained into memory before
-	 * invalidating the TLB entry.
-	 */
-	dsbishst();
+/*
+ * From this number of pages on, it is cheaper to invalidate all the TLB entries
+ * of the translation regime than to invalidate them one page at a time.
+ */
+#define XLAT_TLBI_VA_MAX_PAGES		XLAT_TABLE_ENTRIES
 
+/* Number of pages invalidated by a TLBI range operation */
+#define XLAT_TLBI_RANGE_PAGES(num, scale)				\
+	((size_t)((num) + 1U) << ((5U * (scale)) + 1U))
+
+/*
+ * Number of pages from which the TLBI range operations can't be used and all
+ * the TLB entries of the translation regime are invalidated instead.
+ */
+#define XLAT_TLBI_RANGE_MAX_PAGES					\
+	XLAT_TLBI_RANGE_PAGES(TLBI_RANGE_NUM_MAX, TLBI_RANGE_SCALE_MAX)
+
+/* The operand of the TLBI range operations is encoded for 4KB pages */
+CASSERT(PAGE_SIZE == PAGE_SIZE_4KB, assert_tlbi_range_page_size);
+
+static void xlat_arch_tlbi_page(uintptr_t va, int xlat_regime)
+{
 	/*
 	 * This function only supports invalidation of TLB entries for the EL3
 	 * and EL1&0 translation regimes.
@@ -185,6 +199,121 @@ void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
 	}
 }
 
+/*
+ * Invalidate the TLB entries of the (num + 1) * 2^(5 * scale + 1) pages that
+ * start at the given virtual address.
+ */
+static void xlat_arch_tlbi_range(uintptr_t va, unsigned int num,
+				 unsigned int scale, int xlat_regime)
+{
+	u_register_t op;
+
+	assert(num <= TLBI_RANGE_NUM_MAX);
+	assert(scale <= TLBI_RANGE_SCALE_MAX);
+
+	op = (TLBI_RANGE_TG_4KB << TLBI_RANGE_TG_SHIFT) |
+	     ((u_register_t)scale << TLBI_RANGE_SCALE_SHIFT) |
+	     ((u_register_t)num << TLBI_RANGE_NUM_SHIFT) |
+	     (((u_register_t)va >> PAGE_SIZE_SHIFT) & TLBI_RANGE_BADDR_MASK);
+
+	if (xlat_regime == EL1_EL0_REGIME) {
+		assert(xlat_arch_current_el() >= 1U);
+		tlbirvaae1is(op);
+	} else if (xlat_regime == EL2_REGIME) {
+		assert(xlat_arch_current_el() >= 2U);
+		tlbirvae2is(op);
+	} else {
+		assert(xlat_regime == EL3_REGIME);
+		assert(xlat_arch_current_el() >= 3U);
+		tlbirvae3is(op);
+	}
+}
+
+/* Invalidate all the TLB entries of the given translation regime. */
+static void xlat_arch_tlbi_all(int xlat_regime)
+{
+	if (xlat_regime == EL1_EL0_REGIME) {
+		assert(xlat_arch_current_el() >= 1U);
+		tlbivmalle1is();
+	} else if (xlat_regime == EL2_REGIME) {
+		assert(xlat_arch_current_el() >= 2U);
+		tlbialle2is();
+	} else {
+		assert(xlat_regime == EL3_REGIME);
+		assert(xlat_arch_current_el() >= 3U);
+		tlbialle3is();
+	}
+}
+
+void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
+{
+	/*
+	 * Ensure the translation table write has drained into memory before
+	 * invalidating the TLB entry.
+	 */
+	dsbishst();
+
+	xlat_arch_tlbi_page(va, xlat_regime);
+}
+
+unsigned int xlat_arch_tlbi_va_range(uintptr_t va, size_t size,
+				     int xlat_regime)
+{
+	size_t pages = size / PAGE_SIZE;
+	bool range = is_armv8_4_tlbi_range_present();
+	unsigned int scale = 0U;
+	unsigned int count = 0U;
+
+	assert(IS_PAGE_ALIGNED(va));
+	assert((size % PAGE_SIZE) == 0U);
+
+	/*
+	 * Ensure the translation table writes have drained into memory before
+	 * invalidating the TLB entries.
+	 */
+	dsbishst();
+
+	if ((range && (pages >= XLAT_TLBI_RANGE_MAX_PAGES)) ||
+	    (!range && (pages >= XLAT_TLBI_VA_MAX_PAGES))) {
+		xlat_arch_tlbi_all(xlat_regime);
+		return 1U;
+	}
+
+	/*
+	 * A range operation invalidates an even number of pages. Any odd page
+	 * is invalidated on its own, then the rest of the range is covered with
+	 * one operation for each increasing value of SCALE that is needed.
+	 */
+	while (pages > 0U) {
+		if (!range || ((pages % 2U) == 1U)) {
+			xlat_arch_tlbi_page(va, xlat_regime);
+			va += PAGE_SIZE;
+			pages--;
+			count++;
+			continue;
+		}
+
+		assert(scale <= TLBI_RANGE_SCALE_MAX);
+
+		unsigned int num = (unsigned int)(pages >> ((5U * scale) + 1U)) &
+				   TLBI_RANGE_NUM_MAX;
+
+		if (num != 0U) {
+			size_t range_pages = XLAT_TLBI_RANGE_PAGES(num - 1U,
+								   scale);
+
+			xlat_arch_tlbi_range(va, num - 1U, scale, xlat_regime);
+			va += range_pages * PAGE_SIZE;
+			pages -= range_pages;
+			count++;
+		}
+
+		scale++;
+	}
+
+	return count;
+}
+
 void xlat_arch_tlbi_va_sync(void)
 {
 	/*
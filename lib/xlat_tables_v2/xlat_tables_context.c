@@ -9,6 +9,7 @@
 #include <platform_def.h>
 
 #include <common/debug.h>
+#include <lib/xlat_tables/xlat_tables_aot.h>
 #include <lib/xlat_tables/xlat_tables_defs.h>
 #include <lib/xlat_tables/xlat_tables_v2.h>
 
@@ -40,6 +41,11 @@ void mmap_add(const mmap_region_t *mm)
 	mmap_add_ctx(&tf_xlat_ctx, mm);
 }
 
+void mmap_add_bulk(const mmap_region_t *mm)
+{
+	mmap_add_bulk_ctx(&tf_xlat_ctx, mm);
+}
+
 void mmap_add_region_alloc_va(unsigned long long base_pa, uintptr_t *base_va,
 			      size_t size, unsigned int attr)
 {
@@ -106,7 +112,11 @@ void __init init_xlat_tables(void)
 		tf_xlat_ctx.xlat_regime = EL3_REGIME;
 	}
 
+#if XLAT_TABLES_AOT && defined(IMAGE_BL31)
+	init_xlat_tables_aot_ctx(&tf_xlat_ctx, &xlat_aot_tables);
+#else
 	init_xlat_tables_ctx(&tf_xlat_ctx);
+#endif
 }
 
 int xlat_get_mem_attributes(uintptr_t base_va, uint32_t *attr)
@@ -15,6 +15,7 @@
 #include <arch_helpers.h>
 #include <common/debug.h>
 #include <lib/utils_def.h>
+#include <lib/xlat_tables/xlat_tables_aot.h>
 #include <lib/xlat_tables/xlat_tables_defs.h>
 #include <lib/xlat_tables/xlat_tables_v2.h>
 
@@ -642,15 +643,15 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 }
 
 /*
- * Function that verifies that a region can be mapped.
+ * Function that verifies that the addresses, size and granularity of a region
+ * are valid in the given context.
  * Returns:
- *        0: Success, the mapping is allowed.
+ *        0: Success, the region is valid.
  *   EINVAL: Invalid values were used as arguments.
  *   ERANGE: The memory limits were surpassed.
- *   ENOMEM: There is not enough memory in the mmap array.
- *    EPERM: Region overlaps another one in an invalid way.
  */
-static int mmap_add_region_check(const xlat_ctx_t *ctx, const mmap_region_t *mm)
+static int mmap_region_check_limits(const xlat_ctx_t *ctx,
+				    const mmap_region_t *mm)
 {
 	unsigned long long base_pa = mm->base_pa;
 	uintptr_t base_va = mm->base_va;
@@ -680,6 +681,32 @@ static int mmap_add_region_check(const xlat_ctx_t *ctx, const mmap_region_t *mm)
 	if ((base_pa + (unsigned long long)size - 1ULL) > ctx->pa_max_address)
 		return -ERANGE;
 
+	return 0;
+}
+
+/*
+ * Function that verifies that a region can be mapped.
+ * Returns:
+ *        0: Success, the mapping is allowed.
+ *   EINVAL: Invalid values were used as arguments.
+ *   ERANGE: The memory limits were surpassed.
+ *   ENOMEM: There is not enough memory in the mmap array.
+ *    EPERM: Region overlaps another one in an invalid way.
+ */
+static int mmap_add_region_check(const xlat_ctx_t *ctx, const mmap_region_t *mm)
+{
+	unsigned long long base_pa = mm->base_pa;
+	uintptr_t base_va = mm->base_va;
+	size_t size = mm->size;
+
+	unsigned long long end_pa = base_pa + size - 1U;
+	uintptr_t end_va = base_va + size - 1U;
+	int ret;
+
+	ret = mmap_region_check_limits(ctx, mm);
+	if (ret != 0)
+		return ret;
+
 	/* Check that there is space in the ctx->mmap array */
 	if (ctx->mmap[ctx->mmap_num - 1].size != 0U)
 		return -ENOMEM;
@@ -921,6 +948,224 @@ void mmap_add_ctx(xlat_ctx_t *ctx, const mmap_region_t *mm)
 	}
 }
 
+/*
+ * Maximum number of nested regions that mmap_add_bulk_ctx() can handle, e.g. 2
+ * for a region inside a region that is not inside any other.
+ */
+#define MMAP_BULK_MAX_NESTING	8U
+
+typedef bool (*mmap_order_t)(const mmap_region_t *a, const mmap_region_t *b);
+
+/* Order in which the regions are mapped, see mmap_add_region_ctx() */
+static bool mmap_map_order(const mmap_region_t *a, const mmap_region_t *b)
+{
+	uintptr_t a_end_va = a->base_va + a->size - 1U;
+	uintptr_t b_end_va = b->base_va + b->size - 1U;
+
+	if (a_end_va != b_end_va)
+		return a_end_va < b_end_va;
+
+	return a->size < b->size;
+}
+
+/* Regions sorted by base VA, with the outer ones before the inner ones */
+static bool mmap_va_order(const mmap_region_t *a, const mmap_region_t *b)
+{
+	if (a->base_va != b->base_va)
+		return a->base_va < b->base_va;
+
+	return a->size > b->size;
+}
+
+/* Regions sorted by base PA, with the outer ones before the inner ones */
+static bool mmap_pa_order(const mmap_region_t *a, const mmap_region_t *b)
+{
+	if (a->base_pa != b->base_pa)
+		return a->base_pa < b->base_pa;
+
+	return a->size > b->size;
+}
+
+static void mmap_sift_down(mmap_region_t *mm, unsigned int root,
+			   unsigned int num, mmap_order_t before)
+{
+	unsigned int child;
+	mmap_region_t tmp;
+
+	while ((2U * root + 1U) < num) {
+		child = 2U * root + 1U;
+		if (((child + 1U) < num) && before(&mm[child], &mm[child + 1U]))
+			child++;
+		if (!before(&mm[root], &mm[child]))
+			return;
+
+		tmp = mm[root];
+		mm[root] = mm[child];
+		mm[child] = tmp;
+		root = child;
+	}
+}
+
+/* In-place heap sort of an array of regions */
+static void mmap_sort(mmap_region_t *mm, unsigned int num, mmap_order_t before)
+{
+	unsigned int i;
+	mmap_region_t tmp;
+
+	for (i = num / 2U; i > 0U; i--)
+		mmap_sift_down(mm, i - 1U, num, before);
+
+	for (i = num; i > 1U; i--) {
+		tmp = mm[0];
+		mm[0] = mm[i - 1U];
+		mm[i - 1U] = tmp;
+		mmap_sift_down(mm, 0U, i - 1U, before);
+	}
+}
+
+/*
+ * Check in a single pass that the regions, sorted by mmap_va_order() or
+ * mmap_pa_order(), either do not overlap or are nested with the same VA to PA
+ * offset, which are the rules enforced by mmap_add_region_check(). Regions with
+ * the same offset overlap in PA if and only if they overlap in VA, so checking
+ * both orders also rejects the regions that only overlap in PA. The regions
+ * that contain the current one are kept on a stack, which is as deep as the
+ * regions are nested.
+ */
+static int mmap_check_nesting(const mmap_region_t *mm, unsigned int num,
+			      bool pa)
+{
+	const mmap_region_t *outer[MMAP_BULK_MAX_NESTING];
+	unsigned long long base, end, outer_end;
+	unsigned int depth = 0U;
+
+	for (unsigned int i = 0U; i < num; i++) {
+		base = pa ? mm[i].base_pa : (unsigned long long)mm[i].base_va;
+		end = base + mm[i].size - 1U;
+
+		/* Forget the regions that end before this one */
+		while (depth > 0U) {
+			outer_end = (pa ? outer[depth - 1U]->base_pa :
+				(unsigned long long)outer[depth - 1U]->base_va)
+				+ outer[depth - 1U]->size - 1U;
+			if (outer_end >= base)
+				break;
+			depth--;
+		}
+
+		if (depth > 0U) {
+			const mmap_region_t *parent = outer[depth - 1U];
+
+			/* Partial overlaps are not allowed */
+			if (end > outer_end)
+				return -EPERM;
+
+			if ((parent->base_va - parent->base_pa) !=
+			    (mm[i].base_va - mm[i].base_pa))
+				return -EPERM;
+
+			if ((parent->base_va == mm[i].base_va) &&
+			    (parent->size == mm[i].size))
+				return -EPERM;
+		}
+
+		if (depth == MMAP_BULK_MAX_NESTING)
+			return -ENOMEM;
+
+		outer[depth] = &mm[i];
+		depth++;
+	}
+
+	return 0;
+}
+
+/*
+ * Add an array of static regions at once. Unlike mmap_add_ctx(), which keeps
+ * the mmap array sorted and checks every new region against all the others, it
+ * appends the regions, sorts the mmap array once and checks the overlaps with
+ * one pass over the regions sorted by VA and one over them sorted by PA.
+ */
+void mmap_add_bulk_ctx(xlat_ctx_t *ctx, const mmap_region_t *mm)
+{
+	const mmap_region_t *mm_start;
+	unsigned int num = 0U;
+	unsigned long long max_pa = ctx->max_pa;
+	uintptr_t max_va = ctx->max_va;
+	int ret = 0;
+
+	/* Static regions must be added before initializing the xlat tables. */
+	assert(!ctx->initialized);
+
+	while (ctx->mmap[num].size != 0U)
+		num++;
+	mm_start = mm;
+
+	for (; mm->granularity != 0U; mm++) {
+		/* Ignore empty regions */
+		if (mm->size == 0U)
+			continue;
+
+		ret = mmap_region_check_limits(ctx, mm);
+		if (ret != 0)
+			break;
+
+		if (num == (unsigned int)ctx->mmap_num) {
+			ret = -ENOMEM;
+			break;
+		}
+
+		ctx->mmap[num] = *mm;
+		num++;
+
+		if ((mm->base_pa + mm->size - 1U) > max_pa)
+			max_pa = mm->base_pa + mm->size - 1U;
+		if ((mm->base_va + mm->size - 1U) > max_va)
+			max_va = mm->base_va + mm->size - 1U;
+	}
+
+	if (ret == 0) {
+		mmap_sort(ctx->mmap, num, mmap_pa_order);
+		ret = mmap_check_nesting(ctx->mmap, num, true);
+	}
+
+	if (ret == 0) {
+		mmap_sort(ctx->mmap, num, mmap_va_order);
+		ret = mmap_check_nesting(ctx->mmap, num, false);
+	}
+
+	if (ret != 0) {
+		ERROR("mmap_add_bulk_ctx() failed. error %d\n", ret);
+		assert(false);
+
+		/*
+		 * The sorts have mixed the new regions with the previous ones,
+		 * so remove one copy of each region that has been appended.
+		 */
+		for (; mm_start != mm; mm_start++) {
+			for (unsigned int i = 0U; i < num; i++) {
+				if (memcmp(&ctx->mmap[i], mm_start,
+					   sizeof(mmap_region_t)) != 0)
+					continue;
+
+				num--;
+				ctx->mmap[i] = ctx->mmap[num];
+				(void)memset(&ctx->mmap[num], 0,
+					     sizeof(mmap_region_t));
+				break;
+			}
+		}
+	}
+
+	/* Sort the regions in the order expected by init_xlat_tables_ctx() */
+	mmap_sort(ctx->mmap, num, mmap_map_order);
+
+	if (ret != 0)
+		return;
+
+	ctx->max_pa = max_pa;
+	ctx->max_va = max_va;
+}
+
 #if PLAT_XLAT_TABLES_DYNAMIC
 
 int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
@@ -1159,7 +1404,41 @@ void xlat_setup_dynamic_ctx(xlat_ctx_t *ctx, unsigned long long pa_max,
 
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
-void __init init_xlat_tables_ctx(xlat_ctx_t *ctx)
+/* Zero all the tables of a context before mapping any region. */
+static void __init xlat_tables_clear(xlat_ctx_t *ctx)
+{
+	for (unsigned int i = 0U; i < ctx->base_table_entries; i++)
+		ctx->base_table[i] = INVALID_DESC;
+
+	for (int j = 0; j < ctx->tables_num; j++) {
+#if PLAT_XLAT_TABLES_DYNAMIC
+		ctx->tables_mapped_regions[j] = 0;
+#endif
+		for (unsigned int i = 0U; i < XLAT_TABLE_ENTRIES; i++)
+			ctx->tables[j][i] = INVALID_DESC;
+	}
+}
+
+/* Map a static region while initializing the tables, or panic. */
+static void __init xlat_tables_map_static_region(xlat_ctx_t *ctx,
+						 mmap_region_t *mm)
+{
+	uintptr_t end_va = xlat_tables_map_region(ctx, mm, 0U,
+			ctx->base_table, ctx->base_table_entries,
+			ctx->base_level);
+#if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
+	xlat_clean_dcache_range((uintptr_t)ctx->base_table,
+			   ctx->base_table_entries * sizeof(uint64_t));
+#endif
+	if (end_va != (mm->base_va + mm->size - 1U)) {
+		ERROR("Not enough memory to map region:\n"
+		      " VA:0x%lx  PA:0x%llx  size:0x%zx  attr:0x%x\n",
+		      mm->base_va, mm->base_pa, mm->size, mm->attr);
+		panic();
+	}
+}
+
+static void __init xlat_tables_init_checks(const xlat_ctx_t *ctx)
 {
 	assert(ctx != NULL);
 	assert(!ctx->initialized);
@@ -1168,51 +1447,318 @@ void __init init_xlat_tables_ctx(xlat_ctx_t *ctx)
 	       (ctx->xlat_regime == EL1_EL0_REGIME));
 	assert(!is_mmu_enabled_ctx(ctx));
 
-	mmap_region_t *mm = ctx->mmap;
-
 	assert(ctx->va_max_address >=
 		(xlat_get_min_virt_addr_space_size() - 1U));
 	assert(ctx->va_max_address <= (MAX_VIRT_ADDR_SPACE_SIZE - 1U));
 	assert(IS_POWER_OF_TWO(ctx->va_max_address + 1U));
+}
 
-	xlat_mmap_print(mm);
+/*
+ * Returns true if the XLAT_CONT_ENTRIES entries starting at 'entries' are block
+ * or page descriptors with the same attributes that map a contiguous and
+ * aligned range of physical memory, so that they can be marked with the
+ * contiguous hint.
+ */
+static bool __init xlat_entries_are_contiguous(const uint64_t *entries,
+					       unsigned int level)
+{
+	uint64_t desc_type = (level == XLAT_TABLE_LEVEL_MAX) ?
+			     PAGE_DESC : BLOCK_DESC;
+	unsigned long long block_size = XLAT_BLOCK_SIZE(level);
+	unsigned long long pa = entries[0] & TABLE_ADDR_MASK;
 
-	/* All tables must be zeroed before mapping any region. */
+	if ((entries[0] & DESC_MASK) != desc_type)
+		return false;
 
-	for (unsigned int i = 0U; i < ctx->base_table_entries; i++)
-		ctx->base_table[i] = INVALID_DESC;
+	if ((pa & ((block_size * XLAT_CONT_ENTRIES) - 1U)) != 0U)
+		return false;
 
-	for (int j = 0; j < ctx->tables_num; j++) {
-#if PLAT_XLAT_TABLES_DYNAMIC
-		ctx->tables_mapped_regions[j] = 0;
-#endif
-		for (unsigned int i = 0U; i < XLAT_TABLE_ENTRIES; i++)
-			ctx->tables[j][i] = INVALID_DESC;
+	for (unsigned int i = 1U; i < XLAT_CONT_ENTRIES; i++) {
+		if ((entries[i] & ~TABLE_ADDR_MASK) !=
+		    (entries[0] & ~TABLE_ADDR_MASK))
+			return false;
+
+		if ((entries[i] & TABLE_ADDR_MASK) != (pa + (i * block_size)))
+			return false;
 	}
 
-	while (mm->size != 0U) {
-		uintptr_t end_va = xlat_tables_map_region(ctx, mm, 0U,
-				ctx->base_table, ctx->base_table_entries,
-				ctx->base_level);
-#if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
-		xlat_clean_dcache_range((uintptr_t)ctx->base_table,
-				   ctx->base_table_entries * sizeof(uint64_t));
-#endif
-		if (end_va != (mm->base_va + mm->size - 1U)) {
-			ERROR("Not enough memory to map region:\n"
-			      " VA:0x%lx  PA:0x%llx  size:0x%zx  attr:0x%x\n",
-			      mm->base_va, mm->base_pa, mm->size, mm->attr);
-			panic();
+	return true;
+}
+
+/*
+ * Returns true if the given VA range is inside a single region of the memory
+ * map. Dynamic regions can be removed, and they don't overlap with any other
+ * region, so the entries with the contiguous hint are never split by the
+ * removal of a region.
+ */
+static bool __init xlat_mmap_covers(const xlat_ctx_t *ctx, uintptr_t base_va,
+				    size_t size)
+{
+	uintptr_t end_va = base_va + size - 1U;
+
+	for (const mmap_region_t *mm = ctx->mmap; mm->size != 0U; mm++) {
+		if ((mm->base_va <= base_va) &&
+		    (end_va <= (mm->base_va + mm->size - 1U)))
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Recursive function that sets the contiguous hint in all the aligned groups
+ * of XLAT_CONT_ENTRIES entries of a table and its subtables that can use it.
+ * Returns the number of groups.
+ */
+static unsigned int __init xlat_tables_set_contiguous(const xlat_ctx_t *ctx,
+		uintptr_t table_base_va, uint64_t *table_base,
+		unsigned int table_entries, unsigned int level)
+{
+	size_t level_size = XLAT_BLOCK_SIZE(level);
+	unsigned int groups = 0U;
+	bool changed = false;
+
+	assert(level <= XLAT_TABLE_LEVEL_MAX);
+
+	for (unsigned int i = 0U; i < table_entries; i++) {
+		uint64_t desc = table_base[i];
+
+		if (((desc & DESC_MASK) == TABLE_DESC) &&
+		    (level < XLAT_TABLE_LEVEL_MAX)) {
+			groups += xlat_tables_set_contiguous(ctx,
+				table_base_va + (i * level_size),
+				(uint64_t *)(uintptr_t)(desc & TABLE_ADDR_MASK),
+				XLAT_TABLE_ENTRIES, level + 1U);
 		}
+	}
 
-		mm++;
+	/* There are no blocks above this level */
+	if (level < MIN_LVL_BLOCK_DESC)
+		return groups;
+
+	for (unsigned int i = 0U; (i + XLAT_CONT_ENTRIES) <= table_entries;
+	     i += XLAT_CONT_ENTRIES) {
+		if (!xlat_entries_are_contiguous(&table_base[i], level))
+			continue;
+
+		if (!xlat_mmap_covers(ctx, table_base_va + (i * level_size),
+				      XLAT_CONT_ENTRIES * level_size))
+			continue;
+
+		for (unsigned int j = i; j < (i + XLAT_CONT_ENTRIES); j++)
+			table_base[j] |= UPPER_ATTRS(CONT_HINT);
+
+		groups++;
+		changed = true;
+	}
+
+#if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
+	if (changed) {
+		xlat_clean_dcache_range((uintptr_t)table_base,
+				table_entries * sizeof(uint64_t));
 	}
+#else
+	(void)changed;
+#endif
+
+	return groups;
+}
 
+static void __init xlat_tables_init_done(xlat_ctx_t *ctx)
+{
 	assert(ctx->pa_max_address <= xlat_arch_get_max_supported_pa());
 	assert(ctx->max_va <= ctx->va_max_address);
 	assert(ctx->max_pa <= ctx->pa_max_address);
 
+	/*
+	 * The MMU is still disabled, so the contiguous hint can be set without
+	 * any TLB maintenance.
+	 */
+	unsigned int groups = xlat_tables_set_contiguous(ctx, 0U,
+				ctx->base_table, ctx->base_table_entries,
+				ctx->base_level);
+
+	VERBOSE("Contiguous hint set in %u groups of %u entries.\n", groups,
+		XLAT_CONT_ENTRIES);
+
 	ctx->initialized = true;
 
 	xlat_tables_print(ctx);
 }
+
+void __init init_xlat_tables_ctx(xlat_ctx_t *ctx)
+{
+	xlat_tables_init_checks(ctx);
+
+	mmap_region_t *mm = ctx->mmap;
+
+	xlat_mmap_print(mm);
+
+	/* All tables must be zeroed before mapping any region. */
+	xlat_tables_clear(ctx);
+
+	while (mm->size != 0U) {
+		xlat_tables_map_static_region(ctx, mm);
+		mm++;
+	}
+
+	xlat_tables_init_done(ctx);
+}
+
+#if XLAT_TABLES_AOT
+
+/* Returns true if 'mm' is the region of the generated tables 'r'. */
+static bool xlat_aot_region_match(const mmap_region_t *mm,
+				  const xlat_aot_region_t *r)
+{
+	return (mm->base_pa == r->base_pa) && (mm->base_va == r->base_va) &&
+	       (mm->size == r->size) && (mm->attr == r->attr) &&
+	       (mm->granularity == r->granularity);
+}
+
+/* Returns true if 'mm' is one of the regions mapped by the generated tables. */
+static bool xlat_aot_is_mapped(const xlat_aot_tables_t *aot,
+			       const mmap_region_t *mm)
+{
+	for (unsigned int i = 0U; i < aot->regions_num; i++) {
+		if (xlat_aot_region_match(mm, &aot->regions[i]))
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Check that the tables generated at build time can be used for this context.
+ * All the regions they map must have been added to the context, and the regions
+ * that are mapped at run time must not overlap any of them, since the order in
+ * which the regions are mapped matters when they overlap.
+ */
+static bool __init xlat_aot_check(const xlat_ctx_t *ctx,
+				  const xlat_aot_tables_t *aot)
+{
+	const mmap_region_t *mm;
+	unsigned int i;
+
+	if ((aot->magic != XLAT_AOT_MAGIC) ||
+	    (aot->va_size != ((unsigned long long)ctx->va_max_address + 1ULL)) ||
+	    (aot->tables_num > (unsigned int)ctx->tables_num))
+		return false;
+
+	for (i = 0U; i < aot->regions_num; i++) {
+		for (mm = ctx->mmap; mm->size != 0U; mm++) {
+			if (xlat_aot_region_match(mm, &aot->regions[i]))
+				break;
+		}
+		if (mm->size == 0U)
+			return false;
+	}
+
+	for (mm = ctx->mmap; mm->size != 0U; mm++) {
+		uintptr_t end_va = mm->base_va + mm->size - 1U;
+
+		if (xlat_aot_is_mapped(aot, mm))
+			continue;
+
+		for (i = 0U; i < aot->regions_num; i++) {
+			const xlat_aot_region_t *r = &aot->regions[i];
+
+			if ((mm->base_va <= (r->base_va + r->size - 1U)) &&
+			    (end_va >= r->base_va))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Write the entries of the generated tables into the tables of the context.
+ * The attributes of a block or page descriptor only depend on the region that
+ * it maps and on the translation regime, so they are computed once for each run
+ * of entries of the same region, which is how xlat_gen lists them. The other
+ * entries are copied with their output address and descriptor type.
+ */
+static void __init xlat_aot_load(xlat_ctx_t *ctx, const xlat_aot_tables_t *aot)
+{
+	unsigned int attr_region = aot->regions_num;
+	uint64_t attr_desc = 0U;
+
+	for (unsigned int i = 0U; i < aot->entries_num; i++) {
+		const xlat_aot_entry_t *e = &aot->entries[i];
+		uint64_t *table;
+
+		if (e->table == XLAT_AOT_BASE_TABLE) {
+			assert(e->index < ctx->base_table_entries);
+			table = ctx->base_table;
+		} else {
+			assert(e->table < aot->tables_num);
+			assert(e->index < XLAT_TABLE_ENTRIES);
+			table = ctx->tables[e->table];
+		}
+
+		if (e->type == XLAT_AOT_ENTRY_TABLE) {
+			assert(e->next < aot->tables_num);
+			table[e->index] = TABLE_DESC |
+				(unsigned long)ctx->tables[e->next];
+		} else {
+			assert(e->next < aot->regions_num);
+			assert((e->pa & XLAT_BLOCK_MASK(e->level)) == 0U);
+			if (e->next != attr_region) {
+				attr_region = e->next;
+				attr_desc = xlat_desc(ctx,
+					aot->regions[attr_region].attr, 0ULL,
+					XLAT_TABLE_LEVEL_MAX) & ~(uint64_t)DESC_MASK;
+			}
+			table[e->index] = attr_desc | e->pa |
+				((e->level == XLAT_TABLE_LEVEL_MAX) ?
+				 PAGE_DESC : BLOCK_DESC);
+		}
+	}
+
+#if PLAT_XLAT_TABLES_DYNAMIC
+	for (unsigned int j = 0U; j < aot->tables_num; j++)
+		ctx->tables_mapped_regions[j] = aot->mapped_regions[j];
+#else
+	ctx->next_table = (int)aot->tables_num;
+#endif
+
+#if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
+	xlat_clean_dcache_range((uintptr_t)ctx->base_table,
+			   ctx->base_table_entries * sizeof(uint64_t));
+	for (unsigned int j = 0U; j < aot->tables_num; j++)
+		xlat_clean_dcache_range((uintptr_t)ctx->tables[j],
+				XLAT_TABLE_ENTRIES * sizeof(uint64_t));
+#endif
+}
+
+void __init init_xlat_tables_aot_ctx(xlat_ctx_t *ctx,
+				     const xlat_aot_tables_t *aot)
+{
+	xlat_tables_init_checks(ctx);
+
+	if (!xlat_aot_check(ctx, aot)) {
+		WARN("Translation tables generated at build time don't match "
+		     "the memory map\n");
+		init_xlat_tables_ctx(ctx);
+		return;
+	}
+
+	mmap_region_t *mm = ctx->mmap;
+
+	xlat_mmap_print(mm);
+
+	xlat_tables_clear(ctx);
+	xlat_aot_load(ctx, aot);
+
+	/* Map the regions that were not known at build time */
+	while (mm->size != 0U) {
+		if (!xlat_aot_is_mapped(aot, mm))
+			xlat_tables_map_static_region(ctx, mm);
+		mm++;
+	}
+
+	xlat_tables_init_done(ctx);
+}
+
+#endif /* XLAT_TABLES_AOT */
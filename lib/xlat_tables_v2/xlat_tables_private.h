@@ -59,9 +59,19 @@ uint64_t xlat_arch_regime_get_xn_desc(int xlat_regime);
  */
 void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime);
 
+/*
+ * Invalidate all TLB entries that match the pages of the given virtual address
+ * range, in the same way as xlat_arch_tlbi_va(). This uses the TLBI range
+ * operations if the PE implements them. Large ranges are invalidated by
+ * invalidating all the TLB entries of the translation regime. Returns the
+ * number of TLB maintenance operations issued.
+ */
+unsigned int xlat_arch_tlbi_va_range(uintptr_t va, size_t size,
+				     int xlat_regime);
+
 /*
  * This function has to be called at the end of any code that uses the function
- * xlat_arch_tlbi_va().
+ * xlat_arch_tlbi_va() or xlat_arch_tlbi_va_range().
  */
 void xlat_arch_tlbi_va_sync(void);
 
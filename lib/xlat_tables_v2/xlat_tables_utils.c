@@ -20,6 +20,13 @@
 
 #include "xlat_tables_private.h"
 
+/*
+ * Number of successful calls to xlat_change_mem_attributes_ctx(), for all the
+ * contexts, and number of TLB maintenance operations that they have issued.
+ */
+static unsigned long long change_attr_calls;
+static unsigned long long change_attr_tlbi_ops;
+
 #if LOG_LEVEL < LOG_LEVEL_VERBOSE
 
 void xlat_mmap_print(__unused const mmap_region_t *mmap)
@@ -96,6 +103,9 @@ static void xlat_desc_print(const xlat_ctx_t *ctx, uint64_t desc)
 	}
 
 	printf(((LOWER_ATTRS(NS) & desc) != 0ULL) ? "-NS" : "-S");
+
+	if ((desc & UPPER_ATTRS(CONT_HINT)) != 0ULL)
+		printf("-CONT");
 }
 
 static const char * const level_spacers[] = {
@@ -318,6 +328,53 @@ static uint64_t *find_xlat_table_entry(uintptr_t virtual_addr,
 }
 
 
+/*
+ * Returns the MT_* attributes of the memory mapped by a block or page
+ * descriptor.
+ */
+static uint32_t xlat_desc_get_attributes(const xlat_ctx_t *ctx, uint64_t desc)
+{
+	uint32_t attributes = 0U;
+
+	uint64_t attr_index = (desc >> ATTR_INDEX_SHIFT) & ATTR_INDEX_MASK;
+
+	if (attr_index == ATTR_IWBWA_OWBWA_NTR_INDEX) {
+		attributes |= MT_MEMORY;
+	} else if (attr_index == ATTR_NON_CACHEABLE_INDEX) {
+		attributes |= MT_NON_CACHEABLE;
+	} else {
+		assert(attr_index == ATTR_DEVICE_INDEX);
+		attributes |= MT_DEVICE;
+	}
+
+	uint64_t ap2_bit = (desc >> AP2_SHIFT) & 1U;
+
+	if (ap2_bit == AP2_RW)
+		attributes |= MT_RW;
+
+	if (ctx->xlat_regime == EL1_EL0_REGIME) {
+		uint64_t ap1_bit = (desc >> AP1_SHIFT) & 1U;
+
+		if (ap1_bit == AP1_ACCESS_UNPRIVILEGED)
+			attributes |= MT_USER;
+	}
+
+	uint64_t ns_bit = (desc >> NS_SHIFT) & 1U;
+
+	if (ns_bit == 1U)
+		attributes |= MT_NS;
+
+	uint64_t xn_mask = xlat_arch_regime_get_xn_desc(ctx->xlat_regime);
+
+	if ((desc & xn_mask) == xn_mask) {
+		attributes |= MT_EXECUTE_NEVER;
+	} else {
+		assert((desc & xn_mask) == 0U);
+	}
+
+	return attributes;
+}
+
 static int xlat_get_mem_attributes_internal(const xlat_ctx_t *ctx,
 		uintptr_t base_va, uint32_t *attributes, uint64_t **table_entry,
 		unsigned long long *addr_pa, unsigned int *table_level)
@@ -370,43 +427,7 @@ static int xlat_get_mem_attributes_internal(const xlat_ctx_t *ctx,
 #endif /* LOG_LEVEL >= LOG_LEVEL_VERBOSE */
 
 	assert(attributes != NULL);
-	*attributes = 0U;
-
-	uint64_t attr_index = (desc >> ATTR_INDEX_SHIFT) & ATTR_INDEX_MASK;
-
-	if (attr_index == ATTR_IWBWA_OWBWA_NTR_INDEX) {
-		*attributes |= MT_MEMORY;
-	} else if (attr_index == ATTR_NON_CACHEABLE_INDEX) {
-		*attributes |= MT_NON_CACHEABLE;
-	} else {
-		assert(attr_index == ATTR_DEVICE_INDEX);
-		*attributes |= MT_DEVICE;
-	}
-
-	uint64_t ap2_bit = (desc >> AP2_SHIFT) & 1U;
-
-	if (ap2_bit == AP2_RW)
-		*attributes |= MT_RW;
-
-	if (ctx->xlat_regime == EL1_EL0_REGIME) {
-		uint64_t ap1_bit = (desc >> AP1_SHIFT) & 1U;
-
-		if (ap1_bit == AP1_ACCESS_UNPRIVILEGED)
-			*attributes |= MT_USER;
-	}
-
-	uint64_t ns_bit = (desc >> NS_SHIFT) & 1U;
-
-	if (ns_bit == 1U)
-		*attributes |= MT_NS;
-
-	uint64_t xn_mask = xlat_arch_regime_get_xn_desc(ctx->xlat_regime);
-
-	if ((desc & xn_mask) == xn_mask) {
-		*attributes |= MT_EXECUTE_NEVER;
-	} else {
-		assert((desc & xn_mask) == 0U);
-	}
+	*attributes = xlat_desc_get_attributes(ctx, desc);
 
 	return 0;
 }
@@ -420,18 +441,37 @@ int xlat_get_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 }
 
 
+/*
+ * Returns the entry that maps base_va when walking a range of pages mapped at
+ * page granularity. 'entry' is the entry of the previous page of the range, or
+ * NULL for the first one. The entries of consecutive pages are consecutive in
+ * a level 3 table, so the tables only need to be walked again when base_va is
+ * at the start of a new table.
+ */
+static uint64_t *xlat_next_page_entry(const xlat_ctx_t *ctx, uintptr_t base_va,
+				      uint64_t *entry, unsigned int *level)
+{
+	unsigned long long virt_addr_space_size =
+		(unsigned long long)ctx->va_max_address + 1U;
+
+	if ((entry != NULL) && (*level == XLAT_TABLE_LEVEL_MAX) &&
+	    ((base_va & XLAT_BLOCK_MASK(XLAT_TABLE_LEVEL_MAX - 1U)) != 0U)) {
+		return entry + 1;
+	}
+
+	return find_xlat_table_entry(base_va,
+				     ctx->base_table,
+				     ctx->base_table_entries,
+				     virt_addr_space_size,
+				     level);
+}
+
 int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 				   size_t size, uint32_t attr)
 {
-	/* Note: This implementation isn't optimized. */
-
 	assert(ctx != NULL);
 	assert(ctx->initialized);
 
-	unsigned long long virt_addr_space_size =
-		(unsigned long long)ctx->va_max_address + 1U;
-	assert(virt_addr_space_size > 0U);
-
 	if (!IS_PAGE_ALIGNED(base_va)) {
 		WARN("%s: Address 0x%lx is not aligned on a page boundary.\n",
 		     __func__, base_va);
@@ -461,20 +501,16 @@ int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 		pages_count, base_va);
 
 	uintptr_t base_va_original = base_va;
+	uint64_t *entry = NULL;
+	unsigned int level = 0U;
 
 	/*
 	 * Sanity checks.
 	 */
 	for (size_t i = 0U; i < pages_count; ++i) {
-		const uint64_t *entry;
 		uint64_t desc, attr_index;
-		unsigned int level;
 
-		entry = find_xlat_table_entry(base_va,
-					      ctx->base_table,
-					      ctx->base_table_entries,
-					      virt_addr_space_size,
-					      &level);
+		entry = xlat_next_page_entry(ctx, base_va, entry, &level);
 		if (entry == NULL) {
 			WARN("Address 0x%lx is not mapped.\n", base_va);
 			return -EINVAL;
@@ -510,59 +546,140 @@ int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 		base_va += PAGE_SIZE;
 	}
 
-	/* Restore original value. */
+	/*
+	 * The pages are updated in batches. A batch contains the pages of the
+	 * range that are mapped by the same table, whose entries are
+	 * consecutive.
+	 *
+	 * The break-before-make sequence requires writing an invalid
+	 * descriptor and making sure that the system sees the change before
+	 * writing the new descriptor. This is done for all the pages of a batch
+	 * at once, with a single synchronization after the TLBs have been
+	 * invalidated for the whole batch. The hardware ignores all the bits of
+	 * a descriptor that isn't valid, so the new descriptors are written
+	 * with the valid bit cleared first, and the bit is set afterwards.
+	 *
+	 * All the entries of a group marked with the contiguous hint must have
+	 * the same attributes. If only part of a group is in the range, the
+	 * batch is extended to the whole group and the hint is removed from
+	 * all its entries.
+	 */
+	unsigned long long virt_addr_space_size =
+		(unsigned long long)ctx->va_max_address + 1U;
+	unsigned int tlbi_count = 0U;
+
 	base_va = base_va_original;
 
-	for (unsigned int i = 0U; i < pages_count; ++i) {
+	while (pages_count > 0U) {
+		size_t start = XLAT_TABLE_IDX(base_va, XLAT_TABLE_LEVEL_MAX);
+		size_t end = XLAT_TABLE_ENTRIES;
+		uint64_t *table;
 
-		uint32_t old_attr = 0U, new_attr;
-		uint64_t *entry = NULL;
-		unsigned int level = 0U;
-		unsigned long long addr_pa = 0ULL;
+		if ((end - start) > pages_count)
+			end = start + pages_count;
 
-		(void) xlat_get_mem_attributes_internal(ctx, base_va, &old_attr,
-					    &entry, &addr_pa, &level);
+		entry = find_xlat_table_entry(base_va,
+					      ctx->base_table,
+					      ctx->base_table_entries,
+					      virt_addr_space_size,
+					      &level);
+		assert(entry != NULL);
+		table = entry - start;
 
-		/*
-		 * From attr, only MT_RO/MT_RW, MT_EXECUTE/MT_EXECUTE_NEVER and
-		 * MT_USER/MT_PRIVILEGED are taken into account. Any other
-		 * information is ignored.
-		 */
+		/* Entries of the table that are part of the batch */
+		size_t first = start, last = end;
 
-		/* Clean the old attributes so that they can be rebuilt. */
-		new_attr = old_attr & ~(MT_RW | MT_EXECUTE_NEVER | MT_USER);
+		if ((table[start] & UPPER_ATTRS(CONT_HINT)) != 0U)
+			first = round_down(start, XLAT_CONT_ENTRIES);
 
-		/*
-		 * Update attributes, but filter out the ones this function
-		 * isn't allowed to change.
-		 */
-		new_attr |= attr & (MT_RW | MT_EXECUTE_NEVER | MT_USER);
+		if ((table[end - 1U] & UPPER_ATTRS(CONT_HINT)) != 0U)
+			last = round_up(end, XLAT_CONT_ENTRIES);
 
-		/*
-		 * The break-before-make sequence requires writing an invalid
-		 * descriptor and making sure that the system sees the change
-		 * before writing the new descriptor.
-		 */
-		*entry = INVALID_DESC;
+		for (size_t i = first; i < last; ++i) {
+			uint64_t desc = table[i];
+			size_t group = round_down(i, XLAT_CONT_ENTRIES);
+
+			if ((i >= start) && (i < end)) {
+				uint32_t old_attr, new_attr;
+				unsigned long long addr_pa;
+
+				old_attr = xlat_desc_get_attributes(ctx, desc);
+				addr_pa = desc & TABLE_ADDR_MASK;
+
+				/*
+				 * From attr, only MT_RO/MT_RW,
+				 * MT_EXECUTE/MT_EXECUTE_NEVER and
+				 * MT_USER/MT_PRIVILEGED are taken into account.
+				 * Any other information is ignored.
+				 */
+
+				/*
+				 * Clean the old attributes so that they can be
+				 * rebuilt.
+				 */
+				new_attr = old_attr &
+					   ~(MT_RW | MT_EXECUTE_NEVER | MT_USER);
+
+				/*
+				 * Update attributes, but filter out the ones
+				 * this function isn't allowed to change.
+				 */
+				new_attr |= attr &
+					    (MT_RW | MT_EXECUTE_NEVER | MT_USER);
+
+				desc = xlat_desc(ctx, new_attr, addr_pa, level) |
+				       (desc & UPPER_ATTRS(CONT_HINT));
+			}
+
+			/* Keep the hint of groups that are changed as a whole */
+			if ((group < start) || ((group + XLAT_CONT_ENTRIES) > end))
+				desc &= ~UPPER_ATTRS(CONT_HINT);
+
+			table[i] = desc & ~(uint64_t)VALID_DESC;
+		}
 #if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
-		dccvac((uintptr_t)entry);
+		clean_dcache_range((uintptr_t)&table[first],
+				   (last - first) * sizeof(uint64_t));
 #endif
-		/* Invalidate any cached copy of this mapping in the TLBs. */
-		xlat_arch_tlbi_va(base_va, ctx->xlat_regime);
+
+		/* Invalidate any cached copy of these mappings in the TLBs. */
+		tlbi_count += xlat_arch_tlbi_va_range(
+				base_va - ((start - first) * PAGE_SIZE),
+				(last - first) * PAGE_SIZE, ctx->xlat_regime);
 
 		/* Ensure completion of the invalidation. */
 		xlat_arch_tlbi_va_sync();
 
-		/* Write new descriptor */
-		*entry = xlat_desc(ctx, new_attr, addr_pa, level);
+		/* Make the new descriptors valid */
+		for (size_t i = first; i < last; ++i) {
+			table[i] |= VALID_DESC;
+		}
 #if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
-		dccvac((uintptr_t)entry);
+		clean_dcache_range((uintptr_t)&table[first],
+				   (last - first) * sizeof(uint64_t));
 #endif
-		base_va += PAGE_SIZE;
+
+		base_va += (end - start) * PAGE_SIZE;
+		pages_count -= end - start;
 	}
 
 	/* Ensure that the last descriptor writen is seen by the system. */
 	dsbish();
 
+	VERBOSE("Memory attributes changed with %u TLB maintenance operations.\n",
+		tlbi_count);
+
+	change_attr_calls++;
+	change_attr_tlbi_ops += tlbi_count;
+
 	return 0;
 }
+
+void xlat_get_change_mem_attributes_stat(unsigned long long *calls,
+					 unsigned long long *tlbi_ops)
+{
+	assert((calls != NULL) && (tlbi_ops != NULL));
+
+	*calls = change_attr_calls;
+	*tlbi_ops = change_attr_tlbi_ops;
+}
@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <tf_crc32.h>
+
+#include "zutil.h"
+
+/*
+ * Update the CRC-32 'crc' (0 for the first call) with 'size' bytes of 'buf'.
+ * This is the CRC-32 of zlib, which is also used by GPT.
+ */
+uint32_t tf_crc32(uint32_t crc, const unsigned char *buf, size_t size)
+{
+	return (uint32_t)crc32_z(crc, buf, size);
+}
@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <string.h>
 
 #include <common/debug.h>
@@ -100,3 +101,109 @@ int gunzip(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
 
 	return ret;
 }
+
+static z_stream gunzip_stream;
+static bool gunzip_stream_ended;
+
+/*
+ * gunzip_stream_init - start decompressing gzip data provided in chunks
+ * @out_buf: destination of decompressed output
+ * @out_len: length of out_buf
+ * @work_buf: workspace
+ * @work_len: length of workspace
+ */
+int gunzip_stream_init(uintptr_t out_buf, size_t out_len, uintptr_t work_buf,
+		       size_t work_len)
+{
+	int zret;
+
+	zalloc_start = work_buf;
+	zalloc_end = work_buf + work_len;
+	zalloc_current = zalloc_start;
+
+	memset(&gunzip_stream, 0, sizeof(gunzip_stream));
+	gunzip_stream.next_out = (typeof(gunzip_stream.next_out))out_buf;
+	gunzip_stream.avail_out = out_len;
+	gunzip_stream.zalloc = zcalloc;
+	gunzip_stream.zfree = zfree;
+	gunzip_stream.opaque = (voidpf)0;
+	gunzip_stream_ended = false;
+
+	zret = inflateInit(&gunzip_stream);
+	if (zret != Z_OK) {
+		ERROR("zlib: inflate init failed (ret = %d)\n", zret);
+		return (zret == Z_MEM_ERROR) ? -ENOMEM : -EIO;
+	}
+
+	return 0;
+}
+
+/*
+ * gunzip_stream_update - decompress the next chunk of gzip data
+ * @in_buf: chunk of compressed input. It is fully consumed upon exit.
+ * @in_len: length of in_buf
+ */
+int gunzip_stream_update(uintptr_t in_buf, size_t in_len)
+{
+	int zret;
+
+	/* Trailing data after the end of the gzip stream is ignored */
+	if (gunzip_stream_ended)
+		return 0;
+
+	gunzip_stream.next_in = (typeof(gunzip_stream.next_in))in_buf;
+	gunzip_stream.avail_in = in_len;
+
+	zret = inflate(&gunzip_stream, Z_NO_FLUSH);
+	if (zret == Z_STREAM_END) {
+		gunzip_stream_ended = true;
+		return 0;
+	}
+
+	/*
+	 * Z_BUF_ERROR: the chunk did not contain enough data to progress. If
+	 * some input is left, inflate() stopped because the output is full.
+	 */
+	if ((zret == Z_OK) || (zret == Z_BUF_ERROR)) {
+		if (gunzip_stream.avail_in == 0U)
+			return 0;
+
+		ERROR("zlib: output buffer too small\n");
+		return -ENOBUFS;
+	}
+
+	if (gunzip_stream.msg)
+		ERROR("%s\n", gunzip_stream.msg);
+	ERROR("zlib: inflate failed (ret = %d)\n", zret);
+
+	return (zret == Z_MEM_ERROR) ? -ENOMEM : -EIO;
+}
+
+/*
+ * gunzip_stream_finish - finish decompressing gzip data provided in chunks
+ * @out_buf: upon exit, the end of output
+ */
+int gunzip_stream_finish(uintptr_t *out_buf)
+{
+	int ret = 0;
+
+	if (!gunzip_stream_ended) {
+		ERROR("zlib: truncated input\n");
+		ret = -EIO;
+	}
+
+	VERBOSE("zlib: %lu byte input\n", gunzip_stream.total_in);
+	VERBOSE("zlib: %lu byte output\n", gunzip_stream.total_out);
+
+	*out_buf = (uintptr_t)gunzip_stream.next_out;
+
+	inflateEnd(&gunzip_stream);
+
+	return ret;
+}
+
+const stream_decompressor_t gunzip_stream_decompressor = {
+	.init = gunzip_stream_init,
+	.update = gunzip_stream_update,
+	.finish = gunzip_stream_finish,
+};
@@ -17,6 +17,7 @@ ZLIB_SOURCES	:=	$(addprefix $(ZLIB_PATH)/,	\
 
 # Implemented for TF
 ZLIB_SOURCES	+=	$(addprefix $(ZLIB_PATH)/,	\
+					tf_crc32.c	\
 					tf_gunzip.c)
 
 INCLUDES	+=	-Iinclude/lib/zlib
@@ -183,6 +183,15 @@ endef
 
 GZIP_SUFFIX := .gz
 
+# LZ4 (frame format, with the content size recorded in the frame header)
+define LZ4_RULE
+$(1): $(2)
+	$(ECHO) "  LZ4     $$@"
+	$(Q)lz4 -9 -f -q --content-size $$< --stdout > $$@
+endef
+
+LZ4_SUFFIX := .lz4
+
 ################################################################################
 # Auxiliary macros to build TF images from sources
 ################################################################################
@@ -16,6 +16,14 @@ AARCH32_INSTRUCTION_SET		:= T32
 # The AArch32 Secure Payload to be built as BL32 image
 AARCH32_SP			:= none
 
+# Calculate the hash of images authenticated by hash while they are being
+# loaded, instead of in a separate pass once they have been loaded.
+AUTH_STREAM_HASH		:= 0
+
+# Keep the hashes of the certificates that have been verified in memory that
+# persists across warm resets, so that their signatures are not checked again.
+AUTH_VERIFIED_CACHE		:= 0
+
 # The Target build architecture. Supported values are: aarch64, aarch32.
 ARCH				:= aarch64
 
@@ -33,10 +41,16 @@ BL2_AT_EL3			:= 0
 # when BL2_AT_EL3 is 1.
 BL2_IN_XIP_MEM			:= 0
 
+# Read the next image in BL2 while the current one is being authenticated
+BL2_IMAGE_PREFETCH		:= 0
+
 # By default, consider that the platform may release several CPUs out of reset.
 # The platform Makefile is free to override this value.
 COLD_BOOT_SINGLE_CPU		:= 0
 
+# Build the log buffer console into BL31 and drain it when a CPU powers down
+CONSOLE_LOGBUF			:= 0
+
 # Flag to compile in coreboot support code. Exclude by default. The coreboot
 # Makefile system will set this when compiling TF as part of a coreboot image.
 COREBOOT			:= 0
@@ -44,6 +58,10 @@ COREBOOT			:= 0
 # For Chain of Trust
 CREATE_KEYS			:= 1
 
+# Switch the FP registers included by CTX_INCLUDE_FPREGS on their first use
+# after a world switch, instead of on every world switch
+CTX_FPREGS_LAZY			:= 0
+
 # Build flag to include AArch32 registers in cpu context save and restore during
 # world switch. This flag must be set to 0 for AArch64-only platforms.
 CTX_INCLUDE_AARCH32_REGS	:= 1
@@ -78,6 +96,13 @@ ENABLE_PMF			:= 0
 # Flag to enable PSCI STATs functionality
 ENABLE_PSCI_STAT		:= 0
 
+# Flag to let runtime services register handlers for individual SMC function
+# IDs, which are then called without going through the handler of the service
+RT_SVC_FID_HANDLERS		:= 0
+
+# Flag to record the time taken to dispatch SMCs and to run their handlers
+RT_SVC_DISPATCH_STATS		:= 0
+
 # Flag to enable runtime instrumentation using PMF
 ENABLE_RUNTIME_INSTRUMENTATION	:= 0
 
@@ -87,6 +112,10 @@ ENABLE_STACK_PROTECTOR		:= 0
 # Flag to enable exception handling in EL3
 EL3_EXCEPTION_HANDLING		:= 0
 
+# Flag to keep statistics of the latency of the EL3 interrupts handled by the
+# exception handling framework in a shared memory buffer
+EHF_LATENCY_STATS		:= 0
+
 # Flag to enable Pointer Authentication
 ENABLE_PAUTH			:= 0
 
@@ -136,6 +165,10 @@ OVERRIDE_LIBC			:= 0
 # Build PL011 UART driver in minimal generic UART mode
 PL011_GENERIC_UART		:= 0
 
+# Flag to also append the PMF time-stamps to per-CPU ring buffers in a shared
+# memory buffer
+PMF_RING_BUFFERS		:= 0
+
 # By default, consider that the platform's reset address is not programmable.
 # The platform Makefile is free to override this value.
 PROGRAMMABLE_RESET_ADDRESS	:= 0
@@ -143,6 +176,17 @@ PROGRAMMABLE_RESET_ADDRESS	:= 0
 # Flag used to choose the power state format: Extended State-ID or Original
 PSCI_EXTENDED_STATE_ID		:= 0
 
+# Flag to use MCS queue locks for the PSCI power domain locks on systems with
+# hardware-assisted coherency
+PSCI_MCS_LOCKS			:= 0
+
+# Flag to keep histograms of the PSCI statistics in a shared memory buffer
+PSCI_STAT_HISTOGRAMS		:= 0
+
+# Flag to let CPU_SUSPEND skip the power domain locks when it cannot power down
+# any power domain above the CPU
+PSCI_SUSPEND_FAST_PATH		:= 0
+
 # Enable RAS support
 RAS_EXTENSION			:= 0
 
@@ -152,6 +196,10 @@ RESET_TO_BL31			:= 0
 # For Chain of Trust
 SAVE_KEYS			:= 0
 
+# Flag to let the SDEI dispatcher dispatch the next pending event as soon as an
+# event is completed, without returning to the preempted context first
+SDEI_BATCHED_DISPATCH		:= 0
+
 # Software Delegated Exception support
 SDEI_SUPPORT            	:= 0
 
@@ -182,6 +230,9 @@ TRUSTED_BOARD_BOOT		:= 0
 # Build option to choose whether Trusted Firmware uses Coherent memory or not.
 USE_COHERENT_MEM		:= 1
 
+# Use the AArch64 assembly versions of memcpy, memmove and memset in libc
+USE_OPTIMIZED_MEMFUNCS		:= 0
+
 # Build option to choose whether Trusted Firmware uses library at ROM
 USE_ROMLIB			:= 0
 
@@ -197,6 +248,9 @@ V				:= 0
 # platforms).
 WARMBOOT_ENABLE_DCACHE_EARLY	:= 0
 
+# Generate the translation tables of the static regions of BL31 at build time
+XLAT_TABLES_AOT			:= 0
+
 # Build option to enable/disable the Statistical Profiling Extensions
 ENABLE_SPE_FOR_LOWER_ELS	:= 1
 
@@ -154,6 +154,9 @@
 #define MAX_IO_DEVICES			3
 #define MAX_IO_HANDLES			4
 
+/* Cache the whole ToC of the FIPs built for FVP, including the certificates */
+#define FIP_TOC_CACHE_ENTRIES		32
+
 /* Reserve the last block of flash for PSCI MEM PROTECT flag */
 #define PLAT_ARM_FIP_BASE		V2M_FLASH0_BASE
 #define PLAT_ARM_FIP_MAX_SIZE		(V2M_FLASH0_SIZE - V2M_FLASH_BLOCK_SIZE)
@@ -92,6 +92,9 @@ PLAT_INCLUDES		:=	-Iplat/arm/board/fvp/include
 
 PLAT_BL_COMMON_SOURCES	:=	plat/arm/board/fvp/fvp_common.c
 
+# Defines plat_arm_mmap, see XLAT_TABLES_AOT
+XLAT_AOT_MMAP_SOURCE	:=	plat/arm/board/fvp/fvp_common.c
+
 FVP_CPU_LIBS		:=	lib/cpus/${ARCH}/aem_generic.S
 
 ifeq (${ARCH}, aarch64)
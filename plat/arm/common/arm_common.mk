@@ -149,6 +149,21 @@ PLAT_BL_COMMON_SOURCES	+=	plat/arm/common/${ARCH}/arm_helpers.S		\
 				plat/arm/common/arm_common.c			\
 				plat/arm/common/arm_console.c
 
+# Static regions whose translation tables are generated at build time when
+# XLAT_TABLES_AOT is enabled. The board makefile sets XLAT_AOT_MMAP_SOURCE to the
+# file that defines them. XLAT_AOT_VA_BITS matches PLAT_VIRT_ADDR_SPACE_SIZE in
+# arm_def.h, and the generated file fails to build if they differ.
+XLAT_AOT_MMAP_SYMBOL	:=	plat_arm_mmap
+ifeq (${ARCH},aarch64)
+XLAT_AOT_VA_BITS	:=	36
+endif
+
+ifeq (${XLAT_TABLES_AOT}, 1)
+    ifeq (${ARM_XLAT_TABLES_LIB_V1}, 1)
+        $(error "XLAT_TABLES_AOT is not supported with ARM_XLAT_TABLES_LIB_V1")
+    endif
+endif
+
 ifeq (${ARM_XLAT_TABLES_LIB_V1}, 1)
 PLAT_BL_COMMON_SOURCES	+=	lib/xlat_tables/xlat_tables_common.c		\
 				lib/xlat_tables/${ARCH}/xlat_tables.c
@@ -11,6 +11,7 @@
 #include <common/debug.h>
 #include <drivers/arm/pl011.h>
 #include <drivers/console.h>
+#include <drivers/logbuf_console.h>
 #include <plat/arm/common/plat_arm.h>
 
 /*******************************************************************************
@@ -21,6 +22,21 @@ static console_pl011_t arm_boot_console;
 static console_pl011_t arm_runtime_console;
 #endif
 
+/*
+ * With CONSOLE_LOGBUF, the runtime logs of BL31 are stored in this buffer and
+ * only written to the runtime UART when the consoles are flushed or when BL31
+ * crashes.
+ */
+#if CONSOLE_LOGBUF && defined(IMAGE_BL31)
+#ifndef PLAT_ARM_LOGBUF_SIZE
+#define PLAT_ARM_LOGBUF_SIZE	U(0x2000)
+#endif
+
+static console_logbuf_t arm_logbuf_console;
+static uint8_t arm_logbuf[PLAT_ARM_LOGBUF_SIZE]
+	__aligned(CACHE_WRITEBACK_GRANULE);
+#endif
+
 /* Initialize the console to provide early debug support */
 void __init arm_console_boot_init(void)
 {
@@ -68,7 +84,18 @@ void arm_console_runtime_init(void)
 	if (rc == 0)
 		panic();
 
+#if CONSOLE_LOGBUF && defined(IMAGE_BL31)
+	rc = console_logbuf_register((uintptr_t)arm_logbuf, sizeof(arm_logbuf),
+				     &arm_runtime_console.console,
+				     &arm_logbuf_console);
+	if (rc == 0)
+		panic();
+
+	console_set_scope(&arm_logbuf_console.console, CONSOLE_FLAG_RUNTIME);
+	console_set_scope(&arm_runtime_console.console, CONSOLE_FLAG_CRASH);
+#else
 	console_set_scope(&arm_runtime_console.console, CONSOLE_FLAG_RUNTIME);
+#endif
 #else
 	(void)console_init(PLAT_ARM_RUN_UART_BASE,
 			   PLAT_ARM_RUN_UART_CLK_IN_HZ,
@@ -81,6 +108,9 @@ void arm_console_runtime_end(void)
 	(void)console_flush();
 
 #if MULTI_CONSOLE_API
+#if CONSOLE_LOGBUF && defined(IMAGE_BL31)
+	(void)console_unregister(&arm_logbuf_console.console);
+#endif
 	(void)console_unregister(&arm_runtime_console.console);
 #else
 	console_uninit();
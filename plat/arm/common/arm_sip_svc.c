@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -9,6 +9,7 @@
 #include <common/debug.h>
 #include <common/runtime_svc.h>
 #include <lib/pmf/pmf.h>
+#include <lib/psci/psci.h>
 #include <plat/arm/common/arm_sip_svc.h>
 #include <plat/arm/common/plat_arm.h>
 #include <tools_share/uuid.h>
@@ -69,6 +70,32 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 				(uint32_t) x4, handle);
 		}
 
+#if ENABLE_PSCI_STAT
+	case ARM_SIP_SVC_PSCI_LOCK_STAT64: {
+		psci_lock_stat_t stat;
+		int rc;
+
+		rc = psci_get_lock_stat((unsigned int)x1, &stat);
+		if (rc != PSCI_E_SUCCESS)
+			SMC_RET1(handle, rc);
+
+		SMC_RET5(handle, SMC_OK, stat.acquisitions, stat.wait_ticks,
+			 stat.max_wait_ticks, stat.skipped);
+		}
+#endif
+
+#if RT_SVC_DISPATCH_STATS
+	case ARM_SIP_SVC_SMC_DISPATCH_STAT64: {
+		rt_svc_dispatch_stat_t stat;
+
+		rt_svc_get_dispatch_stat(&stat);
+
+		SMC_RET6(handle, SMC_OK, stat.count, stat.dispatch_ticks,
+			 stat.max_dispatch_ticks, stat.handler_ticks,
+			 stat.max_handler_ticks);
+		}
+#endif
+
 	case ARM_SIP_SVC_CALL_COUNT:
 		/* PMF calls */
 		call_count += PMF_NUM_SMC_CALLS;
@@ -76,6 +103,16 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 		/* State switch call */
 		call_count += 1;
 
+#if ENABLE_PSCI_STAT
+		/* PSCI lock statistics call */
+		call_count += 1;
+#endif
+
+#if RT_SVC_DISPATCH_STATS
+		/* SMC dispatch statistics call */
+		call_count += 1;
+#endif
+
 		SMC_RET1(handle, call_count);
 
 	case ARM_SIP_SVC_UID:
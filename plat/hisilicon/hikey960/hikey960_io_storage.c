@@ -35,6 +35,8 @@ static int check_ufs(const uintptr_t spec);
 static int check_fip(const uintptr_t spec);
 size_t ufs_read_lun3_blks(int lba, uintptr_t buf, size_t size);
 size_t ufs_write_lun3_blks(int lba, const uintptr_t buf, size_t size);
+int ufs_submit_lun3_blks(int lba, uintptr_t buf, size_t size);
+int ufs_poll_lun3_blks(size_t *length_read);
 
 static const io_block_spec_t ufs_fip_spec = {
 	.offset		= HIKEY960_FIP_BASE,
@@ -50,10 +52,16 @@ static const io_block_dev_spec_t ufs_dev_spec = {
 	.ops		= {
 		.read	= ufs_read_lun3_blks,
 		.write	= ufs_write_lun3_blks,
+		.read_submit	= ufs_submit_lun3_blks,
+		.read_poll	= ufs_poll_lun3_blks,
 	},
 	.block_size	= UFS_BLOCK_SIZE,
+	.direct_align	= CACHE_WRITEBACK_GRANULE,
 };
 
+/* Queued UFS transfer of the asynchronous reads */
+static ufs_xfer_t ufs_lun3_xfer;
+
 static const io_uuid_spec_t scp_bl2_uuid_spec = {
 	.uuid = UUID_SCP_FIRMWARE_SCP_BL2,
 };
@@ -283,3 +291,18 @@ size_t ufs_write_lun3_blks(int lba, const uintptr_t buf, size_t size)
 {
 	return ufs_write_blocks(3, lba, buf, size);
 }
+
+int ufs_submit_lun3_blks(int lba, uintptr_t buf, size_t size)
+{
+	return ufs_queue_read(3, lba, buf, size, &ufs_lun3_xfer);
+}
+
+int ufs_poll_lun3_blks(size_t *length_read)
+{
+	int result;
+
+	result = ufs_queue_poll(&ufs_lun3_xfer);
+	if (result == 0)
+		*length_read = ufs_lun3_xfer.done;
+	return result;
+}
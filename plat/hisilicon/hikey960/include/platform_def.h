@@ -111,6 +111,13 @@
 #define SCP_BL2_BASE			(0x89C80000)
 #define SCP_BL2_SIZE			(0x00040000)
 
+/*
+ * Staging buffer of BL2_IMAGE_PREFETCH, in non-secure DDR just below the UFS
+ * data buffer. It is large enough for the OP-TEE pager and UEFI images.
+ */
+#define PLAT_BL2_PREFETCH_BASE		(0x0F000000)
+#define PLAT_BL2_PREFETCH_SIZE		(0x01000000)
+
 /*
  * Platform specific page table and MMU setup constants
  */
@@ -147,4 +147,10 @@ ERRATA_A53_836870		:=	1
 ERRATA_A53_843419		:=	1
 ERRATA_A53_855873		:=	1
 
+# The asynchronous reads of BL2_IMAGE_PREFETCH only go straight to the UFS when
+# the images start on a UFS block (4KB). Otherwise they are read synchronously.
+ifeq (${BL2_IMAGE_PREFETCH},1)
+FIP_ALIGN			:=	4096
+else
 FIP_ALIGN			:=	512
+endif
@@ -202,6 +202,11 @@ static void warp7_setup_pinmux(void)
 				     WARP7_UART6_RX_FEATURES);
 }
 
+/* ADMA2 descriptors of the uSDHC, for reads of up to 1MB per command */
+#define WARP7_USDHC_ADMA2_DESCS		16
+static struct mmc_adma2_desc warp7_usdhc_adma2[WARP7_USDHC_ADMA2_DESCS]
+	__aligned(CACHE_WRITEBACK_GRANULE);
+
 static void warp7_usdhc_setup(void)
 {
 	imx_usdhc_params_t params;
@@ -211,6 +216,8 @@ static void warp7_usdhc_setup(void)
 	params.reg_base = PLAT_WARP7_BOOT_MMC_BASE;
 	params.clk_rate = 25000000;
 	params.bus_width = MMC_BUS_WIDTH_8;
+	params.desc_base = (uintptr_t)warp7_usdhc_adma2;
+	params.desc_size = sizeof(warp7_usdhc_adma2);
 	info.mmc_dev_type = MMC_IS_EMMC;
 	imx_usdhc_init(&params, &info);
 }
@@ -54,7 +54,7 @@ const char a2[] = {0xa2, 0x0};
 
 static const io_block_spec_t gpt_block_spec = {
 	.offset = 0,
-	.length = MMC_BLOCK_SIZE
+	.length = 34 * MMC_BLOCK_SIZE, /* Size of GPT table */
 };
 
 static int check_fip(const uintptr_t spec);
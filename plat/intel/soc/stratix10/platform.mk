@@ -4,6 +4,8 @@
 # SPDX-License-Identifier: BSD-3-Clause
 #
 
+include lib/zlib/zlib.mk
+
 PLAT_INCLUDES		:=	\
 			-Iplat/intel/soc/stratix10/			\
 			-Iplat/intel/soc/stratix10/include/		\
@@ -24,6 +26,8 @@ PLAT_BL_COMMON_SOURCES	:=	\
 BL2_SOURCES     +=	\
 		drivers/partition/partition.c				\
 		drivers/partition/gpt.c					\
+		$(ZLIB_PATH)/crc32.c					\
+		$(ZLIB_PATH)/tf_crc32.c					\
 		drivers/arm/pl061/pl061_gpio.c				\
 		drivers/mmc/mmc.c					\
 		drivers/synopsys/emmc/dw_mmc.c				\
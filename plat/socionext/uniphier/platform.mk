@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -107,6 +107,14 @@ BL2_SOURCES		+=	common/image_decompress.c		\
 
 $(eval $(call add_define,UNIPHIER_DECOMPRESS_GZIP))
 
+# decompress the images while they are being loaded
+ifeq (${FIP_GZIP_STREAM},1)
+ifeq (${TRUSTED_BOARD_BOOT}-${AUTH_STREAM_HASH},1-0)
+$(error "FIP_GZIP_STREAM requires AUTH_STREAM_HASH=1 with TRUSTED_BOARD_BOOT")
+endif
+$(eval $(call add_define,UNIPHIER_DECOMPRESS_GZIP_STREAM))
+endif
+
 # compress all images loaded by BL2
 SCP_BL2_PRE_TOOL_FILTER	:= GZIP
 BL31_PRE_TOOL_FILTER	:= GZIP
@@ -115,6 +123,33 @@ BL33_PRE_TOOL_FILTER	:= GZIP
 
 endif
 
+ifeq (${FIP_GZIP_STREAM},1)
+ifneq (${FIP_GZIP},1)
+$(error "FIP_GZIP_STREAM requires FIP_GZIP=1")
+endif
+endif
+
+ifeq (${FIP_LZ4},1)
+
+ifeq (${FIP_GZIP},1)
+$(error "FIP_GZIP and FIP_LZ4 are mutually exclusive")
+endif
+
+include lib/lz4/lz4.mk
+
+BL2_SOURCES		+=	common/image_decompress.c		\
+				$(LZ4_SOURCES)
+
+$(eval $(call add_define,UNIPHIER_DECOMPRESS_LZ4))
+
+# compress all images loaded by BL2
+SCP_BL2_PRE_TOOL_FILTER	:= LZ4
+BL31_PRE_TOOL_FILTER	:= LZ4
+BL32_PRE_TOOL_FILTER	:= LZ4
+BL33_PRE_TOOL_FILTER	:= LZ4
+
+endif
+
 .PHONY: bl2_gzip
 bl2_gzip: $(BUILD_PLAT)/bl2.bin.gz
 %.gz: %
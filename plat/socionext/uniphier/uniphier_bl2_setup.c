@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -17,6 +17,11 @@
 #include <plat/common/platform.h>
 #ifdef UNIPHIER_DECOMPRESS_GZIP
 #include <tf_gunzip.h>
+#define UNIPHIER_DECOMPRESSOR	gunzip
+#endif
+#ifdef UNIPHIER_DECOMPRESS_LZ4
+#include <tf_lz4.h>
+#define UNIPHIER_DECOMPRESSOR	lz4_decompress
 #endif
 
 #include "uniphier.h"
@@ -118,16 +123,21 @@ bl_params_t *plat_get_next_bl_params(void)
 
 void bl2_plat_preload_setup(void)
 {
-#ifdef UNIPHIER_DECOMPRESS_GZIP
+#if defined(UNIPHIER_DECOMPRESS_GZIP_STREAM)
+	image_decompress_stream_init(UNIPHIER_IMAGE_BUF_BASE,
+				     UNIPHIER_IMAGE_BUF_SIZE,
+				     UNIPHIER_IMAGE_CHUNK_SIZE,
+				     &gunzip_stream_decompressor);
+#elif defined(UNIPHIER_DECOMPRESSOR)
 	image_decompress_init(UNIPHIER_IMAGE_BUF_BASE,
 			      UNIPHIER_IMAGE_BUF_SIZE,
-			      gunzip);
+			      UNIPHIER_DECOMPRESSOR);
 #endif
 }
 
 int bl2_plat_handle_pre_image_load(unsigned int image_id)
 {
-#ifdef UNIPHIER_DECOMPRESS_GZIP
+#ifdef UNIPHIER_DECOMPRESSOR
 	image_decompress_prepare(uniphier_get_image_info(image_id));
 #endif
 	return 0;
@@ -135,7 +145,7 @@ int bl2_plat_handle_pre_image_load(unsigned int image_id)
 
 int bl2_plat_handle_post_image_load(unsigned int image_id)
 {
-#ifdef UNIPHIER_DECOMPRESS_GZIP
+#ifdef UNIPHIER_DECOMPRESSOR
 	struct image_info *image_info;
 	int ret;
 
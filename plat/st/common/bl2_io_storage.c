@@ -5,6 +5,7 @@
  */
 
 #include <assert.h>
+#include <stdint.h>
 #include <string.h>
 
 #include <platform_def.h>
@@ -31,6 +32,7 @@ static uintptr_t dummy_dev_spec;
 
 static uintptr_t image_dev_handle;
 
+/* Extended to the whole device once its size is known */
 static io_block_spec_t gpt_block_spec = {
 	.offset = 0,
 	.length = 34 * MMC_BLOCK_SIZE, /* Size of GPT table */
@@ -49,6 +51,11 @@ static const io_block_dev_spec_t mmc_block_dev_spec = {
 		.write = NULL,
 	},
 	.block_size = MMC_BLOCK_SIZE,
+	/*
+	 * The SDMMC2 FIFO is read with 32-bit accesses, and the DMA mode also
+	 * needs whole cache lines.
+	 */
+	.direct_align = CACHE_WRITEBACK_GRANULE,
 };
 
 static uintptr_t storage_dev_handle;
@@ -170,6 +177,7 @@ void stm32mp_io_setup(void)
 	struct stm32_sdmmc2_params params;
 	struct mmc_device_info device_info;
 	uintptr_t mmc_default_instance;
+	unsigned long long device_size;
 	const partition_entry_t *entry;
 	boot_api_context_t *boot_context =
 		(boot_api_context_t *)stm32mp_get_boot_ctx_address();
@@ -240,13 +248,23 @@ void stm32mp_io_setup(void)
 					&storage_dev_handle);
 		assert(io_result == 0);
 
+		/*
+		 * Give access to the whole device, so that the backup GPT in
+		 * its last block can be used if the primary one is corrupted.
+		 * The offsets of io_block cannot reach the end of devices larger
+		 * than 4GB on AArch32, which only use the primary GPT.
+		 */
+		device_size = stm32_sdmmc2_mmc_get_device_size();
+		if (device_size <= SIZE_MAX) {
+			gpt_block_spec.length = (size_t)device_size;
+		}
+
 		partition_init(GPT_IMAGE_ID);
 
 		io_result = io_dev_close(storage_dev_handle);
 		assert(io_result == 0);
 
-		stm32image_dev_info_spec.device_size =
-			stm32_sdmmc2_mmc_get_device_size();
+		stm32image_dev_info_spec.device_size = device_size;
 
 		for (idx = 0U; idx < IMG_IDX_NUM; idx++) {
 			part = &stm32image_dev_info_spec.part_info[idx];
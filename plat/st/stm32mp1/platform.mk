@@ -30,6 +30,7 @@ FDT_SOURCES		:=	$(addprefix fdts/, $(patsubst %.dtb,%.dts,$(DTB_FILE_NAME)))
 DTC_FLAGS		+=	-Wno-unit_address_vs_reg
 
 include lib/libfdt/libfdt.mk
+include lib/zlib/zlib.mk
 
 PLAT_BL_COMMON_SOURCES	:=	plat/st/common/stm32mp_common.c				\
 				plat/st/stm32mp1/stm32mp1_private.c
@@ -75,6 +76,8 @@ BL2_SOURCES		+=	drivers/mmc/mmc.c					\
 				drivers/partition/gpt.c					\
 				drivers/partition/partition.c				\
 				drivers/st/io/io_mmc.c					\
+				$(ZLIB_PATH)/crc32.c					\
+				$(ZLIB_PATH)/tf_crc32.c					\
 				drivers/st/mmc/stm32_sdmmc2.c
 
 BL2_SOURCES		+=	drivers/st/ddr/stm32mp1_ddr.c				\
@@ -121,12 +121,52 @@ static uintptr_t arm_arch_svc_smc_handler(uint32_t smc_fid,
 	}
 }
 
+#if RT_SVC_FID_HANDLERS
+/*
+ * Handler for the workaround calls, which are issued at a high rate by some
+ * normal world software. The workarounds have already been applied during
+ * entry to EL3, so there is nothing left to do.
+ */
+static uintptr_t arm_arch_svc_workaround_handler(uint32_t smc_fid,
+	u_register_t x1,
+	u_register_t x2,
+	u_register_t x3,
+	u_register_t x4,
+	void *cookie,
+	void *handle,
+	u_register_t flags)
+{
+	SMC_RET0(handle);
+}
+
+/*
+ * The calls are still handled by arm_arch_svc_smc_handler() if the handlers
+ * cannot be registered, so this is not an error.
+ */
+static int32_t arm_arch_svc_setup(void)
+{
+#if WORKAROUND_CVE_2017_5715
+	if (rt_svc_register_fid_handler(SMCCC_ARCH_WORKAROUND_1,
+				arm_arch_svc_workaround_handler) != 0)
+		WARN("Failed to register SMCCC_ARCH_WORKAROUND_1 handler\n");
+#endif
+#if WORKAROUND_CVE_2018_3639
+	if (rt_svc_register_fid_handler(SMCCC_ARCH_WORKAROUND_2,
+				arm_arch_svc_workaround_handler) != 0)
+		WARN("Failed to register SMCCC_ARCH_WORKAROUND_2 handler\n");
+#endif
+	return 0;
+}
+#else
+#define arm_arch_svc_setup	NULL
+#endif /* RT_SVC_FID_HANDLERS */
+
 /* Register Standard Service Calls as runtime service */
 DECLARE_RT_SVC(
 		arm_arch_svc,
 		OEN_ARM_START,
 		OEN_ARM_END,
 		SMC_TYPE_FAST,
-		NULL,
+		arm_arch_svc_setup,
 		arm_arch_svc_smc_handler
 );
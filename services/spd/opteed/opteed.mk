@@ -13,3 +13,22 @@ SPD_SOURCES		:=	services/spd/opteed/opteed_common.c	\
 				services/spd/opteed/opteed_pm.c
 
 NEED_BL32		:=	yes
+
+# Groups of EL1 system registers that OP-TEE uses, as a mask of the
+# CTX_EL1_REGS_* flags of context.h. Only these are switched between OP-TEE and
+# the Normal world.
+OPTEED_EL1_CTX_REGS	?=	CTX_EL1_REGS_ALL
+
+# SDEI and EHF dispatch to the Normal world through cm_el1_sysregs_context_*(),
+# which always switch all the EL1 registers, while OP-TEE may be preempted with
+# only some of them saved.
+ifneq ($(filter-out CTX_EL1_REGS_ALL 0x3f 0x3F 63,$(OPTEED_EL1_CTX_REGS)),)
+ifeq ($(SDEI_SUPPORT),1)
+$(error When SDEI_SUPPORT=1, OPTEED_EL1_CTX_REGS must be CTX_EL1_REGS_ALL)
+endif
+ifeq ($(EL3_EXCEPTION_HANDLING),1)
+$(error When EL3_EXCEPTION_HANDLING=1, OPTEED_EL1_CTX_REGS must be CTX_EL1_REGS_ALL)
+endif
+endif
+
+$(eval $(call add_define,OPTEED_EL1_CTX_REGS))
@@ -76,7 +76,7 @@ uint64_t opteed_synchronous_sp_entry(optee_context_t *optee_ctx)
 
 	/* Apply the Secure EL1 system register context and switch to it */
 	assert(cm_get_context(SECURE) == &optee_ctx->cpu_ctx);
-	cm_el1_sysregs_context_restore(SECURE);
+	cm_el1_sysregs_context_restore_mask(SECURE, OPTEED_EL1_CTX_REGS);
 	cm_set_next_eret_context(SECURE);
 
 	rc = opteed_enter_sp(&optee_ctx->c_rt_ctx);
@@ -101,7 +101,7 @@ void opteed_synchronous_sp_exit(optee_context_t *optee_ctx, uint64_t ret)
 	assert(optee_ctx != NULL);
 	/* Save the Secure EL1 system register context */
 	assert(cm_get_context(SECURE) == &optee_ctx->cpu_ctx);
-	cm_el1_sysregs_context_save(SECURE);
+	cm_el1_sysregs_context_save_mask(SECURE, OPTEED_EL1_CTX_REGS);
 
 	assert(optee_ctx->c_rt_ctx != 0);
 	opteed_exit_sp(optee_ctx->c_rt_ctx, ret);
@@ -31,6 +31,15 @@
 #include "teesmc_opteed.h"
 #include "teesmc_opteed_macros.h"
 
+/*
+ * Platform makefiles are parsed after opteed.mk, so check again here that
+ * partial EL1 context switching is not combined with SDEI or EHF.
+ */
+#if (OPTEED_EL1_CTX_REGS != CTX_EL1_REGS_ALL) && \
+	(SDEI_SUPPORT || EL3_EXCEPTION_HANDLING)
+#error "OPTEED_EL1_CTX_REGS must be CTX_EL1_REGS_ALL with SDEI or EHF"
+#endif
+
 /*******************************************************************************
  * Address of the entrypoint vector table in OPTEE. It is
  * initialised once on the primary core after a cold boot.
@@ -65,7 +74,7 @@ static uint64_t opteed_sel1_interrupt_handler(uint32_t id,
 	assert(handle == cm_get_context(NON_SECURE));
 
 	/* Save the non-secure context before entering the OPTEE */
-	cm_el1_sysregs_context_save(NON_SECURE);
+	cm_el1_sysregs_context_save_mask(NON_SECURE, OPTEED_EL1_CTX_REGS);
 
 	/* Get a reference to this cpu's OPTEE context */
 	linear_id = plat_my_core_pos();
@@ -73,7 +82,7 @@ static uint64_t opteed_sel1_interrupt_handler(uint32_t id,
 	assert(&optee_ctx->cpu_ctx == cm_get_context(SECURE));
 
 	cm_set_elr_el3(SECURE, (uint64_t)&optee_vector_table->fiq_entry);
-	cm_el1_sysregs_context_restore(SECURE);
+	cm_el1_sysregs_context_restore_mask(SECURE, OPTEED_EL1_CTX_REGS);
 	cm_set_next_eret_context(SECURE);
 
 	/*
@@ -215,7 +224,8 @@ static uintptr_t opteed_smc_handler(uint32_t smc_fid,
 		 */
 		assert(handle == cm_get_context(NON_SECURE));
 
-		cm_el1_sysregs_context_save(NON_SECURE);
+		cm_el1_sysregs_context_save_mask(NON_SECURE,
+						 OPTEED_EL1_CTX_REGS);
 
 		/*
 		 * We are done stashing the non-secure context. Ask the
@@ -243,7 +253,8 @@ static uintptr_t opteed_smc_handler(uint32_t smc_fid,
 					&optee_vector_table->yield_smc_entry);
 		}
 
-		cm_el1_sysregs_context_restore(SECURE);
+		cm_el1_sysregs_context_restore_mask(SECURE,
+						    OPTEED_EL1_CTX_REGS);
 		cm_set_next_eret_context(SECURE);
 
 		write_ctx_reg(get_gpregs_ctx(&optee_ctx->cpu_ctx),
@@ -361,14 +372,15 @@ static uintptr_t opteed_smc_handler(uint32_t smc_fid,
 		 * and return to the non-secure state.
 		 */
 		assert(handle == cm_get_context(SECURE));
-		cm_el1_sysregs_context_save(SECURE);
+		cm_el1_sysregs_context_save_mask(SECURE, OPTEED_EL1_CTX_REGS);
 
 		/* Get a reference to the non-secure context */
 		ns_cpu_context = cm_get_context(NON_SECURE);
 		assert(ns_cpu_context);
 
 		/* Restore non-secure state */
-		cm_el1_sysregs_context_restore(NON_SECURE);
+		cm_el1_sysregs_context_restore_mask(NON_SECURE,
+						    OPTEED_EL1_CTX_REGS);
 		cm_set_next_eret_context(NON_SECURE);
 
 		SMC_RET4(ns_cpu_context, x1, x2, x3, x4);
@@ -387,7 +399,8 @@ static uintptr_t opteed_smc_handler(uint32_t smc_fid,
 		 * secure system register context since OPTEE was supposed
 		 * to preserve it during S-EL1 interrupt handling.
 		 */
-		cm_el1_sysregs_context_restore(NON_SECURE);
+		cm_el1_sysregs_context_restore_mask(NON_SECURE,
+						    OPTEED_EL1_CTX_REGS);
 		cm_set_next_eret_context(NON_SECURE);
 
 		SMC_RET0((uint64_t) ns_cpu_context);
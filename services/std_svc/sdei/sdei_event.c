@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -12,6 +12,166 @@
 
 #define MAP_OFF(_map, _mapping) ((_map) - (_mapping)->map)
 
+/*
+ * The maps are indexed by event number and by bound interrupt in two
+ * open-addressed hash tables built during initialisation, so that they are
+ * found in constant time however many events the platform defines. The slots
+ * hold the number of a map plus one: the private maps are numbered first,
+ * followed by the shared maps. Lookups don't take any lock: they check that
+ * the map they find still matches the key, and the slots of the maps whose
+ * interrupt is released are marked as deleted instead of being emptied.
+ */
+#define INDEX_SLOT_EMPTY	0U
+#define INDEX_SLOT_DELETED	0xFFFFU
+#define INDEX_SIZE		(1U << SDEI_MAP_INDEX_BITS)
+#define INDEX_MASK		(INDEX_SIZE - 1U)
+#define INDEX_MAX_COUNT		SDEI_MAX_MAPS
+
+typedef enum {
+	INDEX_BY_EVENT,
+	INDEX_BY_INTR,
+	INDEX_MAX
+} sdei_index_key_t;
+
+static volatile uint16_t sdei_map_index[INDEX_MAX][INDEX_SIZE];
+static unsigned int sdei_map_index_count[INDEX_MAX];
+
+/* Serialises the updates of the indices */
+static spinlock_t sdei_map_index_lock;
+
+static unsigned int map_to_num(sdei_ev_map_t *map)
+{
+	const sdei_mapping_t *mapping = SDEI_PRIVATE_MAPPING();
+
+	if (is_event_private(map))
+		return (unsigned int) MAP_OFF(map, mapping);
+
+	return (unsigned int) (mapping->num_maps +
+			MAP_OFF(map, SDEI_SHARED_MAPPING()));
+}
+
+static sdei_ev_map_t *num_to_map(unsigned int num)
+{
+	const sdei_mapping_t *mapping = SDEI_PRIVATE_MAPPING();
+
+	if (num < mapping->num_maps)
+		return &mapping->map[num];
+
+	return &SDEI_SHARED_MAPPING()->map[num - mapping->num_maps];
+}
+
+static unsigned int map_key(sdei_ev_map_t *map, sdei_index_key_t type)
+{
+	return (type == INDEX_BY_EVENT) ? (unsigned int) map->ev_num :
+		map->intr;
+}
+
+/* Multiplicative hash, which also spreads sequential keys */
+static unsigned int index_hash(unsigned int key)
+{
+	return (key * 0x9E3779B1U) >> (32U - SDEI_MAP_INDEX_BITS);
+}
+
+static sdei_ev_map_t *index_find(sdei_index_key_t type, unsigned int key)
+{
+	unsigned int i, slot, pos = index_hash(key);
+	sdei_ev_map_t *map;
+
+	for (i = 0U; i < INDEX_SIZE; i++) {
+		slot = sdei_map_index[type][(pos + i) & INDEX_MASK];
+		if (slot == INDEX_SLOT_EMPTY)
+			break;
+		if (slot == INDEX_SLOT_DELETED)
+			continue;
+
+		map = num_to_map(slot - 1U);
+		if (map_key(map, type) == key)
+			return map;
+	}
+
+	return NULL;
+}
+
+static void index_insert(sdei_index_key_t type, sdei_ev_map_t *map)
+{
+	unsigned int i, pos = index_hash(map_key(map, type));
+	volatile uint16_t *slot = NULL;
+
+	/*
+	 * The table is kept sparse enough for the probe sequences to stay
+	 * short. REGISTER_SDEI_MAP() checks that the maps of the platform fit.
+	 */
+	assert(sdei_map_index_count[type] < INDEX_MAX_COUNT);
+
+	for (i = 0U; i < INDEX_SIZE; i++) {
+		slot = &sdei_map_index[type][(pos + i) & INDEX_MASK];
+		if ((*slot == INDEX_SLOT_EMPTY) ||
+				(*slot == INDEX_SLOT_DELETED))
+			break;
+	}
+	assert(i < INDEX_SIZE);
+
+	/* Publish the slot once the key of the map is visible */
+	dmbish();
+	*slot = (uint16_t) (map_to_num(map) + 1U);
+	sdei_map_index_count[type]++;
+}
+
+static void index_remove(sdei_index_key_t type, sdei_ev_map_t *map)
+{
+	unsigned int i, pos = index_hash(map_key(map, type));
+	uint16_t num = (uint16_t) (map_to_num(map) + 1U);
+	volatile uint16_t *slot;
+
+	for (i = 0U; i < INDEX_SIZE; i++) {
+		slot = &sdei_map_index[type][(pos + i) & INDEX_MASK];
+		if (*slot == INDEX_SLOT_EMPTY)
+			break;
+		if (*slot == num) {
+			*slot = INDEX_SLOT_DELETED;
+			sdei_map_index_count[type]--;
+			break;
+		}
+	}
+}
+
+/*
+ * Add a map to the indices. Maps that are not bound to an interrupt are only
+ * indexed by event number.
+ */
+void sdei_map_index_add(sdei_ev_map_t *map)
+{
+	assert(map->ev_num >= 0);
+
+	spin_lock(&sdei_map_index_lock);
+	index_insert(INDEX_BY_EVENT, map);
+	if (map->intr != SDEI_DYN_IRQ)
+		index_insert(INDEX_BY_INTR, map);
+	spin_unlock(&sdei_map_index_lock);
+}
+
+/*
+ * Update the index by interrupt after a dynamic map has been bound to an
+ * interrupt, or before it is released.
+ */
+void sdei_map_index_bind(sdei_ev_map_t *map)
+{
+	assert(is_map_dynamic(map));
+
+	spin_lock(&sdei_map_index_lock);
+	index_insert(INDEX_BY_INTR, map);
+	spin_unlock(&sdei_map_index_lock);
+}
+
+void sdei_map_index_release(sdei_ev_map_t *map)
+{
+	assert(is_map_dynamic(map));
+
+	spin_lock(&sdei_map_index_lock);
+	index_remove(INDEX_BY_INTR, map);
+	spin_unlock(&sdei_map_index_lock);
+}
+
 /*
  * Get SDEI entry with the given mapping: on success, returns pointer to SDEI
  * entry. On error, returns NULL.
@@ -62,17 +222,25 @@ sdei_ev_map_t *find_event_map_by_intr(unsigned int intr_num, bool shared)
 	unsigned int i;
 
 	/*
-	 * Look for a match in private and shared mappings, as requested. This
-	 * is a linear search. However, if the mappings are required to be
-	 * sorted, for large maps, we could consider binary search.
+	 * The free dynamic maps are not indexed. They are only looked for when
+	 * binding an interrupt, so a linear search is good enough.
 	 */
-	mapping = shared ? SDEI_SHARED_MAPPING() : SDEI_PRIVATE_MAPPING();
-	iterate_mapping(mapping, i, map) {
-		if (map->intr == intr_num)
-			return map;
+	if (intr_num == SDEI_DYN_IRQ) {
+		mapping = shared ? SDEI_SHARED_MAPPING() :
+			SDEI_PRIVATE_MAPPING();
+		iterate_mapping(mapping, i, map) {
+			if (map->intr == intr_num)
+				return map;
+		}
+
+		return NULL;
 	}
 
-	return NULL;
+	map = index_find(INDEX_BY_INTR, intr_num);
+	if ((map == NULL) || (is_event_shared(map) != shared))
+		return NULL;
+
+	return map;
 }
 
 /*
@@ -81,21 +249,5 @@ sdei_ev_map_t *find_event_map_by_intr(unsigned int intr_num, bool shared)
  */
 sdei_ev_map_t *find_event_map(int ev_num)
 {
-	const sdei_mapping_t *mapping;
-	sdei_ev_map_t *map;
-	unsigned int i, j;
-
-	/*
-	 * Iterate through mappings to find a match. This is a linear search.
-	 * However, if the mappings are required to be sorted, for large maps,
-	 * we could consider binary search.
-	 */
-	for_each_mapping_type(i, mapping) {
-		iterate_mapping(mapping, j, map) {
-			if (map->ev_num == ev_num)
-				return map;
-		}
-	}
-
-	return NULL;
+	return index_find(INDEX_BY_EVENT, (unsigned int) ev_num);
 }
@@ -49,6 +49,10 @@ typedef struct sdei_cpu_state {
 	unsigned short stack_top; /* Empty ascending */
 	bool pe_masked;
 	bool pending_enables;
+#if SDEI_BATCHED_DISPATCH
+	/* Whether the last event was completed without resuming elsewhere */
+	bool chain_dispatch;
+#endif
 } sdei_cpu_state_t;
 
 /* SDEI states for all cores in the system */
@@ -336,15 +340,19 @@ static void handle_masked_trigger(sdei_ev_map_t *map, sdei_entry_t *se,
 	plat_ic_end_of_interrupt(intr_raw);
 }
 
-/* SDEI main interrupt handler */
-int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
-		void *cookie)
+/*
+ * Handle an SDEI interrupt that preempted 'sec_state', whose context is
+ * 'handle'. Returns whether the event was dispatched to the client. In that
+ * case, the Non-secure context is active when this function returns, and the
+ * caller must resume the Secure context if it had been preempted.
+ */
+static bool sdei_handle_intr(uint32_t intr_raw, unsigned int sec_state,
+		void *handle)
 {
 	sdei_entry_t *se;
 	cpu_context_t *ctx;
 	sdei_ev_map_t *map;
 	const sdei_dispatch_context_t *disp_ctx;
-	unsigned int sec_state;
 	sdei_cpu_state_t *state;
 	uint32_t intr;
 	jmp_buf dispatch_jmp;
@@ -404,7 +412,7 @@ int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
 		if (is_event_shared(map))
 			sdei_map_unlock(map);
 
-		return 0;
+		return false;
 	}
 
 	/* Insert load barrier for signalled SDEI event */
@@ -440,7 +448,7 @@ int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
 		if (is_event_shared(map))
 			sdei_map_unlock(map);
 
-		return 0;
+		return false;
 	}
 
 	disp_ctx = get_outstanding_dispatch();
@@ -461,8 +469,6 @@ int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
 		assert(disp_ctx == NULL);
 	}
 
-	sec_state = get_interrupt_src_ss(flags);
-
 	if (is_event_shared(map))
 		sdei_map_unlock(map);
 
@@ -487,17 +493,6 @@ int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
 	/*
 	 * We reach here when client completes the event.
 	 *
-	 * If the cause of dispatch originally interrupted the Secure world,
-	 * resume Secure.
-	 *
-	 * No need to save the Non-secure context ahead of a world switch: the
-	 * Non-secure context was fully saved before dispatch, and has been
-	 * returned to its pre-dispatch state.
-	 */
-	if (sec_state == SECURE)
-		restore_and_resume_secure_context();
-
-	/*
 	 * The event was dispatched after receiving SDEI interrupt. With
 	 * the event handling completed, EOI the corresponding
 	 * interrupt.
@@ -508,6 +503,131 @@ int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
 	}
 	plat_ic_end_of_interrupt(intr_raw);
 
+#if EHF_LATENCY_STATS
+	ehf_lat_stats_complete();
+#endif
+
+	return true;
+}
+
+#if SDEI_BATCHED_DISPATCH
+/*
+ * Acknowledge the next SDEI interrupt pending for this PE, so that it can be
+ * dispatched as soon as the previous event is completed, without returning to
+ * the preempted context and taking another exception. This is only done if the
+ * previous event was completed without resuming elsewhere, and if the PE is
+ * still unmasked. Returns whether an interrupt was acknowledged.
+ *
+ * With EHF_LATENCY_STATS, the acknowledgement is recorded as the EHF would have,
+ * and 'lat_idx' receives the priority index to record the end of its handling.
+ */
+static bool sdei_ack_next_intr(uint32_t *intr_raw, unsigned int *lat_idx)
+{
+	sdei_cpu_state_t *state = sdei_get_this_pe_state();
+	unsigned int intr, ack_intr;
+#if EHF_LATENCY_STATS
+	uint64_t ack_ts;
+#endif
+
+	if (state->pe_masked || !state->chain_dispatch)
+		return false;
+
+	if (plat_ic_get_pending_interrupt_type() != INTR_TYPE_EL3)
+		return false;
+
+	intr = plat_ic_get_pending_interrupt_id();
+	if (find_event_map_by_intr(intr, (plat_ic_is_spi(intr) != 0)) == NULL)
+		return false;
+
+#if EHF_LATENCY_STATS
+	ack_ts = read_cntpct_el0();
+#endif
+	*intr_raw = plat_ic_acknowledge_interrupt();
+	ack_intr = plat_ic_get_interrupt_id(*intr_raw);
+	if (ack_intr == INTR_ID_UNAVAILABLE)
+		return false;
+
+	/*
+	 * A higher priority interrupt may have become pending in the meantime.
+	 * If it doesn't belong to SDEI, make it pending again and end it, so
+	 * that it's handled by its own handler once this PE leaves EL3. SGIs
+	 * can't be set pending, so they are raised again to this PE instead.
+	 */
+	if ((ack_intr != intr) && (find_event_map_by_intr(ack_intr,
+				(plat_ic_is_spi(ack_intr) != 0)) == NULL)) {
+		if (plat_ic_is_sgi(ack_intr) != 0) {
+			plat_ic_raise_el3_sgi((int) ack_intr,
+					read_mpidr_el1());
+		} else {
+			plat_ic_set_interrupt_pending(ack_intr);
+		}
+		plat_ic_end_of_interrupt(*intr_raw);
+		return false;
+	}
+
+#if EHF_LATENCY_STATS
+	*lat_idx = ehf_lat_stats_ack(ack_ts);
+#endif
+
+	SDEI_LOG("Chaining interrupt %u on %lx\n", ack_intr, read_mpidr_el1());
+
+	return true;
+}
+#endif
+
+/* SDEI main interrupt handler */
+int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
+		void *cookie)
+{
+	unsigned int sec_state = get_interrupt_src_ss(flags);
+	bool resume_secure = false;
+	bool dispatched;
+#if SDEI_BATCHED_DISPATCH
+	unsigned int lat_idx = 0U;
+#if EHF_LATENCY_STATS
+	bool chained = false;
+#endif
+#endif
+
+	while (true) {
+		dispatched = sdei_handle_intr(intr_raw, sec_state, handle);
+
+#if SDEI_BATCHED_DISPATCH && EHF_LATENCY_STATS
+		/* The EHF records the end of the first interrupt itself */
+		if (chained)
+			ehf_lat_stats_handler_done(lat_idx);
+#endif
+		if (!dispatched)
+			break;
+
+		/*
+		 * If the cause of dispatch originally interrupted the Secure
+		 * world, resume Secure once no more events are dispatched.
+		 *
+		 * No need to save the Non-secure context ahead of a world
+		 * switch: the Non-secure context was fully saved before
+		 * dispatch, and has been returned to its pre-dispatch state.
+		 */
+		if (sec_state == SECURE) {
+			resume_secure = true;
+			sec_state = NON_SECURE;
+			handle = cm_get_context(NON_SECURE);
+		}
+
+#if SDEI_BATCHED_DISPATCH
+		if (!sdei_ack_next_intr(&intr_raw, &lat_idx))
+			break;
+#if EHF_LATENCY_STATS
+		chained = true;
+#endif
+#else
+		break;
+#endif
+	}
+
+	if (resume_secure)
+		restore_and_resume_secure_context();
+
 	return 0;
 }
 
@@ -638,6 +758,10 @@ int sdei_event_complete(bool resume, uint64_t pc)
 	/* Having done sanity checks, pop dispatch */
 	(void) pop_dispatch();
 
+#if SDEI_BATCHED_DISPATCH
+	sdei_get_this_pe_state()->chain_dispatch = !resume;
+#endif
+
 	SDEI_LOG("EOI:%lx, %d spsr:%lx elr:%lx\n", read_mpidr_el1(),
 			map->ev_num, read_spsr_el3(), read_elr_el3());
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -40,10 +40,11 @@ CASSERT(PLAT_SDEI_CRITICAL_PRI < PLAT_SDEI_NORMAL_PRI,
 
 static unsigned int num_dyn_priv_slots, num_dyn_shrd_slots;
 
-/* Initialise SDEI map entries */
+/* Initialise SDEI map entries, and index them for the lookups */
 static void init_map(sdei_ev_map_t *map)
 {
 	map->reg_count = 0;
+	sdei_map_index_add(map);
 }
 
 /* Convert mapping to SDEI class */
@@ -234,6 +235,15 @@ void sdei_init(void)
 			sdei_intr_handler);
 	ehf_register_priority_handler(PLAT_SDEI_NORMAL_PRI,
 			sdei_intr_handler);
+
+#if RT_SVC_FID_HANDLERS
+	/* These calls are still handled through the Standard Service if this fails */
+	if ((rt_svc_register_fid_handler(SDEI_EVENT_COMPLETE,
+				sdei_smc_handler) != 0) ||
+	    (rt_svc_register_fid_handler(SDEI_EVENT_COMPLETE_AND_RESUME,
+				sdei_smc_handler) != 0))
+		WARN("Failed to register SDEI completion handlers\n");
+#endif
 }
 
 /* Populate SDEI event entry */
@@ -745,6 +755,7 @@ static int sdei_interrupt_bind(unsigned int intr_num)
 		if (!is_map_bound(map)) {
 			map->intr = intr_num;
 			set_map_bound(map);
+			sdei_map_index_bind(map);
 			retry = false;
 		}
 		sdei_map_unlock(map);
@@ -802,6 +813,7 @@ static int sdei_interrupt_release(int ev_num)
 		 * during unregister.
 		 */
 
+		sdei_map_index_release(map);
 		map->intr = SDEI_DYN_IRQ;
 		clr_map_bound(map);
 	} else {
@@ -886,14 +898,15 @@ static int sdei_shared_reset(void)
 	return final_ret;
 }
 
-/* Send a signal to another SDEI client PE */
-static int sdei_signal(int ev_num, uint64_t target_pe)
+/*
+ * Signal event 0 to a set of PEs with a single call. All the targets are
+ * validated before any of them is signalled, so either all of them or none
+ * receive the event.
+ */
+int sdei_signal_pes(const u_register_t *target_pes, unsigned int num_pes)
 {
 	sdei_ev_map_t *map;
-
-	/* Only event 0 can be signalled */
-	if (ev_num != SDEI_EVENT_0)
-		return SDEI_EINVAL;
+	unsigned int i;
 
 	/* Find mapping for event 0 */
 	map = find_event_map(SDEI_EVENT_0);
@@ -904,16 +917,31 @@ static int sdei_signal(int ev_num, uint64_t target_pe)
 	if (!is_event_signalable(map))
 		return SDEI_EINVAL;
 
-	/* Validate target */
-	if (plat_core_pos_by_mpidr(target_pe) < 0)
-		return SDEI_EINVAL;
+	/* Validate targets */
+	for (i = 0U; i < num_pes; i++) {
+		if (plat_core_pos_by_mpidr(target_pes[i]) < 0)
+			return SDEI_EINVAL;
+	}
 
-	/* Raise SGI. Platform will validate target_pe */
-	plat_ic_raise_el3_sgi((int) map->intr, (u_register_t) target_pe);
+	/* Raise SGIs. Platform will validate target_pes */
+	for (i = 0U; i < num_pes; i++)
+		plat_ic_raise_el3_sgi((int) map->intr, target_pes[i]);
 
 	return 0;
 }
 
+/* Send a signal to another SDEI client PE */
+static int sdei_signal(int ev_num, uint64_t target_pe)
+{
+	u_register_t target = (u_register_t) target_pe;
+
+	/* Only event 0 can be signalled */
+	if (ev_num != SDEI_EVENT_0)
+		return SDEI_EINVAL;
+
+	return sdei_signal_pes(&target, 1U);
+}
+
 /* Query SDEI dispatcher features */
 static uint64_t sdei_features(unsigned int feature)
 {
@@ -926,14 +954,14 @@ static uint64_t sdei_features(unsigned int feature)
 }
 
 /* SDEI top level handler for servicing SMCs */
-uint64_t sdei_smc_handler(uint32_t smc_fid,
-			  uint64_t x1,
-			  uint64_t x2,
-			  uint64_t x3,
-			  uint64_t x4,
-			  void *cookie,
-			  void *handle,
-			  uint64_t flags)
+uintptr_t sdei_smc_handler(uint32_t smc_fid,
+			   u_register_t x1,
+			   u_register_t x2,
+			   u_register_t x3,
+			   u_register_t x4,
+			   void *cookie,
+			   void *handle,
+			   u_register_t flags)
 {
 
 	uint64_t x5;
@@ -959,7 +987,7 @@ uint64_t sdei_smc_handler(uint32_t smc_fid,
 
 	case SDEI_EVENT_REGISTER:
 		x5 = SMC_GET_GP(ctx, CTX_GPREG_X5);
-		SDEI_LOG("> REG(n:%d e:%llx a:%llx f:%x m:%llx)\n", ev_num,
+		SDEI_LOG("> REG(n:%d e:%lx a:%lx f:%x m:%llx)\n", ev_num,
 				x2, x3, (int) x4, x5);
 		ret = sdei_event_register(ev_num, x2, x3, x4, x5);
 		SDEI_LOG("< REG:%lld\n", ret);
@@ -988,7 +1016,7 @@ uint64_t sdei_smc_handler(uint32_t smc_fid,
 		/* Fallthrough */
 
 	case SDEI_EVENT_COMPLETE:
-		SDEI_LOG("> COMPLETE(r:%u sta/ep:%llx):%lx\n",
+		SDEI_LOG("> COMPLETE(r:%u sta/ep:%lx):%lx\n",
 				(unsigned int) resume, x1, read_mpidr_el1());
 		ret = sdei_event_complete(resume, x1);
 		SDEI_LOG("< COMPLETE:%llx\n", ret);
@@ -1060,19 +1088,19 @@ uint64_t sdei_smc_handler(uint32_t smc_fid,
 		SMC_RET1(ctx, ret);
 
 	case SDEI_EVENT_ROUTING_SET:
-		SDEI_LOG("> ROUTE_SET(n:%d f:%llx aff:%llx)\n", ev_num, x2, x3);
+		SDEI_LOG("> ROUTE_SET(n:%d f:%lx aff:%lx)\n", ev_num, x2, x3);
 		ret = sdei_event_routing_set(ev_num, x2, x3);
 		SDEI_LOG("< ROUTE_SET:%lld\n", ret);
 		SMC_RET1(ctx, ret);
 
 	case SDEI_FEATURES:
-		SDEI_LOG("> FTRS(f:%llx)\n", x1);
+		SDEI_LOG("> FTRS(f:%lx)\n", x1);
 		ret = (int64_t) sdei_features((unsigned int) x1);
 		SDEI_LOG("< FTRS:%llx\n", ret);
 		SMC_RET1(ctx, ret);
 
 	case SDEI_EVENT_SIGNAL:
-		SDEI_LOG("> SIGNAL(e:%d t:%llx)\n", ev_num, x2);
+		SDEI_LOG("> SIGNAL(e:%d t:%lx)\n", ev_num, x2);
 		ret = sdei_signal(ev_num, x2);
 		SDEI_LOG("< SIGNAL:%lld\n", ret);
 		SMC_RET1(ctx, ret);
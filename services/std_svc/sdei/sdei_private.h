@@ -230,6 +230,9 @@ extern sdei_entry_t sdei_shared_event_table[];
 
 void init_sdei_state(void);
 
+void sdei_map_index_add(sdei_ev_map_t *map);
+void sdei_map_index_bind(sdei_ev_map_t *map);
+void sdei_map_index_release(sdei_ev_map_t *map);
 sdei_ev_map_t *find_event_map_by_intr(unsigned int intr_num, bool shared);
 sdei_ev_map_t *find_event_map(int ev_num);
 sdei_entry_t *get_event_entry(sdei_ev_map_t *map);
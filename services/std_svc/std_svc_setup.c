@@ -28,6 +28,73 @@ static uuid_t arm_svc_uid = {
 	{0xc0, 0xfb, 0x56, 0x41, 0xf6, 0xe2}
 };
 
+#if RT_SVC_FID_HANDLERS
+/*
+ * PSCI CPU_SUSPEND handler registered for direct dispatch. It is equivalent to
+ * std_svc_smc_handler() for this function ID, without going through the
+ * dispatch of the Standard Service and of PSCI.
+ */
+static uintptr_t std_svc_psci_cpu_suspend_handler(uint32_t smc_fid,
+			     u_register_t x1,
+			     u_register_t x2,
+			     u_register_t x3,
+			     u_register_t x4,
+			     void *cookie,
+			     void *handle,
+			     u_register_t flags)
+{
+	u_register_t ret;
+
+	if (is_caller_secure(flags))
+		SMC_RET1(handle, SMC_UNK);
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_WRITE_TIMESTAMP(rt_instr_svc,
+	    RT_INSTR_ENTER_PSCI,
+	    PMF_CACHE_MAINT,
+	    get_cpu_data(cpu_data_pmf_ts[CPU_DATA_PMF_TS0_IDX]));
+#endif
+
+	if (GET_SMC_CC(smc_fid) == SMC_32) {
+		ret = (u_register_t)psci_cpu_suspend((uint32_t)x1,
+						     (uint32_t)x2,
+						     (uint32_t)x3);
+	} else {
+		ret = (u_register_t)psci_cpu_suspend((unsigned int)x1, x2, x3);
+	}
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+	    RT_INSTR_EXIT_PSCI,
+	    PMF_NO_CACHE_MAINT);
+#endif
+
+	SMC_RET1(handle, ret);
+}
+
+/*
+ * Register the handlers of the frequently used Standard Service Calls for
+ * direct dispatch. The calls are still handled by std_svc_smc_handler() if the
+ * handlers cannot be registered.
+ */
+static void std_svc_register_fid_handlers(void)
+{
+	static const uint32_t cpu_suspend_fids[] = {
+		PSCI_CPU_SUSPEND_AARCH32,
+		PSCI_CPU_SUSPEND_AARCH64
+	};
+	unsigned int i;
+
+	for (i = 0U; i < ARRAY_SIZE(cpu_suspend_fids); i++) {
+		if (psci_features(cpu_suspend_fids[i]) == PSCI_E_NOT_SUPPORTED)
+			continue;
+		if (rt_svc_register_fid_handler(cpu_suspend_fids[i],
+				std_svc_psci_cpu_suspend_handler) != 0)
+			WARN("Failed to register CPU_SUSPEND handler\n");
+	}
+}
+#endif /* RT_SVC_FID_HANDLERS */
+
 /* Setup Standard Services */
 static int32_t std_svc_setup(void)
 {
@@ -56,6 +123,12 @@ static int32_t std_svc_setup(void)
 	sdei_init();
 #endif
 
+#if RT_SVC_FID_HANDLERS
+	if (ret == 0) {
+		std_svc_register_fid_handlers();
+	}
+#endif
+
 	return ret;
 }
 
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Compare the LZ4 and gzip decompressors that BL2 can use for the images it
+ * loads (lib/lz4 and lib/zlib). The same image is given uncompressed, and
+ * compressed the way the build compresses it:
+ *
+ *   gzip -n -9 image --stdout > image.gz
+ *   lz4 -9 --content-size image --stdout > image.lz4
+ *
+ * Both compressed images are decompressed repeatedly, and the output is
+ * checked against the uncompressed image.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+int gunzip(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+	   size_t out_len, uintptr_t work_buf, size_t work_len);
+int lz4_decompress(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+		   size_t out_len, uintptr_t work_buf, size_t work_len);
+
+typedef int (*decompressor_t)(uintptr_t *in_buf, size_t in_len,
+			      uintptr_t *out_buf, size_t out_len,
+			      uintptr_t work_buf, size_t work_len);
+
+/* Workspace given to the decompressors, as BL2 does with its image buffer */
+#define WORK_SIZE		(1024U * 1024U)
+
+/* Each decompressor produces at least this much output */
+#define BENCH_TOTAL_BYTES	(256U * 1024U * 1024U)
+
+/* Called by the firmware code to print its messages */
+void tf_log(const char *fmt, ...)
+{
+	(void)fmt;
+}
+
+static unsigned char *read_file(const char *name, size_t *size)
+{
+	unsigned char *buf;
+	FILE *f;
+	long len;
+
+	f = fopen(name, "rb");
+	if (f == NULL) {
+		printf("Failed to open %s\n", name);
+		return NULL;
+	}
+
+	if ((fseek(f, 0L, SEEK_END) != 0) || ((len = ftell(f)) <= 0) ||
+	    (fseek(f, 0L, SEEK_SET) != 0)) {
+		printf("Failed to get the size of %s\n", name);
+		fclose(f);
+		return NULL;
+	}
+
+	buf = malloc((size_t)len);
+	if ((buf != NULL) && (fread(buf, 1U, (size_t)len, f) != (size_t)len)) {
+		printf("Failed to read %s\n", name);
+		free(buf);
+		buf = NULL;
+	}
+	fclose(f);
+
+	*size = (size_t)len;
+	return buf;
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * Decompress 'in' until at least BENCH_TOTAL_BYTES have been produced, and
+ * print the throughput. Returns 0 if the output matches 'ref'.
+ */
+static int bench(const char *name, decompressor_t fn, const unsigned char *in,
+		 size_t in_len, const unsigned char *ref, size_t ref_len,
+		 unsigned char *out, unsigned char *work)
+{
+	size_t iter, n = (BENCH_TOTAL_BYTES / ref_len) + 1U;
+	uintptr_t in_ptr, out_ptr;
+	uint64_t start, elapsed;
+	int ret;
+
+	start = now_ns();
+	for (iter = 0U; iter < n; iter++) {
+		in_ptr = (uintptr_t)in;
+		out_ptr = (uintptr_t)out;
+		ret = fn(&in_ptr, in_len, &out_ptr, ref_len, (uintptr_t)work,
+			 WORK_SIZE);
+		if (ret != 0) {
+			printf("%s: decompression failed (%d)\n", name, ret);
+			return 1;
+		}
+	}
+	elapsed = now_ns() - start;
+
+	if (((out_ptr - (uintptr_t)out) != ref_len) ||
+	    (memcmp(out, ref, ref_len) != 0)) {
+		printf("%s: output does not match the image\n", name);
+		return 1;
+	}
+
+	if (elapsed == 0U)
+		elapsed = 1U;
+
+	printf("%-8s %12zu %9.1f%% %12.3f %12lu\n", name, in_len,
+	       (100.0 * (double)in_len) / (double)ref_len,
+	       (double)elapsed / ((double)n * 1000000.0),
+	       (unsigned long)(((uint64_t)n * ref_len * 1000U) / elapsed));
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned char *raw, *gz, *lz4, *out, *work;
+	size_t raw_len, gz_len, lz4_len;
+	int ret = 1;
+
+	if (argc != 4) {
+		printf("Usage: %s <image> <image.gz> <image.lz4>\n", argv[0]);
+		return 1;
+	}
+
+	raw = read_file(argv[1], &raw_len);
+	gz = read_file(argv[2], &gz_len);
+	lz4 = read_file(argv[3], &lz4_len);
+	out = malloc(raw_len);
+	work = malloc(WORK_SIZE);
+
+	if ((raw != NULL) && (gz != NULL) && (lz4 != NULL) && (out != NULL) &&
+	    (work != NULL)) {
+		printf("%zu byte image\n", raw_len);
+		printf("%-8s %12s %10s %12s %12s\n", "format", "size",
+		       "ratio", "time (ms)", "MB/s");
+		ret = bench("gzip", gunzip, gz, gz_len, raw, raw_len, out,
+			    work);
+		ret |= bench("lz4", lz4_decompress, lz4, lz4_len, raw,
+			     raw_len, out, work);
+	}
+
+	free(raw);
+	free(gz);
+	free(lz4);
+	free(out);
+	free(work);
+
+	return ret;
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Atomic helpers of the MCS locks for the hosts that can't run
+ * lib/locks/mcs/aarch64/mcs_lock_helpers.S, with the same memory ordering.
+ * The waiters yield the CPU after spinning for a while instead of waiting for
+ * an event, so that the test also makes progress when it runs more threads
+ * than the host has CPUs.
+ */
+
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SPIN_BEFORE_YIELD	100U
+
+uint32_t mcs_lock_swap(volatile uint32_t *addr, uint32_t val)
+{
+	return __atomic_exchange_n(addr, val, __ATOMIC_ACQ_REL);
+}
+
+uint32_t mcs_lock_cas(volatile uint32_t *addr, uint32_t old, uint32_t val)
+{
+	(void)__atomic_compare_exchange_n(addr, &old, val, false,
+					  __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+
+	return old;
+}
+
+void mcs_lock_wait_while(volatile uint32_t *addr, uint32_t val)
+{
+	unsigned int spin = 0U;
+
+	while (__atomic_load_n(addr, __ATOMIC_ACQUIRE) == val) {
+		if (++spin == SPIN_BEFORE_YIELD) {
+			(void)sched_yield();
+			spin = 0U;
+		}
+	}
+}
+
+void mcs_lock_store_release(volatile uint32_t *addr, uint32_t val)
+{
+	__atomic_store_n(addr, val, __ATOMIC_RELEASE);
+}
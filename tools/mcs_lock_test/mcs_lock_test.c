@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Stress test and microbenchmark of the MCS locks in lib/locks/mcs. Each host
+ * thread plays the part of one CPU of the platform, and takes the locks the way
+ * PSCI takes the power domain locks: the lock of its cluster, and sometimes the
+ * system lock nested inside it.
+ *
+ * The stress test checks that no two threads are ever in the same critical
+ * section, and that no update of the data protected by the locks is lost. The
+ * benchmark then measures the time of an acquisition and release of a single
+ * lock, with 1 to all the threads contending for it.
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "mcs_lock_test.h"
+
+#define STRESS_ITERATIONS	200000U
+#define BENCH_ITERATIONS	1000000U
+
+/* Index of the CPU played by the calling thread, see plat_my_core_pos() */
+static __thread unsigned int thread_core_pos;
+
+/* Data protected by each lock, and the thread that holds the lock, plus one */
+static struct {
+	volatile unsigned int owner;
+	unsigned long count;
+} test_data[TEST_NUM_LOCKS];
+
+static volatile bool test_failed;
+
+static pthread_barrier_t test_barrier;
+
+static unsigned int bench_threads;
+
+/* Called by the firmware code */
+unsigned int plat_my_core_pos(void)
+{
+	return thread_core_pos;
+}
+
+void __assert(void)
+{
+	printf("Assertion failed in the MCS lock code\n");
+	exit(1);
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+/* Enter the critical section of a lock, which must be free */
+static void enter(unsigned int idx, unsigned int me)
+{
+	if (test_data[idx].owner != 0U)
+		test_failed = true;
+	test_data[idx].owner = me + 1U;
+}
+
+static void leave(unsigned int idx, unsigned int me)
+{
+	if (test_data[idx].owner != (me + 1U))
+		test_failed = true;
+	test_data[idx].owner = 0U;
+}
+
+/* Non-atomic update of the data protected by a lock */
+static void update(unsigned int idx)
+{
+	unsigned long count = test_data[idx].count;
+
+	__asm__ volatile("" ::: "memory");
+	test_data[idx].count = count + 1U;
+}
+
+static void *stress_thread(void *arg)
+{
+	unsigned int me = (unsigned int)(uintptr_t)arg;
+	unsigned int cluster = me / TEST_CPUS_PER_CLUSTER;
+
+	thread_core_pos = me;
+	(void)pthread_barrier_wait(&test_barrier);
+
+	for (unsigned int i = 0U; i < STRESS_ITERATIONS; i++) {
+		test_lock_get(cluster);
+		enter(cluster, me);
+		update(cluster);
+
+		/* Nest the system lock every other iteration */
+		if (((i + me) % 2U) == 0U) {
+			test_lock_get(TEST_SYSTEM_LOCK);
+			enter(TEST_SYSTEM_LOCK, me);
+			update(TEST_SYSTEM_LOCK);
+			leave(TEST_SYSTEM_LOCK, me);
+			test_lock_release(TEST_SYSTEM_LOCK);
+		}
+
+		leave(cluster, me);
+		test_lock_release(cluster);
+	}
+
+	return NULL;
+}
+
+static void *bench_thread(void *arg)
+{
+	unsigned int me = (unsigned int)(uintptr_t)arg;
+	unsigned int n = BENCH_ITERATIONS / bench_threads;
+
+	thread_core_pos = me;
+	(void)pthread_barrier_wait(&test_barrier);
+
+	for (unsigned int i = 0U; i < n; i++) {
+		test_lock_get(TEST_SYSTEM_LOCK);
+		update(TEST_SYSTEM_LOCK);
+		test_lock_release(TEST_SYSTEM_LOCK);
+	}
+
+	return NULL;
+}
+
+/* Run 'fn' on 'num' threads, and return the time they took in nanoseconds */
+static uint64_t run_threads(void *(*fn)(void *), unsigned int num)
+{
+	pthread_t threads[TEST_NUM_CPUS];
+	uint64_t start;
+
+	if (pthread_barrier_init(&test_barrier, NULL, num + 1U) != 0) {
+		printf("Failed to create a barrier\n");
+		exit(1);
+	}
+
+	for (unsigned int i = 0U; i < num; i++) {
+		if (pthread_create(&threads[i], NULL, fn,
+				   (void *)(uintptr_t)i) != 0) {
+			printf("Failed to create a thread\n");
+			exit(1);
+		}
+	}
+
+	start = now_ns();
+	(void)pthread_barrier_wait(&test_barrier);
+
+	for (unsigned int i = 0U; i < num; i++)
+		(void)pthread_join(threads[i], NULL);
+
+	(void)pthread_barrier_destroy(&test_barrier);
+
+	return now_ns() - start;
+}
+
+static int stress(void)
+{
+	unsigned long expected;
+	int ret = 0;
+
+	(void)memset(test_data, 0, sizeof(test_data));
+	(void)run_threads(stress_thread, TEST_NUM_CPUS);
+
+	if (test_failed) {
+		printf("Two threads held the same lock\n");
+		ret = 1;
+	}
+
+	for (unsigned int c = 0U; c < TEST_NUM_CLUSTERS; c++) {
+		expected = (unsigned long)TEST_CPUS_PER_CLUSTER *
+			   STRESS_ITERATIONS;
+		if (test_data[c].count != expected) {
+			printf("Cluster %u lock: %lu updates instead of %lu\n",
+			       c, test_data[c].count, expected);
+			ret = 1;
+		}
+	}
+
+	expected = ((unsigned long)TEST_NUM_CPUS * STRESS_ITERATIONS) / 2U;
+	if (test_data[TEST_SYSTEM_LOCK].count != expected) {
+		printf("System lock: %lu updates instead of %lu\n",
+		       test_data[TEST_SYSTEM_LOCK].count, expected);
+		ret = 1;
+	}
+
+	printf("Stress test with %u threads: %s\n", TEST_NUM_CPUS,
+	       (ret == 0) ? "passed" : "FAILED");
+
+	return ret;
+}
+
+static void bench(void)
+{
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	uint64_t elapsed;
+
+	printf("%8s %12s\n", "threads", "ns/lock");
+
+	for (bench_threads = 1U; bench_threads <= TEST_NUM_CPUS;
+	     bench_threads *= 2U) {
+		elapsed = run_threads(bench_thread, bench_threads);
+		printf("%8u %12.1f%s\n", bench_threads,
+		       (double)elapsed / (double)BENCH_ITERATIONS,
+		       ((long)bench_threads > cpus) ? " (more threads than CPUs)" :
+		       "");
+	}
+}
+
+int main(void)
+{
+	if (stress() != 0)
+		return 1;
+
+	bench();
+
+	return 0;
+}
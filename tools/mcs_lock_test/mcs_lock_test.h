@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef MCS_LOCK_TEST_H
+#define MCS_LOCK_TEST_H
+
+/*
+ * Locks used by the test: one per cluster, then one for the system, like the
+ * power domain locks that PSCI takes with PSCI_MCS_LOCKS=1.
+ */
+#define TEST_NUM_CLUSTERS	MCS_TEST_CLUSTER_COUNT
+#define TEST_CPUS_PER_CLUSTER	MCS_TEST_CPUS_PER_CLUSTER
+#define TEST_NUM_CPUS		(TEST_NUM_CLUSTERS * TEST_CPUS_PER_CLUSTER)
+#define TEST_SYSTEM_LOCK	TEST_NUM_CLUSTERS
+#define TEST_NUM_LOCKS		(TEST_NUM_CLUSTERS + 1U)
+
+void test_lock_get(unsigned int idx);
+void test_lock_release(unsigned int idx);
+
+#endif /* MCS_LOCK_TEST_H */
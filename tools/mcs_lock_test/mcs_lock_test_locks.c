@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Locks of mcs_lock_test. This file is built like the firmware, against its
+ * headers, and only exposes plain C types to the host part of the tool.
+ */
+
+#include <platform_def.h>
+
+#include <lib/cassert.h>
+#include <lib/mcs_lock.h>
+
+#include "mcs_lock_test.h"
+
+CASSERT(TEST_NUM_CPUS == PLATFORM_CORE_COUNT, assert_test_cpus_mismatch);
+
+static mcs_lock_t test_locks[TEST_NUM_LOCKS];
+
+void test_lock_get(unsigned int idx)
+{
+	mcs_lock_get(&test_locks[idx]);
+}
+
+void test_lock_release(unsigned int idx)
+{
+	mcs_lock_release(&test_locks[idx]);
+}
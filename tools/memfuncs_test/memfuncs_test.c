@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Check the AArch64 assembly versions of memcpy(), memmove() and memset()
+ * against the portable C versions of lib/libc, and compare their throughput.
+ *
+ * Without arguments, every length from 0 to MAX_TEST_LEN is tested with every
+ * source and destination offset within a 16-byte window, and memmove() is also
+ * tested with every overlap distance up to MAX_OVERLAP bytes in both
+ * directions. The bytes around the destination must be left untouched.
+ *
+ * With -b, the routines are timed on a range of sizes instead.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+void *tf_memcpy(void *dst, const void *src, size_t len);
+void *tf_memmove(void *dst, const void *src, size_t len);
+void *tf_memset(void *dst, int val, size_t count);
+
+void *ref_memcpy(void *dst, const void *src, size_t len);
+void *ref_memmove(void *dst, const void *src, size_t len);
+void *ref_memset(void *dst, int val, size_t count);
+
+#define MAX_TEST_LEN		300U
+#define MAX_OFFSET		16U
+#define MAX_OVERLAP		80U
+#define GUARD_SIZE		64U
+#define BUF_SIZE		(GUARD_SIZE + MAX_OVERLAP + MAX_OFFSET + \
+				 MAX_OVERLAP + MAX_TEST_LEN + GUARD_SIZE)
+
+/*
+ * Zeroing requests of at least this size may use DC ZVA, which needs to read
+ * CurrentEL and SCTLR_ELx first and cannot be executed at EL0. Only the STP
+ * path of memset() is tested with zero.
+ */
+#define MEMSET_DCZVA_MIN_SIZE	256U
+
+#define BENCH_TOTAL_BYTES	(256U * 1024U * 1024U)
+#define BENCH_MAX_SIZE		(1024U * 1024U)
+
+static unsigned char src_buf[BUF_SIZE] __attribute__((aligned(64)));
+static unsigned char dst_buf[BUF_SIZE] __attribute__((aligned(64)));
+static unsigned char exp_buf[BUF_SIZE] __attribute__((aligned(64)));
+
+static unsigned int failures;
+
+static void fill_pattern(unsigned char *buf, size_t size, unsigned int seed)
+{
+	size_t i;
+
+	for (i = 0U; i < size; i++)
+		buf[i] = (unsigned char)((i * 7U) + seed + 1U);
+}
+
+/*
+ * Compare the destination buffer with the expected one. "dst_pos" is the index
+ * of the destination in the buffer, "off" and "src_off" identify the test.
+ */
+static void check(const char *name, size_t dst_pos, ssize_t off,
+		  ssize_t src_off, size_t len, void *ret)
+{
+	size_t i;
+
+	if (ret != &dst_buf[dst_pos]) {
+		printf("%s: off %zd src_off %zd len %zu: returned %p, "
+		       "expected %p\n", name, off, src_off, len, ret,
+		       (void *)&dst_buf[dst_pos]);
+		failures++;
+		return;
+	}
+
+	for (i = 0U; i < BUF_SIZE; i++) {
+		if (dst_buf[i] != exp_buf[i]) {
+			printf("%s: off %zd src_off %zd len %zu: byte %zd "
+			       "is 0x%02x, expected 0x%02x\n", name, off,
+			       src_off, len, (ssize_t)i - (ssize_t)dst_pos,
+			       dst_buf[i], exp_buf[i]);
+			failures++;
+			return;
+		}
+	}
+}
+
+static void test_memcpy(void)
+{
+	size_t dst_off, src_off, len, dst_pos;
+	void *ret;
+
+	fill_pattern(src_buf, BUF_SIZE, 0U);
+
+	for (dst_off = 0U; dst_off < MAX_OFFSET; dst_off++) {
+		for (src_off = 0U; src_off < MAX_OFFSET; src_off++) {
+			for (len = 0U; len <= MAX_TEST_LEN; len++) {
+				dst_pos = GUARD_SIZE + dst_off;
+				fill_pattern(dst_buf, BUF_SIZE, 0x80U);
+				fill_pattern(exp_buf, BUF_SIZE, 0x80U);
+
+				ref_memcpy(&exp_buf[dst_pos],
+					   &src_buf[GUARD_SIZE + src_off], len);
+				ret = tf_memcpy(&dst_buf[dst_pos],
+						&src_buf[GUARD_SIZE + src_off],
+						len);
+				check("memcpy", dst_pos, (ssize_t)dst_off,
+				      (ssize_t)src_off, len, ret);
+			}
+		}
+	}
+}
+
+/*
+ * The source and the destination are both in the destination buffer, with the
+ * source at every distance up to MAX_OVERLAP bytes before and after the
+ * destination.
+ */
+static void test_memmove(void)
+{
+	size_t dst_off, len, dst_pos, src_pos;
+	ssize_t delta;
+	void *ret;
+
+	for (dst_off = 0U; dst_off < MAX_OFFSET; dst_off++) {
+		dst_pos = GUARD_SIZE + MAX_OVERLAP + dst_off;
+
+		for (delta = -(ssize_t)MAX_OVERLAP;
+		     delta <= (ssize_t)MAX_OVERLAP; delta++) {
+			src_pos = (size_t)((ssize_t)dst_pos + delta);
+
+			for (len = 0U; len <= MAX_TEST_LEN; len++) {
+				fill_pattern(dst_buf, BUF_SIZE, 0U);
+				fill_pattern(exp_buf, BUF_SIZE, 0U);
+
+				ref_memmove(&exp_buf[dst_pos],
+					    &exp_buf[src_pos], len);
+				ret = tf_memmove(&dst_buf[dst_pos],
+						 &dst_buf[src_pos], len);
+				check("memmove", dst_pos, (ssize_t)dst_off,
+				      delta, len, ret);
+			}
+		}
+	}
+}
+
+static void test_memset(void)
+{
+	static const int values[] = { 0x00, 0xa5, 0x7f, 0x1ff };
+	size_t dst_off, len, i, dst_pos;
+	void *ret;
+
+	for (i = 0U; i < (sizeof(values) / sizeof(values[0])); i++) {
+		for (dst_off = 0U; dst_off < MAX_OFFSET; dst_off++) {
+			for (len = 0U; len <= MAX_TEST_LEN; len++) {
+				if ((values[i] == 0) &&
+				    (len >= MEMSET_DCZVA_MIN_SIZE))
+					break;
+
+				dst_pos = GUARD_SIZE + dst_off;
+				fill_pattern(dst_buf, BUF_SIZE, 0x40U);
+				fill_pattern(exp_buf, BUF_SIZE, 0x40U);
+
+				ref_memset(&exp_buf[dst_pos], values[i], len);
+				ret = tf_memset(&dst_buf[dst_pos], values[i],
+						len);
+				check("memset", dst_pos, (ssize_t)dst_off,
+				      values[i], len, ret);
+			}
+		}
+	}
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+typedef void *(*copy_fn_t)(void *dst, const void *src, size_t len);
+
+/* Return the throughput in MB/s of copying "size" bytes at the offsets given */
+static unsigned long bench_copy(copy_fn_t fn, unsigned char *dst,
+				const unsigned char *src, size_t size)
+{
+	size_t iter, n = BENCH_TOTAL_BYTES / size;
+	uint64_t start, elapsed;
+
+	start = now_ns();
+	for (iter = 0U; iter < n; iter++)
+		fn(dst, src, size);
+	elapsed = now_ns() - start;
+
+	if (elapsed == 0U)
+		elapsed = 1U;
+
+	return (unsigned long)(((uint64_t)n * size * 1000U) / elapsed);
+}
+
+static unsigned long bench_set(unsigned char *dst, int val, size_t size,
+			       int use_ref)
+{
+	size_t iter, n = BENCH_TOTAL_BYTES / size;
+	uint64_t start, elapsed;
+
+	start = now_ns();
+	for (iter = 0U; iter < n; iter++) {
+		if (use_ref != 0)
+			ref_memset(dst, val, size);
+		else
+			tf_memset(dst, val, size);
+	}
+	elapsed = now_ns() - start;
+
+	if (elapsed == 0U)
+		elapsed = 1U;
+
+	return (unsigned long)(((uint64_t)n * size * 1000U) / elapsed);
+}
+
+static int run_bench(void)
+{
+	unsigned char *src, *dst;
+	size_t size;
+
+	src = malloc(BENCH_MAX_SIZE + 64U);
+	dst = malloc(BENCH_MAX_SIZE + 64U);
+	if ((src == NULL) || (dst == NULL)) {
+		printf("Failed to allocate the benchmark buffers\n");
+		return 1;
+	}
+	memset(src, 0x5a, BENCH_MAX_SIZE + 64U);
+	memset(dst, 0, BENCH_MAX_SIZE + 64U);
+
+	printf("%-10s %-22s %12s %12s\n", "size", "routine", "C (MB/s)",
+	       "asm (MB/s)");
+
+	for (size = 16U; size <= BENCH_MAX_SIZE; size *= 4U) {
+		printf("%-10zu %-22s %12lu %12lu\n", size, "memcpy aligned",
+		       bench_copy(ref_memcpy, dst, src, size),
+		       bench_copy(tf_memcpy, dst, src, size));
+		printf("%-10zu %-22s %12lu %12lu\n", size, "memcpy same offset",
+		       bench_copy(ref_memcpy, dst + 3, src + 3, size),
+		       bench_copy(tf_memcpy, dst + 3, src + 3, size));
+		printf("%-10zu %-22s %12lu %12lu\n", size, "memcpy misaligned",
+		       bench_copy(ref_memcpy, dst + 1, src + 4, size),
+		       bench_copy(tf_memcpy, dst + 1, src + 4, size));
+		printf("%-10zu %-22s %12lu %12lu\n", size, "memmove overlap",
+		       bench_copy(ref_memmove, dst + 64, dst, size),
+		       bench_copy(tf_memmove, dst + 64, dst, size));
+		printf("%-10zu %-22s %12lu %12lu\n", size, "memset",
+		       bench_set(dst, 0xa5, size, 1),
+		       bench_set(dst, 0xa5, size, 0));
+		if (size < MEMSET_DCZVA_MIN_SIZE) {
+			printf("%-10zu %-22s %12lu %12lu\n", size,
+			       "memset zero", bench_set(dst, 0, size, 1),
+			       bench_set(dst, 0, size, 0));
+		}
+	}
+
+	free(src);
+	free(dst);
+
+	return 0;
+}
+
+static void usage(const char *prog)
+{
+	printf("Usage: %s [-b]\n", prog);
+	printf("  -b  Compare the throughput of the C and assembly versions\n");
+}
+
+int main(int argc, char *argv[])
+{
+	int opt;
+
+	while ((opt = getopt(argc, argv, "bh")) != -1) {
+		switch (opt) {
+		case 'b':
+			return run_bench();
+		default:
+			usage(argv[0]);
+			return (opt == 'h') ? 0 : 1;
+		}
+	}
+
+	test_memcpy();
+	test_memmove();
+	test_memset();
+
+	if (failures != 0U) {
+		printf("%u failures\n", failures);
+		return 1;
+	}
+
+	printf("All tests passed\n");
+
+	return 0;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Measure the cost of finding the map of an SDEI event in the dispatcher. This
+ * lookup is made for every SDEI interrupt that is taken, before the event is
+ * dispatched, and for every SDEI call that refers to an event by number. The
+ * dispatcher code in services/std_svc/sdei/sdei_event.c is built for the host
+ * and compared with the linear search that it used before the maps were
+ * indexed, with the largest number of maps that a platform can register.
+ *
+ * The rest of the round trip (the world switches and the handler in the
+ * Normal world) does not depend on the number of events and must be measured
+ * on the target.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "sdei_bench.h"
+
+#define BENCH_ITERATIONS	20000U
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+/* Return the average time of one lookup in nanoseconds */
+static double bench(unsigned int (*lookup)(bool by_intr), bool by_intr,
+		    unsigned int *failures)
+{
+	uint64_t start, elapsed;
+	unsigned int iter;
+
+	start = now_ns();
+	for (iter = 0U; iter < BENCH_ITERATIONS; iter++)
+		*failures += lookup(by_intr);
+	elapsed = now_ns() - start;
+
+	return (double)elapsed / ((double)BENCH_ITERATIONS * BENCH_NUM_MAPS);
+}
+
+int main(void)
+{
+	unsigned int failures = 0U;
+
+	bench_setup();
+
+	printf("%u event maps, %u private\n", BENCH_NUM_MAPS,
+	       BENCH_NUM_PRIVATE);
+	printf("%-22s %14s %14s\n", "lookup", "linear (ns)", "index (ns)");
+	printf("%-22s %14.1f %14.1f\n", "by interrupt",
+	       bench(bench_lookup_linear, true, &failures),
+	       bench(bench_lookup_index, true, &failures));
+	printf("%-22s %14.1f %14.1f\n", "by event number",
+	       bench(bench_lookup_linear, false, &failures),
+	       bench(bench_lookup_index, false, &failures));
+
+	if (failures != 0U) {
+		printf("%u lookups failed\n", failures);
+		return 1;
+	}
+
+	return 0;
+}
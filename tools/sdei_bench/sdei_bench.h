@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef SDEI_BENCH_H
+#define SDEI_BENCH_H
+
+#include <stdbool.h>
+
+/* Number of private and of all the event maps, SDEI_MAX_MAPS */
+#define BENCH_NUM_PRIVATE	8U
+#define BENCH_NUM_MAPS		192U
+
+void bench_setup(void);
+unsigned int bench_lookup_index(bool by_intr);
+unsigned int bench_lookup_linear(bool by_intr);
+
+#endif /* SDEI_BENCH_H */
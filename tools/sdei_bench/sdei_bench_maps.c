@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Event maps of the benchmark, and the firmware-side helpers that it needs.
+ * This file is built against the firmware headers, like sdei_event.c.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <lib/cassert.h>
+
+#include "sdei_private.h"
+#include "sdei_bench.h"
+
+/*
+ * The largest mapping that REGISTER_SDEI_MAP() accepts: event 0 and a few
+ * events bound to PPIs in the private map, and SPIs in the shared map. The
+ * event numbers are sparse, as they usually are.
+ */
+static sdei_ev_map_t bench_private[BENCH_NUM_PRIVATE];
+static sdei_ev_map_t bench_shared[BENCH_NUM_MAPS - BENCH_NUM_PRIVATE];
+
+CASSERT(BENCH_NUM_MAPS == SDEI_MAX_MAPS, assert_bench_num_maps);
+
+REGISTER_SDEI_MAP(bench_private, bench_shared);
+
+/* The benchmark runs on a single thread, the locks are not needed */
+void spin_lock(spinlock_t *lock)
+{
+	(void)lock;
+}
+
+void spin_unlock(spinlock_t *lock)
+{
+	(void)lock;
+}
+
+unsigned int plat_my_core_pos(void)
+{
+	return 0U;
+}
+
+static int bench_ev_num(unsigned int num)
+{
+	return (num == 0U) ? SDEI_EVENT_0 : (int)(1000U + (num * 7U));
+}
+
+static unsigned int bench_intr(unsigned int num)
+{
+	return (num < BENCH_NUM_PRIVATE) ? (16U + num) :
+		(32U + num - BENCH_NUM_PRIVATE);
+}
+
+void bench_setup(void)
+{
+	sdei_ev_map_t *map;
+	unsigned int i;
+
+	for (i = 0U; i < BENCH_NUM_MAPS; i++) {
+		map = (i < BENCH_NUM_PRIVATE) ? &bench_private[i] :
+			&bench_shared[i - BENCH_NUM_PRIVATE];
+
+		map->ev_num = bench_ev_num(i);
+		map->intr = bench_intr(i);
+		map->map_flags = SDEI_MAPF_BOUND | SDEI_MAPF_SIGNALABLE;
+		if (i < BENCH_NUM_PRIVATE)
+			map->map_flags |= SDEI_MAPF_PRIVATE;
+
+		sdei_map_index_add(map);
+	}
+}
+
+/*
+ * Look up the map of every event, the way the dispatcher does when the bound
+ * interrupt is taken, or when a call refers to the event by number. Returns
+ * the number of lookups that failed.
+ */
+unsigned int bench_lookup_index(bool by_intr)
+{
+	unsigned int i, failed = 0U;
+	sdei_ev_map_t *map;
+
+	for (i = 0U; i < BENCH_NUM_MAPS; i++) {
+		if (by_intr) {
+			map = find_event_map_by_intr(bench_intr(i),
+						     i >= BENCH_NUM_PRIVATE);
+		} else {
+			map = find_event_map(bench_ev_num(i));
+		}
+
+		if ((map == NULL) || (map->ev_num != bench_ev_num(i)))
+			failed++;
+	}
+
+	return failed;
+}
+
+/* The same lookups with the linear search that the index replaced */
+static sdei_ev_map_t *linear_find_by_intr(unsigned int intr_num, bool shared)
+{
+	const sdei_mapping_t *mapping;
+	sdei_ev_map_t *map;
+	unsigned int i;
+
+	mapping = shared ? SDEI_SHARED_MAPPING() : SDEI_PRIVATE_MAPPING();
+	iterate_mapping(mapping, i, map) {
+		if (map->intr == intr_num)
+			return map;
+	}
+
+	return NULL;
+}
+
+static sdei_ev_map_t *linear_find(int ev_num)
+{
+	const sdei_mapping_t *mapping;
+	sdei_ev_map_t *map;
+	unsigned int i, j;
+
+	for_each_mapping_type(i, mapping) {
+		iterate_mapping(mapping, j, map) {
+			if (map->ev_num == ev_num)
+				return map;
+		}
+	}
+
+	return NULL;
+}
+
+unsigned int bench_lookup_linear(bool by_intr)
+{
+	unsigned int i, failed = 0U;
+	sdei_ev_map_t *map;
+
+	for (i = 0U; i < BENCH_NUM_MAPS; i++) {
+		if (by_intr) {
+			map = linear_find_by_intr(bench_intr(i),
+						  i >= BENCH_NUM_PRIVATE);
+		} else {
+			map = linear_find(bench_ev_num(i));
+		}
+
+		if ((map == NULL) || (map->ev_num != bench_ev_num(i)))
+			failed++;
+	}
+
+	return failed;
+}
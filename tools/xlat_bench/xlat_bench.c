@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Measure the cost of adding the static regions of an image to its translation
+ * context, with mmap_add_ctx() and with mmap_add_bulk_ctx(), for 10 to 1000
+ * regions given in a random order. The translation table library in
+ * lib/xlat_tables_v2 is built for the host. Both ways of adding the regions
+ * must produce the same mmap array, which is checked for every size.
+ *
+ * The translation tables are not written, so this does not include the cost of
+ * init_xlat_tables(), which does not depend on how the regions were added.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "xlat_bench.h"
+
+/* Number of regions added per measurement, for each size */
+#define BENCH_TOTAL_REGIONS	2000000U
+
+static const unsigned int bench_sizes[] = { 10U, 30U, 100U, 300U, 1000U };
+
+/*
+ * Called by the firmware code. Only do_panic() can be reached, if the regions
+ * generated by the tool are rejected.
+ */
+void do_panic(void)
+{
+	printf("Panic in the translation table library\n");
+	exit(1);
+}
+
+static void unexpected_call(const char *name)
+{
+	printf("Unexpected call to %s()\n", name);
+	exit(1);
+}
+
+void console_flush(void)
+{
+	unexpected_call(__func__);
+}
+
+void clean_dcache_range(uintptr_t addr, size_t size)
+{
+	unexpected_call(__func__);
+}
+
+bool is_dcache_enabled(void)
+{
+	unexpected_call(__func__);
+	return false;
+}
+
+uint64_t xlat_arch_regime_get_xn_desc(int xlat_regime)
+{
+	unexpected_call(__func__);
+	return 0U;
+}
+
+void xlat_mmap_print(const void *mmap)
+{
+	unexpected_call(__func__);
+}
+
+void xlat_tables_print(const void *ctx)
+{
+	unexpected_call(__func__);
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+/* Fixed pseudo-random sequence, so that runs can be compared */
+static uint32_t next_random(uint32_t *state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+
+	return *state;
+}
+
+/* Return the average time to add num regions, in microseconds */
+static double bench(unsigned int num, bool bulk)
+{
+	unsigned int iter, n = BENCH_TOTAL_REGIONS / num;
+	uint64_t start, elapsed;
+
+	start = now_ns();
+	for (iter = 0U; iter < n; iter++) {
+		xlat_bench_reset(num);
+		xlat_bench_add(bulk);
+	}
+	elapsed = now_ns() - start;
+
+	return (double)elapsed / ((double)n * 1000.0);
+}
+
+int main(void)
+{
+	static unsigned int order[BENCH_MAX_REGIONS];
+	unsigned int i, j, k, tmp, num;
+	uint32_t state = 0x2545f491U;
+	double t_add, t_bulk;
+
+	printf("%8s %14s %14s %8s\n", "regions", "mmap_add (us)",
+	       "bulk (us)", "speedup");
+
+	for (i = 0U; i < (sizeof(bench_sizes) / sizeof(bench_sizes[0])); i++) {
+		num = bench_sizes[i];
+
+		/* Fisher-Yates shuffle of the regions */
+		for (j = 0U; j < num; j++)
+			order[j] = j;
+		for (j = num - 1U; j > 0U; j--) {
+			k = next_random(&state) % (j + 1U);
+			tmp = order[j];
+			order[j] = order[k];
+			order[k] = tmp;
+		}
+		xlat_bench_set_regions(order, num);
+
+		xlat_bench_reset(num);
+		xlat_bench_add(false);
+		xlat_bench_save();
+		xlat_bench_reset(num);
+		xlat_bench_add(true);
+		if (xlat_bench_compare(num) != 0) {
+			printf("%u regions: mmap_add_bulk_ctx() does not match "
+			       "mmap_add_ctx()\n", num);
+			return 1;
+		}
+
+		t_add = bench(num, false);
+		t_bulk = bench(num, true);
+
+		printf("%8u %14.2f %14.2f %7.1fx\n", num, t_add, t_bulk,
+		       t_add / t_bulk);
+	}
+
+	return 0;
+}
@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef XLAT_BENCH_H
+#define XLAT_BENCH_H
+
+#include <stdbool.h>
+
+/* Largest number of regions that are added to the translation context */
+#define BENCH_MAX_REGIONS	1000U
+
+void xlat_bench_set_regions(const unsigned int *order, unsigned int num);
+void xlat_bench_reset(unsigned int num);
+void xlat_bench_add(bool bulk);
+void xlat_bench_save(void);
+int xlat_bench_compare(unsigned int num);
+
+#endif /* XLAT_BENCH_H */
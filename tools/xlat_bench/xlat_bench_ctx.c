@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Translation context and regions of xlat_bench. This file is built like the
+ * firmware, against its headers, and only exposes plain C types to the host
+ * part of the tool.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <lib/xlat_tables/xlat_tables_v2.h>
+
+#include "xlat_bench.h"
+
+/* Regions are BENCH_REGION_STRIDE apart, starting at BENCH_REGION_BASE */
+#define BENCH_REGION_BASE	ULL(0x80000000)
+#define BENCH_REGION_STRIDE	ULL(0x10000)
+#define BENCH_REGION_SIZE	ULL(0x8000)
+
+REGISTER_XLAT_CONTEXT(bench, BENCH_MAX_REGIONS, 1U, 1ULL << 36, 1ULL << 36);
+
+static mmap_region_t bench_regions[BENCH_MAX_REGIONS + 1U];
+static mmap_region_t bench_ref_mmap[BENCH_MAX_REGIONS + 1U];
+static unsigned long long bench_ref_max_pa;
+static uintptr_t bench_ref_max_va;
+
+/*
+ * Generate num regions in the order given by the permutation, which is how a
+ * platform with a large table of regions would pass them. Every fourth region
+ * is nested in the previous one, with device attributes, like a register block
+ * inside a larger memory-mapped window.
+ */
+void xlat_bench_set_regions(const unsigned int *order, unsigned int num)
+{
+	unsigned long long base;
+	unsigned int i, idx;
+
+	(void)memset(bench_regions, 0, sizeof(bench_regions));
+
+	for (i = 0U; i < num; i++) {
+		idx = order[i];
+		if ((idx % 4U) == 3U) {
+			base = BENCH_REGION_BASE +
+			       ((idx - 1U) * BENCH_REGION_STRIDE) + PAGE_SIZE;
+			bench_regions[i] = (mmap_region_t)MAP_REGION_FLAT(
+				base, PAGE_SIZE, MT_DEVICE | MT_RW | MT_SECURE);
+		} else {
+			base = BENCH_REGION_BASE + (idx * BENCH_REGION_STRIDE);
+			bench_regions[i] = (mmap_region_t)MAP_REGION_FLAT(
+				base, BENCH_REGION_SIZE,
+				MT_MEMORY | MT_RW | MT_SECURE);
+		}
+	}
+}
+
+/*
+ * Empty the translation context, as it is before the image adds its regions.
+ * Only the first num entries of the mmap array can have been used.
+ */
+void xlat_bench_reset(unsigned int num)
+{
+	(void)memset(bench_mmap, 0, (num + 1U) * sizeof(mmap_region_t));
+	bench_xlat_ctx.max_pa = 0U;
+	bench_xlat_ctx.max_va = 0U;
+}
+
+/* Add the regions, with mmap_add_bulk_ctx() if bulk is set */
+void xlat_bench_add(bool bulk)
+{
+	if (bulk)
+		mmap_add_bulk_ctx(&bench_xlat_ctx, bench_regions);
+	else
+		mmap_add_ctx(&bench_xlat_ctx, bench_regions);
+}
+
+/* Keep a copy of the mmap array of the context to compare it later */
+void xlat_bench_save(void)
+{
+	(void)memcpy(bench_ref_mmap, bench_mmap, sizeof(bench_ref_mmap));
+	bench_ref_max_pa = bench_xlat_ctx.max_pa;
+	bench_ref_max_va = bench_xlat_ctx.max_va;
+}
+
+/*
+ * Return 0 if the mmap array and the limits of the context match the ones
+ * saved by xlat_bench_save() after adding the regions the other way.
+ */
+int xlat_bench_compare(unsigned int num)
+{
+	if ((memcmp(bench_ref_mmap, bench_mmap, sizeof(bench_ref_mmap)) != 0) ||
+	    (bench_ref_max_pa != bench_xlat_ctx.max_pa) ||
+	    (bench_ref_max_va != bench_xlat_ctx.max_va))
+		return -1;
+
+	/* All the regions have been added, and the array is terminated */
+	if ((bench_mmap[num - 1U].size == 0U) || (bench_mmap[num].size != 0U))
+		return -1;
+
+	return 0;
+}
@@ -0,0 +1,544 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Generate at build time the translation tables of the static regions of an
+ * image. The regions are read from an array of mmap_region_t in an AArch64
+ * object file, so that they are evaluated by the same compiler and with the
+ * same platform definitions as the image. The output is a C source file, in the
+ * format described in xlat_tables_aot.h, that is linked into the image.
+ */
+
+#include <elf.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <lib/xlat_tables/xlat_tables_aot.h>
+#include <lib/xlat_tables/xlat_tables_arch.h>
+#include <lib/xlat_tables/xlat_tables_defs.h>
+
+/* Layout of mmap_region_t in an AArch64 image */
+#define MMAP_REGION_SIZE		40U
+#define MMAP_REGION_BASE_PA		0U
+#define MMAP_REGION_BASE_VA		8U
+#define MMAP_REGION_SIZE_OFFSET		16U
+#define MMAP_REGION_ATTR		24U
+#define MMAP_REGION_GRANULARITY		32U
+
+#define DEFAULT_SYMBOL			"plat_arm_mmap"
+#define DEFAULT_MAX_TABLES		64U
+#define MAX_REGIONS			(XLAT_AOT_BASE_TABLE - 1U)
+
+struct entry {
+	unsigned int type;	/* 0 (invalid) or XLAT_AOT_ENTRY_* */
+	unsigned int next;
+	uint64_t pa;
+};
+
+struct table {
+	unsigned int level;
+	int mapped_regions;
+	struct entry entries[XLAT_TABLE_ENTRIES];
+};
+
+static xlat_aot_region_t *regions;
+static unsigned int regions_num;
+
+static struct table base_table;
+static unsigned int base_level;
+static unsigned int base_entries;
+
+static struct table *tables;
+static unsigned int tables_num;
+static unsigned int max_tables = DEFAULT_MAX_TABLES;
+
+static uint64_t va_size;
+
+static void die(const char *msg, ...)
+{
+	va_list ap;
+
+	va_start(ap, msg);
+	fprintf(stderr, "xlat_gen: ");
+	vfprintf(stderr, msg, ap);
+	fputc('\n', stderr);
+	va_end(ap);
+	exit(1);
+}
+
+static uint64_t read_le64(const uint8_t *p)
+{
+	uint64_t v = 0U;
+
+	for (int i = 7; i >= 0; i--)
+		v = (v << 8) | p[i];
+
+	return v;
+}
+
+/* Read the whole file at 'path' into memory. */
+static uint8_t *load_file(const char *path, size_t *size)
+{
+	FILE *fp;
+	uint8_t *buf;
+	long len;
+
+	fp = fopen(path, "rb");
+	if (fp == NULL)
+		die("cannot open %s: %s", path, strerror(errno));
+
+	if ((fseek(fp, 0L, SEEK_END) != 0) || ((len = ftell(fp)) < 0) ||
+	    (fseek(fp, 0L, SEEK_SET) != 0))
+		die("cannot read %s", path);
+
+	buf = malloc((size_t)len);
+	if (buf == NULL)
+		die("out of memory");
+
+	if (fread(buf, 1, (size_t)len, fp) != (size_t)len)
+		die("cannot read %s", path);
+
+	fclose(fp);
+	*size = (size_t)len;
+
+	return buf;
+}
+
+static void elf_check_range(size_t file_size, uint64_t offset, uint64_t size)
+{
+	if ((offset > file_size) || (size > (file_size - offset)))
+		die("truncated object file");
+}
+
+/*
+ * Find the array of mmap_region_t called 'symbol' in the object file and copy
+ * the regions it describes. The array must not need any relocation, that is,
+ * it may only be initialised with constants.
+ */
+static void load_regions(const uint8_t *elf, size_t elf_size,
+			 const char *symbol)
+{
+	const Elf64_Ehdr *ehdr = (const Elf64_Ehdr *)elf;
+	const Elf64_Shdr *shdr, *symtab = NULL, *sec;
+	const Elf64_Sym *sym = NULL, *syms;
+	const char *strtab;
+	const uint8_t *data;
+	unsigned int i, num;
+
+	if ((elf_size < sizeof(*ehdr)) ||
+	    (memcmp(ehdr->e_ident, ELFMAG, SELFMAG) != 0) ||
+	    (ehdr->e_ident[EI_CLASS] != ELFCLASS64) ||
+	    (ehdr->e_ident[EI_DATA] != ELFDATA2LSB) ||
+	    (ehdr->e_machine != EM_AARCH64))
+		die("not an AArch64 ELF64 object file");
+
+	elf_check_range(elf_size, ehdr->e_shoff,
+			(uint64_t)ehdr->e_shnum * sizeof(Elf64_Shdr));
+	shdr = (const Elf64_Shdr *)(elf + ehdr->e_shoff);
+
+	for (i = 0U; i < ehdr->e_shnum; i++) {
+		if (shdr[i].sh_type == SHT_SYMTAB) {
+			symtab = &shdr[i];
+			break;
+		}
+	}
+	if ((symtab == NULL) || (symtab->sh_link >= ehdr->e_shnum))
+		die("no symbol table");
+
+	elf_check_range(elf_size, symtab->sh_offset, symtab->sh_size);
+	elf_check_range(elf_size, shdr[symtab->sh_link].sh_offset,
+			shdr[symtab->sh_link].sh_size);
+	syms = (const Elf64_Sym *)(elf + symtab->sh_offset);
+	strtab = (const char *)(elf + shdr[symtab->sh_link].sh_offset);
+
+	num = (unsigned int)(symtab->sh_size / sizeof(Elf64_Sym));
+	for (i = 0U; i < num; i++) {
+		if ((syms[i].st_name < shdr[symtab->sh_link].sh_size) &&
+		    (strcmp(strtab + syms[i].st_name, symbol) == 0) &&
+		    (syms[i].st_shndx != SHN_UNDEF)) {
+			sym = &syms[i];
+			break;
+		}
+	}
+	if ((sym == NULL) || (sym->st_shndx >= ehdr->e_shnum))
+		die("symbol '%s' not found", symbol);
+
+	sec = &shdr[sym->st_shndx];
+	if (sec->sh_type == SHT_NOBITS)
+		die("'%s' is not initialised", symbol);
+	if (ehdr->e_type != ET_REL)
+		die("not a relocatable object file");
+	elf_check_range(sec->sh_size, sym->st_value, sym->st_size);
+	elf_check_range(elf_size, sec->sh_offset + sym->st_value,
+			sym->st_size);
+
+	/* Reject the arrays that depend on addresses resolved at link time */
+	for (i = 0U; i < ehdr->e_shnum; i++) {
+		const Elf64_Rela *rela;
+
+		if ((shdr[i].sh_type != SHT_RELA) ||
+		    (shdr[i].sh_info != sym->st_shndx))
+			continue;
+
+		elf_check_range(elf_size, shdr[i].sh_offset, shdr[i].sh_size);
+		rela = (const Elf64_Rela *)(elf + shdr[i].sh_offset);
+		for (unsigned int r = 0U;
+		     r < (shdr[i].sh_size / sizeof(Elf64_Rela)); r++) {
+			if ((rela[r].r_offset >= sym->st_value) &&
+			    (rela[r].r_offset < (sym->st_value + sym->st_size)))
+				die("'%s' is not a constant array", symbol);
+		}
+	}
+
+	data = elf + sec->sh_offset + sym->st_value;
+	num = (unsigned int)(sym->st_size / MMAP_REGION_SIZE);
+
+	regions = calloc(num, sizeof(*regions));
+	if (regions == NULL)
+		die("out of memory");
+
+	/* The array ends with a region of granularity 0, see mmap_add() */
+	for (i = 0U; i < num; i++, data += MMAP_REGION_SIZE) {
+		xlat_aot_region_t *r = &regions[regions_num];
+
+		r->granularity = read_le64(data + MMAP_REGION_GRANULARITY);
+		if (r->granularity == 0U)
+			break;
+
+		r->base_pa = read_le64(data + MMAP_REGION_BASE_PA);
+		r->base_va = read_le64(data + MMAP_REGION_BASE_VA);
+		r->size = read_le64(data + MMAP_REGION_SIZE_OFFSET);
+		r->attr = (uint32_t)read_le64(data + MMAP_REGION_ATTR);
+
+		/* Empty regions are ignored by mmap_add_region_ctx() */
+		if (r->size != 0U)
+			regions_num++;
+	}
+
+	if (regions_num == 0U)
+		die("'%s' has no regions", symbol);
+	if (regions_num > MAX_REGIONS)
+		die("too many regions");
+}
+
+/*
+ * Sort the regions in the order in which mmap_add_region_ctx() inserts them in
+ * the mmap array, which is the order in which init_xlat_tables_ctx() maps them.
+ */
+static int region_cmp(const void *a, const void *b)
+{
+	const xlat_aot_region_t *ra = a, *rb = b;
+	uint64_t end_a = ra->base_va + ra->size - 1U;
+	uint64_t end_b = rb->base_va + rb->size - 1U;
+
+	if (end_a != end_b)
+		return (end_a < end_b) ? -1 : 1;
+	if (ra->size != rb->size)
+		return (ra->size < rb->size) ? -1 : 1;
+
+	return 0;
+}
+
+static void check_regions(void)
+{
+	for (unsigned int i = 0U; i < regions_num; i++) {
+		const xlat_aot_region_t *r = &regions[i];
+
+		if ((((r->base_pa | r->base_va | r->size) & PAGE_SIZE_MASK)
+		     != 0U) || (r->granularity < PAGE_SIZE) ||
+		    ((r->granularity & (r->granularity - 1U)) != 0U))
+			die("region %u is not aligned", i);
+
+		if ((r->base_va + r->size - 1U) < r->base_va)
+			die("region %u overflows", i);
+
+		if ((r->base_va + r->size - 1U) > (va_size - 1U))
+			die("region %u is outside of the VA space", i);
+	}
+}
+
+static struct table *new_table(unsigned int level, unsigned int *idx)
+{
+	if (tables_num == max_tables)
+		die("more than %u translation tables needed", max_tables);
+
+	tables[tables_num].level = level;
+	*idx = tables_num;
+
+	return &tables[tables_num++];
+}
+
+/* Port of xlat_tables_map_region_action(), see xlat_tables_core.c */
+static unsigned int map_region_action(const xlat_aot_region_t *r,
+				      unsigned int type, uint64_t dest_pa,
+				      uint64_t entry_va, unsigned int level)
+{
+	uint64_t end_va = r->base_va + r->size - 1U;
+	uint64_t entry_end_va = entry_va + XLAT_BLOCK_SIZE(level) - 1U;
+
+	if ((r->base_va <= entry_va) && (end_va >= entry_end_va)) {
+		if (level == 3U)
+			return (type == 0U) ? XLAT_AOT_ENTRY_BLOCK : 0U;
+
+		if (type == XLAT_AOT_ENTRY_TABLE)
+			return XLAT_AOT_ENTRY_TABLE;
+
+		if (type != 0U)
+			return 0U;
+
+		if (((dest_pa & XLAT_BLOCK_MASK(level)) != 0U) ||
+		    (level < MIN_LVL_BLOCK_DESC) ||
+		    (r->granularity < XLAT_BLOCK_SIZE(level)))
+			return XLAT_AOT_ENTRY_TABLE;
+
+		return XLAT_AOT_ENTRY_BLOCK;
+	}
+
+	if ((r->base_va <= entry_end_va) || (end_va >= entry_va)) {
+		if (level == 3U)
+			die("region is not page aligned");
+
+		if ((type != 0U) && (type != XLAT_AOT_ENTRY_TABLE))
+			die("invalid overlap between regions");
+
+		return XLAT_AOT_ENTRY_TABLE;
+	}
+
+	return 0U;
+}
+
+/* Port of xlat_tables_map_region(), see xlat_tables_core.c */
+static void map_region(const xlat_aot_region_t *r, unsigned int region,
+		       uint64_t table_base_va, struct table *table,
+		       unsigned int table_entries, unsigned int level)
+{
+	uint64_t end_va = r->base_va + r->size - 1U;
+	uint64_t entry_va;
+	unsigned int idx;
+
+	if (r->base_va > table_base_va)
+		entry_va = r->base_va & ~XLAT_BLOCK_MASK(level);
+	else
+		entry_va = table_base_va;
+	idx = (unsigned int)((entry_va - table_base_va) >>
+			     XLAT_ADDR_SHIFT(level));
+
+	if (level > base_level)
+		table->mapped_regions++;
+
+	while (idx < table_entries) {
+		struct entry *e = &table->entries[idx];
+		uint64_t pa = r->base_pa + entry_va - r->base_va;
+		unsigned int action;
+
+		action = map_region_action(r, e->type, pa, entry_va, level);
+
+		if (action == XLAT_AOT_ENTRY_BLOCK) {
+			e->type = XLAT_AOT_ENTRY_BLOCK;
+			e->next = region;
+			e->pa = pa;
+		} else if (action == XLAT_AOT_ENTRY_TABLE) {
+			if (e->type == 0U) {
+				(void)new_table(level + 1U, &e->next);
+				e->type = XLAT_AOT_ENTRY_TABLE;
+			}
+			map_region(r, region, entry_va, &tables[e->next],
+				   XLAT_TABLE_ENTRIES, level + 1U);
+		}
+
+		idx++;
+		entry_va += XLAT_BLOCK_SIZE(level);
+
+		if (end_va <= entry_va)
+			break;
+	}
+}
+
+static void print_entries(FILE *fp, const struct table *table,
+			  unsigned int table_idx, unsigned int num,
+			  unsigned int *count)
+{
+	for (unsigned int i = 0U; i < num; i++) {
+		const struct entry *e = &table->entries[i];
+
+		if (e->type == 0U)
+			continue;
+
+		fprintf(fp, "\t{ 0x%x, %u, %u, %u, %s, 0x%llxULL },\n",
+			table_idx, i, e->next, table->level,
+			(e->type == XLAT_AOT_ENTRY_TABLE) ?
+			"XLAT_AOT_ENTRY_TABLE" : "XLAT_AOT_ENTRY_BLOCK",
+			(unsigned long long)e->pa);
+		(*count)++;
+	}
+}
+
+static void write_output(const char *path, const char *object,
+			 const char *symbol)
+{
+	unsigned int entries_num = 0U;
+	FILE *fp;
+
+	fp = fopen(path, "w");
+	if (fp == NULL)
+		die("cannot open %s: %s", path, strerror(errno));
+
+	fprintf(fp, "/*\n"
+		" * Translation tables of '%s' in %s.\n"
+		" * Generated by xlat_gen, do not edit.\n"
+		" */\n\n", symbol, object);
+	fprintf(fp, "#include <platform_def.h>\n\n"
+		"#include <lib/cassert.h>\n"
+		"#include <lib/xlat_tables/xlat_tables_aot.h>\n\n");
+
+	fprintf(fp, "CASSERT(PLAT_VIRT_ADDR_SPACE_SIZE == 0x%llxULL,\n"
+		"\tassert_xlat_aot_va_size_mismatch);\n",
+		(unsigned long long)va_size);
+	fprintf(fp, "CASSERT(MAX_XLAT_TABLES >= %uU,\n"
+		"\tassert_xlat_aot_max_xlat_tables_too_small);\n\n",
+		tables_num);
+
+	fprintf(fp, "static const xlat_aot_region_t xlat_aot_regions[] = {\n");
+	for (unsigned int i = 0U; i < regions_num; i++) {
+		fprintf(fp, "\t{ 0x%llxULL, 0x%llxULL, 0x%llxULL, 0x%llxULL, "
+			"0x%xU },\n",
+			(unsigned long long)regions[i].base_pa,
+			(unsigned long long)regions[i].base_va,
+			(unsigned long long)regions[i].size,
+			(unsigned long long)regions[i].granularity,
+			regions[i].attr);
+	}
+	fprintf(fp, "};\n\n");
+
+	fprintf(fp, "static const xlat_aot_entry_t xlat_aot_entries[] = {\n");
+	print_entries(fp, &base_table, XLAT_AOT_BASE_TABLE, base_entries,
+		      &entries_num);
+	for (unsigned int i = 0U; i < tables_num; i++)
+		print_entries(fp, &tables[i], i, XLAT_TABLE_ENTRIES,
+			      &entries_num);
+	fprintf(fp, "};\n\n");
+
+	if (tables_num != 0U) {
+		fprintf(fp, "static const int xlat_aot_mapped_regions[] = {\n");
+		for (unsigned int i = 0U; i < tables_num; i++)
+			fprintf(fp, "\t%d,\n", tables[i].mapped_regions);
+		fprintf(fp, "};\n\n");
+	}
+
+	fprintf(fp, "const xlat_aot_tables_t xlat_aot_tables = {\n"
+		"\t.magic = XLAT_AOT_MAGIC,\n"
+		"\t.tables_num = %uU,\n"
+		"\t.va_size = 0x%llxULL,\n"
+		"\t.regions_num = %uU,\n"
+		"\t.entries_num = %uU,\n"
+		"\t.regions = xlat_aot_regions,\n"
+		"\t.entries = xlat_aot_entries,\n"
+		"\t.mapped_regions = %s,\n"
+		"};\n",
+		tables_num, (unsigned long long)va_size, regions_num,
+		entries_num,
+		(tables_num != 0U) ? "xlat_aot_mapped_regions" : "NULL");
+
+	if (fclose(fp) != 0)
+		die("cannot write %s", path);
+
+	printf("xlat_gen: %u regions mapped with %u translation tables\n",
+	       regions_num, tables_num);
+}
+
+static void usage(void)
+{
+	printf("usage: xlat_gen ");
+#ifdef VERSION
+	printf(VERSION);
+#else
+	/* If built from xlat_gen directory, VERSION is not set. */
+	printf("version unknown");
+#endif
+	printf(" [<args>] <object> <output>\n\n");
+
+	printf("This tool generates the translation tables of the static\n"
+	       "regions defined in an object file as a C source file.\n\n");
+	printf("Commands supported:\n");
+	printf("  -s <symbol>          Array of regions (default %s).\n",
+	       DEFAULT_SYMBOL);
+	printf("  -v <bits>            Size of the virtual address space.\n");
+	printf("  -t <num>             Maximum number of tables (default %u).\n",
+	       DEFAULT_MAX_TABLES);
+	printf("  -h                   Show this message.\n");
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *symbol = DEFAULT_SYMBOL;
+	unsigned long va_bits = 0U;
+	uint8_t *elf;
+	size_t elf_size;
+	int ch;
+
+	while ((ch = getopt(argc, argv, "hs:t:v:")) != -1) {
+		switch (ch) {
+		case 's':
+			symbol = optarg;
+			break;
+		case 't':
+			max_tables = (unsigned int)strtoul(optarg, NULL, 0);
+			break;
+		case 'v':
+			va_bits = strtoul(optarg, NULL, 0);
+			break;
+		case 'h':
+		default:
+			usage();
+		}
+	}
+
+	argc -= optind;
+	argv += optind;
+
+	if (argc != 2)
+		usage();
+
+	if (va_bits >= 64U)
+		die("invalid size of the virtual address space");
+
+	va_size = 1ULL << va_bits;
+	if ((va_size < MIN_VIRT_ADDR_SPACE_SIZE) ||
+	    (va_size > MAX_VIRT_ADDR_SPACE_SIZE))
+		die("invalid size of the virtual address space");
+
+	if ((max_tables == 0U) || (max_tables > XLAT_AOT_BASE_TABLE))
+		die("invalid maximum number of tables");
+
+	tables = calloc(max_tables, sizeof(*tables));
+	if (tables == NULL)
+		die("out of memory");
+
+	elf = load_file(argv[0], &elf_size);
+	load_regions(elf, elf_size, symbol);
+	free(elf);
+
+	check_regions();
+	qsort(regions, regions_num, sizeof(*regions), region_cmp);
+
+	base_level = GET_XLAT_TABLE_LEVEL_BASE(va_size);
+	base_entries = GET_NUM_BASE_LEVEL_ENTRIES(va_size);
+	base_table.level = base_level;
+
+	for (unsigned int i = 0U; i < regions_num; i++)
+		map_region(&regions[i], i, 0U, &base_table, base_entries,
+			   base_level);
+
+	write_output(argv[1], argv[0], symbol);
+
+	return 0;
+}